@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 
-SUBDIRS += src
+SUBDIRS += src \
+    tools
 
 CONFIG(debug, debug|release) {
     SUBDIRS += tests
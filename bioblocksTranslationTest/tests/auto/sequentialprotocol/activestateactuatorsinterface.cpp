@@ -0,0 +1,472 @@
+#include "activestateactuatorsinterface.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+ActiveStateActuatorsInterface::ActiveStateActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface) :
+    ForwardingActuatorsInterface(actuatorInterface)
+{
+    elapsedSlices = 0;
+    valuesRead = 0;
+    timeSlice = 0;
+    elapsedTicks = 0;
+    lastStep = -1;
+    liveInterface = nullptr;
+}
+
+ActiveStateActuatorsInterface::~ActiveStateActuatorsInterface()
+{
+
+}
+
+void ActiveStateActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {
+    setActive(ActiveCommand::light, sourceId, "", {wavelength.to(units::nm), intensity.to(units::cd)});
+    actuatorInterface->applyLigth(sourceId, wavelength, intensity);
+}
+
+void ActiveStateActuatorsInterface::stopApplyLigth(const std::string & sourceId) {
+    clearActive(ActiveCommand::light, sourceId);
+    actuatorInterface->stopApplyLigth(sourceId);
+}
+
+void ActiveStateActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {
+    setActive(ActiveCommand::temperature, sourceId, "", {temperature.to(units::C)});
+    actuatorInterface->applyTemperature(sourceId, temperature);
+}
+
+void ActiveStateActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {
+    clearActive(ActiveCommand::temperature, sourceId);
+    actuatorInterface->stopApplyTemperature(sourceId);
+}
+
+void ActiveStateActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {
+    setActive(ActiveCommand::stir, idSource, "", {intensity.to(units::Hz)});
+    actuatorInterface->stir(idSource, intensity);
+}
+
+void ActiveStateActuatorsInterface::stopStir(const std::string & idSource) {
+    clearActive(ActiveCommand::stir, idSource);
+    actuatorInterface->stopStir(idSource);
+}
+
+void ActiveStateActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {
+    setActive(ActiveCommand::centrifugate, idSource, "", {intensity.to(units::Hz)});
+    actuatorInterface->centrifugate(idSource, intensity);
+}
+
+void ActiveStateActuatorsInterface::stopCentrifugate(const std::string & idSource) {
+    clearActive(ActiveCommand::centrifugate, idSource);
+    actuatorInterface->stopCentrifugate(idSource);
+}
+
+void ActiveStateActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {
+    setActive(ActiveCommand::shake, idSource, "", {intensity.to(units::Hz)});
+    actuatorInterface->shake(idSource, intensity);
+}
+
+void ActiveStateActuatorsInterface::stopShake(const std::string & idSource) {
+    clearActive(ActiveCommand::shake, idSource);
+    actuatorInterface->stopShake(idSource);
+}
+
+void ActiveStateActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {
+    setActive(ActiveCommand::electrophoresis, idSource, "", {fieldStrenght.to(units::V / units::cm)});
+    actuatorInterface->startElectrophoresis(idSource, fieldStrenght);
+}
+
+std::shared_ptr<ElectrophoresisResult> ActiveStateActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    clearActive(ActiveCommand::electrophoresis, idSource);
+    valuesRead++;
+    return actuatorInterface->stopElectrophoresis(idSource);
+}
+
+units::Volume ActiveStateActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    valuesRead++;
+    units::Volume volume = actuatorInterface->getVirtualVolume(sourceId);
+    logRead(volume.to(units::ml));
+    return volume;
+}
+
+void ActiveStateActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    setActive(ActiveCommand::load_container, sourceId, "", {initialVolume.to(units::ml)});
+    volumes[sourceId] = initialVolume.to(units::ml);
+    actuatorInterface->loadContainer(sourceId, initialVolume);
+}
+
+void ActiveStateActuatorsInterface::startMeasureOD(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length wavelength)
+{
+    setActive(ActiveCommand::measure_od, sourceId, "", {measurementFrequency.to(units::Hz), wavelength.to(units::nm)});
+    actuatorInterface->startMeasureOD(sourceId, measurementFrequency, wavelength);
+}
+
+double ActiveStateActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    clearActive(ActiveCommand::measure_od, sourceId);
+    valuesRead++;
+    double value = actuatorInterface->getMeasureOD(sourceId);
+    logRead(value);
+    return value;
+}
+
+void ActiveStateActuatorsInterface::startMeasureTemperature(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    setActive(ActiveCommand::measure_temperature, sourceId, "", {measurementFrequency.to(units::Hz)});
+    actuatorInterface->startMeasureTemperature(sourceId, measurementFrequency);
+}
+
+units::Temperature ActiveStateActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    clearActive(ActiveCommand::measure_temperature, sourceId);
+    valuesRead++;
+    units::Temperature value = actuatorInterface->getMeasureTemperature(sourceId);
+    logRead(value.to(units::C));
+    return value;
+}
+
+void ActiveStateActuatorsInterface::startMeasureLuminiscense(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    setActive(ActiveCommand::measure_luminiscense, sourceId, "", {measurementFrequency.to(units::Hz)});
+    actuatorInterface->startMeasureLuminiscense(sourceId, measurementFrequency);
+}
+
+units::LuminousIntensity ActiveStateActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    clearActive(ActiveCommand::measure_luminiscense, sourceId);
+    valuesRead++;
+    units::LuminousIntensity value = actuatorInterface->getMeasureLuminiscense(sourceId);
+    logRead(value.to(units::cd));
+    return value;
+}
+
+void ActiveStateActuatorsInterface::startMeasureVolume(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    setActive(ActiveCommand::measure_volume, sourceId, "", {measurementFrequency.to(units::Hz)});
+    actuatorInterface->startMeasureVolume(sourceId, measurementFrequency);
+}
+
+units::Volume ActiveStateActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    clearActive(ActiveCommand::measure_volume, sourceId);
+    valuesRead++;
+    units::Volume value = actuatorInterface->getMeasureVolume(sourceId);
+    logRead(value.to(units::ml));
+    return value;
+}
+
+void ActiveStateActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+    setActive(ActiveCommand::measure_fluorescence,
+              sourceId,
+              "",
+              {measurementFrequency.to(units::Hz), excitation.to(units::nm), emission.to(units::nm)});
+    actuatorInterface->startMeasureFluorescence(sourceId, measurementFrequency, excitation, emission);
+}
+
+units::LuminousIntensity ActiveStateActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    clearActive(ActiveCommand::measure_fluorescence, sourceId);
+    valuesRead++;
+    units::LuminousIntensity value = actuatorInterface->getMeasureFluorescence(sourceId);
+    logRead(value.to(units::cd));
+    return value;
+}
+
+void ActiveStateActuatorsInterface::setContinuosFlow(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volumetric_Flow rate)
+{
+    setActive(ActiveCommand::continuous_flow, idSource, idTarget, {rate.to(units::ml/units::hr)});
+    actuatorInterface->setContinuosFlow(idSource, idTarget, rate);
+}
+
+void ActiveStateActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {
+    clearActive(ActiveCommand::continuous_flow, idSource, idTarget);
+    actuatorInterface->stopContinuosFlow(idSource, idTarget);
+}
+
+units::Time ActiveStateActuatorsInterface::transfer(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volume volume)
+{
+    valuesRead++;
+    units::Time duration = actuatorInterface->transfer(idSource, idTarget, volume);
+    logRead(duration.to(units::ms));
+    setActive(ActiveCommand::transfer, idSource, idTarget, {volume.to(units::ml), duration.to(units::ms), 0.0});
+    return duration;
+}
+
+void ActiveStateActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {
+    ActiveCommand* command = findActive(ActiveCommand::transfer, idSource, idTarget);
+    if (command != nullptr) {
+        // whatever the slices did not move yet is moved by the end of the transfer
+        advanceVolumes(std::numeric_limits<double>::infinity(), command);
+        clearActive(ActiveCommand::transfer, idSource, idTarget);
+    }
+    actuatorInterface->stopTransfer(idSource, idTarget);
+}
+
+units::Time ActiveStateActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    valuesRead++;
+    units::Time duration = actuatorInterface->mix(idSource1, idSource2, idTarget, volume1, volume2);
+    logRead(duration.to(units::ms));
+    setActive(ActiveCommand::mix, idSource1, idTarget, {volume1.to(units::ml), volume2.to(units::ml), duration.to(units::ms), 0.0});
+    findActive(ActiveCommand::mix, idSource1, idTarget)->secondSource = idSource2;
+    return duration;
+}
+
+void ActiveStateActuatorsInterface::stopMix(const std::string & idSource1, const std::string & idSource2, const std::string & idTarget) {
+    ActiveCommand* command = findActive(ActiveCommand::mix, idSource1, idTarget);
+    if (command != nullptr) {
+        advanceVolumes(std::numeric_limits<double>::infinity(), command);
+        clearActive(ActiveCommand::mix, idSource1, idTarget);
+    }
+    actuatorInterface->stopMix(idSource1, idSource2, idTarget);
+}
+
+void ActiveStateActuatorsInterface::setTimeStep(units::Time time) {
+    timeSlice = TickTimebase::fromTime(time);
+    actuatorInterface->setTimeStep(time);
+}
+
+units::Time ActiveStateActuatorsInterface::timeStep() {
+    elapsedSlices++;
+    units::Time time = actuatorInterface->timeStep();
+    TickTimebase::Ticks step = TickTimebase::fromTime(time);
+    elapsedTicks = TickTimebase::add(elapsedTicks, step);
+    if (elapsedTicks == TickTimebase::UNBOUNDED) {
+        throw(std::overflow_error("imposible to count the elapsed time after slice " + std::to_string(elapsedSlices) +
+                                  ", it is out of the range of ticks"));
+    }
+
+    if (step != lastStep) {
+        lastStep = step;
+        valuesRead++;
+    }
+    logRead(time.to(units::ms));
+    for(ActiveCommand & command: activeCommands) {
+        advanceVolumes(time.to(units::ms), &command);
+    }
+    return time;
+}
+
+void ActiveStateActuatorsInterface::fillCheckpoint(ExecutionCheckpoint & checkpoint, size_t readLogFrom) const {
+    checkpoint.elapsedSlices = elapsedSlices;
+    checkpoint.timeSlice = timeSlice;
+    checkpoint.elapsedTicks = elapsedTicks;
+    checkpoint.activeCommands = activeCommands;
+    checkpoint.volumes = volumes;
+    checkpoint.readLogFrom = std::min(readLogFrom, readLog.size());
+    checkpoint.readLog.assign(readLog.begin() + checkpoint.readLogFrom, readLog.end());
+}
+
+void ActiveStateActuatorsInterface::restore(const ExecutionCheckpoint & checkpoint) {
+    elapsedSlices = checkpoint.elapsedSlices;
+    timeSlice = checkpoint.timeSlice;
+    elapsedTicks = checkpoint.elapsedTicks;
+    activeCommands = checkpoint.activeCommands;
+    volumes = checkpoint.volumes;
+    readLog.resize(std::min((size_t) checkpoint.readLogFrom, readLog.size()));
+    readLog.insert(readLog.end(), checkpoint.readLog.begin(), checkpoint.readLog.end());
+    lastStep = -1;
+
+    actuatorInterface->setTimeStep(TickTimebase::toTime(timeSlice));
+    for(ActiveCommand & command: activeCommands) {
+        reissue(command);
+    }
+}
+
+void ActiveStateActuatorsInterface::startRebuild(ActuatorsExecutionInterface* rebuildInterface) {
+    elapsedSlices = 0;
+    timeSlice = 0;
+    elapsedTicks = 0;
+    activeCommands.clear();
+    volumes.clear();
+    readLog.clear();
+    lastStep = -1;
+
+    liveInterface = actuatorInterface;
+    actuatorInterface = rebuildInterface;
+}
+
+void ActiveStateActuatorsInterface::finishRebuild() {
+    if (liveInterface != nullptr) {
+        actuatorInterface = liveInterface;
+        liveInterface = nullptr;
+    }
+}
+
+void ActiveStateActuatorsInterface::setActive(
+        int type,
+        const std::string & source,
+        const std::string & target,
+        const std::vector<double> & values)
+{
+    // the active set is a few tens of commands at most, a linear scan keeps the issue order for free
+    for(ActiveCommand & command: activeCommands) {
+        if (command.type == type && command.source == source && command.target == target) {
+            command.values = values;
+            return;
+        }
+    }
+
+    ActiveCommand command;
+    command.type = type;
+    command.source = source;
+    command.target = target;
+    command.values = values;
+    activeCommands.push_back(command);
+}
+
+ActiveCommand* ActiveStateActuatorsInterface::findActive(int type, const std::string & source, const std::string & target) {
+    for(ActiveCommand & command: activeCommands) {
+        if (command.type == type && command.source == source && command.target == target) {
+            return &command;
+        }
+    }
+    return nullptr;
+}
+
+void ActiveStateActuatorsInterface::clearActive(int type, const std::string & source, const std::string & target) {
+    for(auto it = activeCommands.begin(); it != activeCommands.end(); ++it) {
+        if (it->type == type && it->source == source && it->target == target) {
+            activeCommands.erase(it);
+            return;
+        }
+    }
+}
+
+void ActiveStateActuatorsInterface::logRead(double value) {
+    if (!readLog.empty() && readLog.back().value == value) {
+        readLog.back().times++;
+    } else {
+        readLog.push_back(ReadLogEntry{value, 1});
+    }
+}
+
+void ActiveStateActuatorsInterface::advanceVolumes(double ms, ActiveCommand* command) {
+    std::vector<double> & values = command->values;
+    if (command->type == ActiveCommand::continuous_flow) {
+        moveVolume(command->source, command->target, values[0] * ms / 3600000.0);
+    } else if (command->type == ActiveCommand::transfer || command->type == ActiveCommand::mix) {
+        // {volumes..., duration, elapsed}: the liquid moves evenly along the duration
+        size_t durationIndex = values.size() - 2;
+        double duration = values[durationIndex];
+        double fraction = 1.0;
+        if (duration > 0) {
+            double step = std::min(ms, std::max(0.0, duration - values[durationIndex + 1]));
+            if (step == 0) {
+                return;
+            }
+            fraction = step / duration;
+            values[durationIndex + 1] += step;
+        }
+
+        moveVolume(command->source, command->target, values[0] * fraction);
+        if (command->type == ActiveCommand::mix) {
+            moveVolume(command->secondSource, command->target, values[1] * fraction);
+        }
+        if (duration <= 0) {
+            // an instant operation moves everything at once
+            std::fill(values.begin(), values.begin() + durationIndex, 0.0);
+        }
+    }
+}
+
+void ActiveStateActuatorsInterface::moveVolume(const std::string & source, const std::string & target, double ml) {
+    auto sourceIt = volumes.find(source);
+    if (sourceIt != volumes.end()) {
+        ml = std::min(ml, sourceIt->second);
+        sourceIt->second -= ml;
+    }
+
+    auto targetIt = volumes.find(target);
+    if (targetIt != volumes.end()) {
+        targetIt->second += ml;
+    }
+}
+
+void ActiveStateActuatorsInterface::reissue(ActiveCommand & command) {
+    std::vector<double> & values = command.values;
+    switch (command.type) {
+    case ActiveCommand::load_container: {
+        auto it = volumes.find(command.source);
+        actuatorInterface->loadContainer(command.source, ((it != volumes.end()) ? it->second : values[0]) * units::ml);
+        break;
+    }
+    case ActiveCommand::light:
+        actuatorInterface->applyLigth(command.source, values[0] * units::nm, values[1] * units::cd);
+        break;
+    case ActiveCommand::temperature:
+        actuatorInterface->applyTemperature(command.source, values[0] * units::C);
+        break;
+    case ActiveCommand::stir:
+        actuatorInterface->stir(command.source, values[0] * units::Hz);
+        break;
+    case ActiveCommand::centrifugate:
+        actuatorInterface->centrifugate(command.source, values[0] * units::Hz);
+        break;
+    case ActiveCommand::shake:
+        actuatorInterface->shake(command.source, values[0] * units::Hz);
+        break;
+    case ActiveCommand::electrophoresis:
+        actuatorInterface->startElectrophoresis(command.source, values[0] * (units::V / units::cm));
+        break;
+    case ActiveCommand::continuous_flow:
+        actuatorInterface->setContinuosFlow(command.source, command.target, values[0] * (units::ml/units::hr));
+        break;
+    case ActiveCommand::measure_od:
+        actuatorInterface->startMeasureOD(command.source, values[0] * units::Hz, values[1] * units::nm);
+        break;
+    case ActiveCommand::measure_temperature:
+        actuatorInterface->startMeasureTemperature(command.source, values[0] * units::Hz);
+        break;
+    case ActiveCommand::measure_luminiscense:
+        actuatorInterface->startMeasureLuminiscense(command.source, values[0] * units::Hz);
+        break;
+    case ActiveCommand::measure_volume:
+        actuatorInterface->startMeasureVolume(command.source, values[0] * units::Hz);
+        break;
+    case ActiveCommand::measure_fluorescence:
+        actuatorInterface->startMeasureFluorescence(command.source, values[0] * units::Hz, values[1] * units::nm, values[2] * units::nm);
+        break;
+    case ActiveCommand::transfer: {
+        // only what is left to move, over the duration the backend gives for it
+        double left = (values[1] > 0) ? std::max(0.0, values[1] - values[2]) / values[1] : 1.0;
+        values[0] *= left;
+        values[1] = actuatorInterface->transfer(command.source, command.target, values[0] * units::ml).to(units::ms);
+        values[2] = 0.0;
+        break;
+    }
+    case ActiveCommand::mix: {
+        double left = (values[2] > 0) ? std::max(0.0, values[2] - values[3]) / values[2] : 1.0;
+        values[0] *= left;
+        values[1] *= left;
+        values[2] = actuatorInterface->mix(command.source,
+                                           command.secondSource,
+                                           command.target,
+                                           values[0] * units::ml,
+                                           values[1] * units::ml).to(units::ms);
+        values[3] = 0.0;
+        break;
+    }
+    default:
+        break;
+    }
+}
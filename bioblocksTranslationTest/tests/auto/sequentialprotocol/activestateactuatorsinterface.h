@@ -0,0 +1,146 @@
+#ifndef ACTIVESTATEACTUATORSINTERFACE_H
+#define ACTIVESTATEACTUATORSINTERFACE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "executioncheckpoint.h"
+#include "forwardingactuatorsinterface.h"
+
+/**
+ * Forwards every command and keeps track of the ones still in effect (loaded containers, set-points,
+ * running measurements) together with the number of elapsed time slices and the elapsed time, in ticks.
+ *
+ * The tracked state is what has to be re-issued to a fresh backend to continue an execution. The volume of
+ * every loaded container is followed through flows, transfers and mixes (a source never gives more than it
+ * holds), so a container is re-loaded with what it has now; transfers and mixes still running are kept
+ * with the volume they have left to move, and only that is moved again.
+ *
+ * Every call that hands a value back to the graph (time steps, measurements, transfer and mix durations)
+ * is logged, and counted when it can change the variables read by the graph conditions: a time step
+ * returns the slice, the same value every slice, so it only counts when the slice changes.
+ *
+ * The elapsed time is the sum of the time steps the backend returned, added up in ticks with
+ * TickTimebase::add(); an execution that runs past the range of Ticks fails its time step with an
+ * overflow_error instead of wrapping its clock.
+ */
+class ActiveStateActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    ActiveStateActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface);
+    virtual ~ActiveStateActuatorsInterface();
+
+    virtual void applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity);
+    virtual void stopApplyLigth(const std::string & sourceId);
+
+    virtual void applyTemperature(const std::string & sourceId, units::Temperature temperature);
+    virtual void stopApplyTemperature(const std::string & sourceId);
+
+    virtual void stir(const std::string & idSource, units::Frequency intensity);
+    virtual void stopStir(const std::string & idSource);
+
+    virtual void centrifugate(const std::string & idSource, units::Frequency intensity);
+    virtual void stopCentrifugate(const std::string & idSource);
+
+    virtual void shake(const std::string & idSource, units::Frequency intensity);
+    virtual void stopShake(const std::string & idSource);
+
+    virtual void startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght);
+    virtual std::shared_ptr<ElectrophoresisResult> stopElectrophoresis(const std::string & idSource);
+
+    virtual units::Volume getVirtualVolume(const std::string & sourceId);
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual void startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength);
+    virtual double getMeasureOD(const std::string & sourceId);
+
+    virtual void startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+
+    virtual void startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+
+    virtual void startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+
+    virtual void startMeasureFluorescence(const std::string & sourceId,
+                                          units::Frequency measurementFrequency,
+                                          units::Length excitation,
+                                          units::Length emission);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual void setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate);
+    virtual void stopContinuosFlow(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume);
+    virtual void stopTransfer(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time mix(const std::string & idSource1,
+                            const std::string & idSource2,
+                            const std::string & idTarget,
+                            units::Volume volume1,
+                            units::Volume volume2);
+
+    virtual void stopMix(const std::string & idSource1,
+                         const std::string & idSource2,
+                         const std::string & idTarget);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    /** the read log is copied from entry readLogFrom on */
+    void fillCheckpoint(ExecutionCheckpoint & checkpoint, size_t readLogFrom = 0) const;
+    void restore(const ExecutionCheckpoint & checkpoint);
+
+    /** calls go to the given backend (not owned) until finishRebuild, nothing reaches the real one */
+    void startRebuild(ActuatorsExecutionInterface* rebuildInterface);
+    void finishRebuild();
+
+    inline unsigned long long getElapsedSlices() const {
+        return elapsedSlices;
+    }
+
+    inline TickTimebase::Ticks getElapsedTicks() const {
+        return elapsedTicks;
+    }
+
+    inline size_t getReadLogEntries() const {
+        return readLog.size();
+    }
+
+    inline unsigned long long getValuesRead() const {
+        return valuesRead;
+    }
+
+    inline const std::vector<ActiveCommand> & getActiveCommands() const {
+        return activeCommands;
+    }
+
+    inline const std::map<std::string, double> & getVolumes() const {
+        return volumes;
+    }
+
+protected:
+    unsigned long long elapsedSlices;
+    unsigned long long valuesRead;
+    TickTimebase::Ticks timeSlice;
+    TickTimebase::Ticks elapsedTicks;
+    TickTimebase::Ticks lastStep;
+    std::vector<ActiveCommand> activeCommands;
+    std::map<std::string, double> volumes;
+    std::vector<ReadLogEntry> readLog;
+    ActuatorsExecutionInterface* liveInterface;
+
+    void setActive(int type, const std::string & source, const std::string & target, const std::vector<double> & values);
+    void clearActive(int type, const std::string & source, const std::string & target = "");
+
+    ActiveCommand* findActive(int type, const std::string & source, const std::string & target);
+
+    void logRead(double value);
+    void advanceVolumes(double ms, ActiveCommand* command);
+    void moveVolume(const std::string & source, const std::string & target, double ml);
+    void reissue(ActiveCommand & command);
+};
+
+#endif // ACTIVESTATEACTUATORSINTERFACE_H
@@ -0,0 +1,795 @@
+#include "asyncactuatorsinterface.h"
+
+#include <algorithm>
+#include <chrono>
+
+AsyncActuatorsInterface::AsyncActuatorsInterface(
+        ActuatorsExecutionInterface* actuatorInterface,
+        std::size_t queueCapacity,
+        std::size_t maxContainers) :
+    ForwardingActuatorsInterface(actuatorInterface),
+    lanes{{queueCapacity}, {queueCapacity}, {queueCapacity}, {queueCapacity}, {queueCapacity}},
+    containerNames(maxContainers),
+    results(maxContainers + 1),
+    laneStatistics(COMMAND_CLASSES, LaneStatistics{0, 0.0, 0.0}),
+    containerLanes(maxContainers, -1)
+{
+    released = 0;
+    stopping = false;
+    queuedCalls = 0;
+    fullQueueWaits = 0;
+    blockingCalls = 0;
+    timeSlice = 0*units::s;
+
+    internedContainers = 0;
+    containerIds.reserve(maxContainers);
+    for(int i = (int) results.size() - 1; i >= 0; i--) {
+        results[i].ready = false;
+        freeResults.push_back(i);
+    }
+
+    speculationEnabled = false;
+    initialTimePerMl = 1*units::s;
+    elapsed = 0;
+    speculatedCalls = 0;
+    mispredictions = 0;
+    stallSlices = 0;
+    stalled = 0;
+
+    prioritiesEnabled = false;
+    sliceContainers.reserve(maxContainers);
+    postedSlice = 0;
+    nextSequence = 0;
+    demotedCalls = 0;
+
+    ioThread = std::thread(&AsyncActuatorsInterface::run, this);
+}
+
+AsyncActuatorsInterface::~AsyncActuatorsInterface()
+{
+    release();
+    stopping = true;
+    ioThread.join();
+}
+
+void AsyncActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {
+    QueuedCall call = newCall(APPLY_LIGTH, intern(sourceId));
+    call.lengths[0] = wavelength;
+    call.intensity = intensity;
+    post(SET_POINT, call);
+}
+
+void AsyncActuatorsInterface::stopApplyLigth(const std::string & sourceId) {
+    post(SAFETY, newCall(STOP_APPLY_LIGTH, intern(sourceId)));
+}
+
+void AsyncActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {
+    QueuedCall call = newCall(APPLY_TEMPERATURE, intern(sourceId));
+    call.temperature = temperature;
+    post(SET_POINT, call);
+}
+
+void AsyncActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {
+    post(SAFETY, newCall(STOP_APPLY_TEMPERATURE, intern(sourceId)));
+}
+
+void AsyncActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {
+    QueuedCall call = newCall(STIR, intern(idSource));
+    call.frequency = intensity;
+    post(SET_POINT, call);
+}
+
+void AsyncActuatorsInterface::stopStir(const std::string & idSource) {
+    post(SAFETY, newCall(STOP_STIR, intern(idSource)));
+}
+
+void AsyncActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {
+    QueuedCall call = newCall(CENTRIFUGATE, intern(idSource));
+    call.frequency = intensity;
+    post(SET_POINT, call);
+}
+
+void AsyncActuatorsInterface::stopCentrifugate(const std::string & idSource) {
+    post(SAFETY, newCall(STOP_CENTRIFUGATE, intern(idSource)));
+}
+
+void AsyncActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {
+    QueuedCall call = newCall(SHAKE, intern(idSource));
+    call.frequency = intensity;
+    post(SET_POINT, call);
+}
+
+void AsyncActuatorsInterface::stopShake(const std::string & idSource) {
+    post(SAFETY, newCall(STOP_SHAKE, intern(idSource)));
+}
+
+void AsyncActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {
+    QueuedCall call = newCall(START_ELECTROPHORESIS, intern(idSource));
+    call.field = fieldStrenght;
+    post(SET_POINT, call);
+}
+
+std::shared_ptr<ElectrophoresisResult> AsyncActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    QueuedCall call = newCall(STOP_ELECTROPHORESIS, intern(idSource));
+    // moved out here, so the I/O thread never frees it
+    std::shared_ptr<ElectrophoresisResult> value = std::move(waitResult(SAFETY, call).electrophoresis);
+    releaseResult(call.result);
+    return value;
+}
+
+units::Volume AsyncActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    QueuedCall call = newCall(GET_VIRTUAL_VOLUME, intern(sourceId));
+    units::Volume value = waitResult(MEASUREMENT, call).volume;
+    releaseResult(call.result);
+    return value;
+}
+
+void AsyncActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    QueuedCall call = newCall(LOAD_CONTAINER, intern(sourceId));
+    call.volumes[0] = initialVolume;
+    post(BULK, call);
+}
+
+void AsyncActuatorsInterface::startMeasureOD(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length wavelength)
+{
+    QueuedCall call = newCall(START_MEASURE_OD, intern(sourceId));
+    call.frequency = measurementFrequency;
+    call.lengths[0] = wavelength;
+    post(MEASUREMENT, call);
+}
+
+double AsyncActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    QueuedCall call = newCall(GET_MEASURE_OD, intern(sourceId));
+    double value = waitResult(MEASUREMENT, call).od;
+    releaseResult(call.result);
+    return value;
+}
+
+void AsyncActuatorsInterface::startMeasureTemperature(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    QueuedCall call = newCall(START_MEASURE_TEMPERATURE, intern(sourceId));
+    call.frequency = measurementFrequency;
+    post(MEASUREMENT, call);
+}
+
+units::Temperature AsyncActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    QueuedCall call = newCall(GET_MEASURE_TEMPERATURE, intern(sourceId));
+    units::Temperature value = waitResult(MEASUREMENT, call).temperature;
+    releaseResult(call.result);
+    return value;
+}
+
+void AsyncActuatorsInterface::startMeasureLuminiscense(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    QueuedCall call = newCall(START_MEASURE_LUMINISCENSE, intern(sourceId));
+    call.frequency = measurementFrequency;
+    post(MEASUREMENT, call);
+}
+
+units::LuminousIntensity AsyncActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    QueuedCall call = newCall(GET_MEASURE_LUMINISCENSE, intern(sourceId));
+    units::LuminousIntensity value = waitResult(MEASUREMENT, call).intensity;
+    releaseResult(call.result);
+    return value;
+}
+
+void AsyncActuatorsInterface::startMeasureVolume(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    QueuedCall call = newCall(START_MEASURE_VOLUME, intern(sourceId));
+    call.frequency = measurementFrequency;
+    post(MEASUREMENT, call);
+}
+
+units::Volume AsyncActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    QueuedCall call = newCall(GET_MEASURE_VOLUME, intern(sourceId));
+    units::Volume value = waitResult(MEASUREMENT, call).volume;
+    releaseResult(call.result);
+    return value;
+}
+
+void AsyncActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+    QueuedCall call = newCall(START_MEASURE_FLUORESCENCE, intern(sourceId));
+    call.frequency = measurementFrequency;
+    call.lengths[0] = excitation;
+    call.lengths[1] = emission;
+    post(MEASUREMENT, call);
+}
+
+units::LuminousIntensity AsyncActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    QueuedCall call = newCall(GET_MEASURE_FLUORESCENCE, intern(sourceId));
+    units::LuminousIntensity value = waitResult(MEASUREMENT, call).intensity;
+    releaseResult(call.result);
+    return value;
+}
+
+units::Time AsyncActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    QueuedCall call = newCall(MIX, intern(idSource1), intern(idSource2), intern(idTarget));
+    call.volumes[0] = volume1;
+    call.volumes[1] = volume2;
+    if (speculationEnabled) {
+        return speculate("mix", "mix:" + idSource1 + "," + idSource2 + ">" + idTarget, call,
+                         newCall(STOP_MIX, call.containers[0], call.containers[1], call.containers[2]), volume1 + volume2);
+    }
+    units::Time value = waitResult(SET_POINT, call).time;
+    releaseResult(call.result);
+    return value;
+}
+
+void AsyncActuatorsInterface::stopMix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget)
+{
+    if (!settle("mix:" + idSource1 + "," + idSource2 + ">" + idTarget)) {
+        post(SAFETY, newCall(STOP_MIX, intern(idSource1), intern(idSource2), intern(idTarget)));
+    }
+}
+
+void AsyncActuatorsInterface::setContinuosFlow(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volumetric_Flow rate)
+{
+    QueuedCall call = newCall(SET_CONTINUOS_FLOW, intern(idSource), intern(idTarget));
+    call.rate = rate;
+    post(SET_POINT, call);
+}
+
+void AsyncActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {
+    post(SAFETY, newCall(STOP_CONTINUOS_FLOW, intern(idSource), intern(idTarget)));
+}
+
+units::Time AsyncActuatorsInterface::transfer(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volume volume)
+{
+    QueuedCall call = newCall(TRANSFER, intern(idSource), intern(idTarget));
+    call.volumes[0] = volume;
+    if (speculationEnabled) {
+        return speculate("transfer", "transfer:" + idSource + ">" + idTarget, call,
+                         newCall(STOP_TRANSFER, call.containers[0], call.containers[1]), volume);
+    }
+    units::Time value = waitResult(SET_POINT, call).time;
+    releaseResult(call.result);
+    return value;
+}
+
+void AsyncActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {
+    if (!settle("transfer:" + idSource + ">" + idTarget)) {
+        post(SAFETY, newCall(STOP_TRANSFER, intern(idSource), intern(idTarget)));
+    }
+}
+
+void AsyncActuatorsInterface::setTimeStep(units::Time time) {
+    timeSlice = time;
+    QueuedCall call = newCall(SET_TIME_STEP);
+    call.time = time;
+    postBarrier(call);
+}
+
+units::Time AsyncActuatorsInterface::timeStep() {
+    step();
+    while(isHeld()) {
+        step();
+        stalled = TickTimebase::add(stalled, TickTimebase::fromTime(timeSlice));
+        stallSlices++;
+    }
+
+    if (stalled == 0) {
+        return timeSlice;
+    }
+    // the slices the executor was held for elapse in this one
+    units::Time time = TickTimebase::toTime(TickTimebase::add(TickTimebase::fromTime(timeSlice), stalled));
+    stalled = 0;
+    return time;
+}
+
+void AsyncActuatorsInterface::flush() throw(std::runtime_error) {
+    QueuedCall call = newCall(FLUSH);
+    waitResult(CLOCK, call);
+    releaseResult(call.result);
+    checkError();
+}
+
+void AsyncActuatorsInterface::enableSpeculation(DurationModel durationModel, units::Time initialTimePerMl) {
+    this->speculationEnabled = true;
+    this->durationModel = durationModel;
+    this->initialTimePerMl = initialTimePerMl;
+}
+
+void AsyncActuatorsInterface::enablePriorityLanes() {
+    prioritiesEnabled = true;
+}
+
+AsyncActuatorsInterface::LaneStatistics AsyncActuatorsInterface::getLaneStatistics(CommandClass commandClass) const {
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    return laneStatistics[commandClass];
+}
+
+int AsyncActuatorsInterface::intern(const std::string & container) throw(std::runtime_error) {
+    auto it = containerIds.find(container);
+    if (it != containerIds.end()) {
+        return it->second;
+    }
+    if (internedContainers == containerNames.size()) {
+        throw(std::runtime_error("imposible to queue a call on " + container + ", more than " +
+                                 std::to_string(containerNames.size()) + " containers"));
+    }
+
+    // written before the call that uses it is pushed, the ring publishes it to the I/O thread
+    int id = (int) internedContainers;
+    containerNames[id] = container;
+    containerIds.insert(std::make_pair(container, id));
+    internedContainers++;
+    return id;
+}
+
+AsyncActuatorsInterface::QueuedCall AsyncActuatorsInterface::newCall(int opcode, int container0, int container1, int container2) const {
+    QueuedCall call;
+    call.opcode = opcode;
+    call.containers[0] = container0;
+    call.containers[1] = container1;
+    call.containers[2] = container2;
+    call.result = -1;
+    return call;
+}
+
+AsyncActuatorsInterface::PendingResult & AsyncActuatorsInterface::waitResult(CommandClass commandClass, QueuedCall & call) throw(std::runtime_error) {
+    call.result = acquireResult();
+    try {
+        post(commandClass, call);
+    } catch (...) {
+        releaseResult(call.result);
+        throw;
+    }
+    blockingCalls++;
+    release();
+    waitFor(call.result);
+
+    PendingResult & pending = results[call.result];
+    if (!pending.error.empty()) {
+        std::string failure = pending.error;
+        releaseResult(call.result);
+        throw(std::runtime_error("backend call failed: " + failure));
+    }
+    return pending;
+}
+
+int AsyncActuatorsInterface::acquireResult() throw(std::runtime_error) {
+    if (freeResults.empty()) {
+        throw(std::runtime_error("imposible to queue the call, every result slot is waiting for an answer"));
+    }
+    int result = freeResults.back();
+    freeResults.pop_back();
+    return result;
+}
+
+void AsyncActuatorsInterface::waitFor(int result) {
+    std::unique_lock<std::mutex> lock(resultMutex);
+    resultReady.wait(lock, [this, result]() {
+        return results[result].ready;
+    });
+}
+
+void AsyncActuatorsInterface::releaseResult(int result) {
+    PendingResult & pending = results[result];
+    pending.ready = false;
+    pending.electrophoresis.reset();
+    pending.error.clear();
+    freeResults.push_back(result);
+}
+
+units::Time AsyncActuatorsInterface::speculate(
+        const std::string & operation,
+        const std::string & key,
+        QueuedCall call,
+        const QueuedCall & stop,
+        units::Volume volume) throw(std::runtime_error)
+{
+    settle(key);
+
+    call.result = acquireResult();
+    try {
+        post(SET_POINT, call);
+    } catch (...) {
+        releaseResult(call.result);
+        throw;
+    }
+
+    Speculation speculation;
+    speculation.result = call.result;
+    speculation.operation = operation;
+    speculation.volume = volume;
+    speculation.stop = stop;
+    speculation.issuedAt = elapsed;
+    speculation.duration = 0;
+    speculation.learnt = false;
+    speculation.stopped = false;
+
+    units::Time estimated = estimate(operation, volume);
+    speculation.estimate = TickTimebase::fromTime(estimated);
+    speculations.insert(std::make_pair(key, speculation));
+    speculatedCalls++;
+    return estimated;
+}
+
+units::Time AsyncActuatorsInterface::estimate(const std::string & operation, units::Volume volume) const {
+    if (durationModel) {
+        return durationModel(operation, volume);
+    }
+
+    auto it = history.find(operation);
+    if (it != history.end() && it->second.totalMl > 0) {
+        return (volume.to(units::ml) * it->second.totalMs / it->second.totalMl) * units::ms;
+    }
+    return volume.to(units::ml) * initialTimePerMl;
+}
+
+void AsyncActuatorsInterface::learn(Speculation & speculation) {
+    // only called once the answer is ready, a failure is reported by settle()
+    PendingResult & pending = results[speculation.result];
+    if (pending.error.empty()) {
+        DurationHistory & operationHistory = history[speculation.operation];
+        operationHistory.totalMs += pending.time.to(units::ms);
+        operationHistory.totalMl += speculation.volume.to(units::ml);
+
+        speculation.duration = TickTimebase::fromTime(pending.time);
+        if (speculation.duration != speculation.estimate) {
+            mispredictions++;
+        }
+    } else {
+        // nothing is running on the backend
+        speculation.stopped = true;
+    }
+    speculation.learnt = true;
+}
+
+bool AsyncActuatorsInterface::settle(const std::string & key) throw(std::runtime_error) {
+    auto it = speculations.find(key);
+    if (it == speculations.end()) {
+        return false;
+    }
+
+    Speculation speculation = it->second;
+    speculations.erase(it);
+
+    if (!speculation.learnt) {
+        waitFor(speculation.result);
+        learn(speculation);
+    }
+    PendingResult & pending = results[speculation.result];
+    if (!pending.error.empty()) {
+        std::string failure = pending.error;
+        releaseResult(speculation.result);
+        throw(std::runtime_error("backend call failed: " + failure));
+    }
+    releaseResult(speculation.result);
+
+    if (speculation.stopped) {
+        return true;
+    }
+
+    // stopped before a time step, the slices missing are reported to the executor by the next one
+    TickTimebase::Ticks running = elapsed - speculation.issuedAt;
+    TickTimebase::Ticks slice = TickTimebase::fromTime(timeSlice);
+    if (speculation.duration > running && slice > 0) {
+        std::uint64_t missing = TickTimebase::slicesFor(speculation.duration - running, slice);
+        for(std::uint64_t i = 0; i < missing; i++) {
+            step();
+        }
+        stalled = TickTimebase::add(stalled, TickTimebase::multiply(slice, missing));
+        stallSlices += missing;
+    }
+    return false;
+}
+
+void AsyncActuatorsInterface::step() throw(std::runtime_error) {
+    postBarrier(newCall(TIME_STEP));
+    elapsed = TickTimebase::add(elapsed, TickTimebase::fromTime(timeSlice));
+
+    for(auto & entry: speculations) {
+        Speculation & speculation = entry.second;
+        if (!speculation.learnt) {
+            // the clock does not go past the slice of a speculated call without its real duration
+            waitFor(speculation.result);
+            learn(speculation);
+        }
+        if (!speculation.stopped && elapsed - speculation.issuedAt >= speculation.duration) {
+            post(SAFETY, speculation.stop);
+            speculation.stopped = true;
+        }
+    }
+}
+
+bool AsyncActuatorsInterface::isHeld() const {
+    if (TickTimebase::fromTime(timeSlice) <= 0) {
+        return false;
+    }
+    for(const auto & entry: speculations) {
+        const Speculation & speculation = entry.second;
+        if (!speculation.stopped && elapsed - speculation.issuedAt >= speculation.estimate) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AsyncActuatorsInterface::post(CommandClass commandClass, const QueuedCall & call) throw(std::runtime_error) {
+    if (!prioritiesEnabled) {
+        push(0, commandClass, false, call);
+        return;
+    }
+
+    int lane = commandClass;
+    for(int container: call.containers) {
+        if (container >= 0 && containerLanes[container] > lane) {
+            lane = containerLanes[container];
+        }
+    }
+    if (lane != commandClass) {
+        demotedCalls++;
+    }
+    for(int container: call.containers) {
+        if (container >= 0) {
+            if (containerLanes[container] < 0) {
+                sliceContainers.push_back(container);
+            }
+            containerLanes[container] = lane;
+        }
+    }
+    push(lane, commandClass, false, call);
+}
+
+void AsyncActuatorsInterface::postBarrier(const QueuedCall & call) throw(std::runtime_error) {
+    push(prioritiesEnabled ? CLOCK : 0, CLOCK, true, call);
+    postedSlice++;
+    for(int container: sliceContainers) {
+        containerLanes[container] = -1;
+    }
+    sliceContainers.clear();
+    release();
+}
+
+void AsyncActuatorsInterface::push(int lane, CommandClass commandClass, bool closesSlice, const QueuedCall & call) throw(std::runtime_error) {
+    checkError();
+
+    LaneEntry entry;
+    entry.call = call;
+    entry.commandClass = commandClass;
+    entry.closesSlice = closesSlice;
+    entry.slice = postedSlice;
+    entry.sequence = nextSequence++;
+    entry.queuedAt = std::chrono::steady_clock::now();
+
+    while(!lanes[lane].tryPush(std::move(entry))) {
+        // a full lane cannot wait for the end of the slice
+        release();
+        fullQueueWaits++;
+        std::this_thread::yield();
+    }
+    queuedCalls++;
+
+    if (!prioritiesEnabled) {
+        release();
+    }
+}
+
+void AsyncActuatorsInterface::release() {
+    released.store(nextSequence, std::memory_order_release);
+}
+
+void AsyncActuatorsInterface::checkError() throw(std::runtime_error) {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (!error.empty()) {
+        std::string actualError = error;
+        error.clear();
+        throw(std::runtime_error("queued backend call failed: " + actualError));
+    }
+}
+
+void AsyncActuatorsInterface::run() {
+    unsigned int idleSpins = 0;
+    unsigned long long slice = 0;
+    LaneEntry entry;
+    while(true) {
+        int lane = nextLane(slice, released.load(std::memory_order_acquire));
+        if (lane >= 0) {
+            idleSpins = 0;
+            lanes[lane].tryPop(entry);
+
+            double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - entry.queuedAt).count();
+            {
+                std::lock_guard<std::mutex> lock(statisticsMutex);
+                LaneStatistics & statistics = laneStatistics[entry.commandClass];
+                statistics.commands++;
+                statistics.totalLatencyMs += latencyMs;
+                statistics.maxLatencyMs = std::max(statistics.maxLatencyMs, latencyMs);
+            }
+
+            try {
+                dispatch(entry.call);
+            } catch (std::exception & e) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (error.empty()) {
+                    error = e.what();
+                }
+            }
+            if (entry.closesSlice) {
+                slice++;
+            }
+        } else if (stopping && lanesEmpty()) {
+            return;
+        } else if (idleSpins < 64) {
+            idleSpins++;
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+void AsyncActuatorsInterface::dispatch(const QueuedCall & call) {
+    const std::string & first = call.containers[0] >= 0 ? containerNames[call.containers[0]] : containerNames[0];
+    const std::string & second = call.containers[1] >= 0 ? containerNames[call.containers[1]] : containerNames[0];
+    const std::string & third = call.containers[2] >= 0 ? containerNames[call.containers[2]] : containerNames[0];
+
+    switch(call.opcode) {
+    case APPLY_LIGTH:
+        actuatorInterface->applyLigth(first, call.lengths[0], call.intensity);
+        break;
+    case STOP_APPLY_LIGTH:
+        actuatorInterface->stopApplyLigth(first);
+        break;
+    case APPLY_TEMPERATURE:
+        actuatorInterface->applyTemperature(first, call.temperature);
+        break;
+    case STOP_APPLY_TEMPERATURE:
+        actuatorInterface->stopApplyTemperature(first);
+        break;
+    case STIR:
+        actuatorInterface->stir(first, call.frequency);
+        break;
+    case STOP_STIR:
+        actuatorInterface->stopStir(first);
+        break;
+    case CENTRIFUGATE:
+        actuatorInterface->centrifugate(first, call.frequency);
+        break;
+    case STOP_CENTRIFUGATE:
+        actuatorInterface->stopCentrifugate(first);
+        break;
+    case SHAKE:
+        actuatorInterface->shake(first, call.frequency);
+        break;
+    case STOP_SHAKE:
+        actuatorInterface->stopShake(first);
+        break;
+    case START_ELECTROPHORESIS:
+        actuatorInterface->startElectrophoresis(first, call.field);
+        break;
+    case STOP_ELECTROPHORESIS:
+        answer(call.result, [this, &first](PendingResult & pending) {
+            pending.electrophoresis = actuatorInterface->stopElectrophoresis(first);
+        });
+        break;
+    case GET_VIRTUAL_VOLUME:
+        answer(call.result, [this, &first](PendingResult & pending) {
+            pending.volume = actuatorInterface->getVirtualVolume(first);
+        });
+        break;
+    case LOAD_CONTAINER:
+        actuatorInterface->loadContainer(first, call.volumes[0]);
+        break;
+    case START_MEASURE_OD:
+        actuatorInterface->startMeasureOD(first, call.frequency, call.lengths[0]);
+        break;
+    case GET_MEASURE_OD:
+        answer(call.result, [this, &first](PendingResult & pending) {
+            pending.od = actuatorInterface->getMeasureOD(first);
+        });
+        break;
+    case START_MEASURE_TEMPERATURE:
+        actuatorInterface->startMeasureTemperature(first, call.frequency);
+        break;
+    case GET_MEASURE_TEMPERATURE:
+        answer(call.result, [this, &first](PendingResult & pending) {
+            pending.temperature = actuatorInterface->getMeasureTemperature(first);
+        });
+        break;
+    case START_MEASURE_LUMINISCENSE:
+        actuatorInterface->startMeasureLuminiscense(first, call.frequency);
+        break;
+    case GET_MEASURE_LUMINISCENSE:
+        answer(call.result, [this, &first](PendingResult & pending) {
+            pending.intensity = actuatorInterface->getMeasureLuminiscense(first);
+        });
+        break;
+    case START_MEASURE_VOLUME:
+        actuatorInterface->startMeasureVolume(first, call.frequency);
+        break;
+    case GET_MEASURE_VOLUME:
+        answer(call.result, [this, &first](PendingResult & pending) {
+            pending.volume = actuatorInterface->getMeasureVolume(first);
+        });
+        break;
+    case START_MEASURE_FLUORESCENCE:
+        actuatorInterface->startMeasureFluorescence(first, call.frequency, call.lengths[0], call.lengths[1]);
+        break;
+    case GET_MEASURE_FLUORESCENCE:
+        answer(call.result, [this, &first](PendingResult & pending) {
+            pending.intensity = actuatorInterface->getMeasureFluorescence(first);
+        });
+        break;
+    case SET_CONTINUOS_FLOW:
+        actuatorInterface->setContinuosFlow(first, second, call.rate);
+        break;
+    case STOP_CONTINUOS_FLOW:
+        actuatorInterface->stopContinuosFlow(first, second);
+        break;
+    case TRANSFER:
+        answer(call.result, [this, &first, &second, &call](PendingResult & pending) {
+            pending.time = actuatorInterface->transfer(first, second, call.volumes[0]);
+        });
+        break;
+    case STOP_TRANSFER:
+        actuatorInterface->stopTransfer(first, second);
+        break;
+    case MIX:
+        answer(call.result, [this, &first, &second, &third, &call](PendingResult & pending) {
+            pending.time = actuatorInterface->mix(first, second, third, call.volumes[0], call.volumes[1]);
+        });
+        break;
+    case STOP_MIX:
+        actuatorInterface->stopMix(first, second, third);
+        break;
+    case SET_TIME_STEP:
+        actuatorInterface->setTimeStep(call.time);
+        break;
+    case TIME_STEP:
+        actuatorInterface->timeStep();
+        break;
+    case FLUSH:
+        answer(call.result, [](PendingResult & pending) {});
+        break;
+    }
+}
+
+int AsyncActuatorsInterface::nextLane(unsigned long long slice, unsigned long long releasedSequence) {
+    for(int lane = 0; lane < COMMAND_CLASSES; lane++) {
+        LaneEntry* front = lanes[lane].front();
+        if (front != nullptr && front->sequence < releasedSequence && front->slice <= slice) {
+            return lane;
+        }
+    }
+    return -1;
+}
+
+bool AsyncActuatorsInterface::lanesEmpty() const {
+    for(const SpscRingBuffer<LaneEntry> & lane: lanes) {
+        if (!lane.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
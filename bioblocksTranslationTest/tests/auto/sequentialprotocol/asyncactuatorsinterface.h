@@ -0,0 +1,353 @@
+#ifndef ASYNCACTUATORSINTERFACE_H
+#define ASYNCACTUATORSINTERFACE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "forwardingactuatorsinterface.h"
+#include "spscringbuffer.h"
+#include "ticktimebase.h"
+
+/**
+ * Moves the calls to the backend to a dedicated I/O thread.
+ *
+ * Every call is queued in a preallocated SpscRingBuffer and returns at once, so slow serial lines do not
+ * hold the protocol clock. A queued call is a fixed-size record: an opcode, the containers as indices into
+ * a table of names filled the first time each one is seen, and the arguments as they were given, so
+ * queueing a command allocates nothing and the I/O thread frees nothing. Calls that hand a value back to the
+ * graph (measurements, transfer, mix, electrophoresis results, virtual volume) are queued too and the
+ * caller waits for the answer in one of a fixed set of result slots (one per container and one more),
+ * which keeps them ordered with the commands issued before. timeStep() returns the slice set with
+ * setTimeStep without waiting for the backend. More than maxContainers different containers is an error.
+ *
+ * With enableSpeculation() transfer and mix do not wait: they are queued and answer at once with an
+ * estimated duration, from the DurationModel of the backend if there is one or else from the time per ml
+ * seen in the previous calls of the same operation, so the linked operations that follow are queued right
+ * behind them. The clock does not go past the slice of a speculated call until its real duration is known.
+ * The backend is stopped when the real duration has elapsed, and the stop of the graph is not sent again,
+ * so an overestimated operation does not run longer. When an estimate runs out before the real duration,
+ * the time step is held: the slices missing are sent to the backend and the executor is told that they
+ * elapsed in that step, so the executor clock, the stop and every other track stay in the backend time.
+ *
+ * With enablePriorityLanes() every command class has its own queue: stops first, then set-points,
+ * measurements, bulk commands like loadContainer and last the clock. The commands of a slice are handed to
+ * the I/O thread together, when its timeStep (or a call that waits for a value) is queued, and the thread
+ * always takes the next command from the most urgent queue, so a stop waits at most for the call in
+ * flight and the stops queued before it, however busy the slice. timeStep and setTimeStep stay barriers,
+ * and a command never overtakes an earlier one of the same slice on the same container: it goes to the
+ * queue of that one instead. getLaneStatistics() reports the latency from queued to sent of every class.
+ *
+ * Errors raised by queued commands are reported by the next call made from the executor thread.
+ * The executor thread is the only producer: the interface must not be shared between executors.
+ */
+class AsyncActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    typedef std::function<units::Time(const std::string & operation, units::Volume volume)> DurationModel;
+
+    typedef enum CommandClass_ {
+        SAFETY = 0,
+        SET_POINT,
+        MEASUREMENT,
+        BULK,
+        CLOCK,
+        COMMAND_CLASSES
+    } CommandClass;
+
+    typedef struct LaneStatistics_ {
+        unsigned long long commands;
+        double totalLatencyMs;
+        double maxLatencyMs;
+    } LaneStatistics;
+
+    AsyncActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface, std::size_t queueCapacity = 1024, std::size_t maxContainers = 256);
+    virtual ~AsyncActuatorsInterface();
+
+    virtual void applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity);
+    virtual void stopApplyLigth(const std::string & sourceId);
+
+    virtual void applyTemperature(const std::string & sourceId, units::Temperature temperature);
+    virtual void stopApplyTemperature(const std::string & sourceId);
+
+    virtual void stir(const std::string & idSource, units::Frequency intensity);
+    virtual void stopStir(const std::string & idSource);
+
+    virtual void centrifugate(const std::string & idSource, units::Frequency intensity);
+    virtual void stopCentrifugate(const std::string & idSource);
+
+    virtual void shake(const std::string & idSource, units::Frequency intensity);
+    virtual void stopShake(const std::string & idSource);
+
+    virtual void startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght);
+    virtual std::shared_ptr<ElectrophoresisResult> stopElectrophoresis(const std::string & idSource);
+
+    virtual units::Volume getVirtualVolume(const std::string & sourceId);
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual void startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength);
+    virtual double getMeasureOD(const std::string & sourceId);
+
+    virtual void startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+
+    virtual void startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+
+    virtual void startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+
+    virtual void startMeasureFluorescence(const std::string & sourceId,
+                                          units::Frequency measurementFrequency,
+                                          units::Length excitation,
+                                          units::Length emission);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual void setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate);
+    virtual void stopContinuosFlow(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume);
+    virtual void stopTransfer(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time mix(const std::string & idSource1,
+                            const std::string & idSource2,
+                            const std::string & idTarget,
+                            units::Volume volume1,
+                            units::Volume volume2);
+
+    virtual void stopMix(const std::string & idSource1,
+                         const std::string & idSource2,
+                         const std::string & idTarget);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    void flush() throw(std::runtime_error);
+
+    void enableSpeculation(DurationModel durationModel = DurationModel(), units::Time initialTimePerMl = 1*units::s);
+    /** must be called before the first command */
+    void enablePriorityLanes();
+
+    LaneStatistics getLaneStatistics(CommandClass commandClass) const;
+
+    inline unsigned long long getQueuedCalls() const {
+        return queuedCalls;
+    }
+
+    inline unsigned long long getFullQueueWaits() const {
+        return fullQueueWaits;
+    }
+
+    inline unsigned long long getBlockingCalls() const {
+        return blockingCalls;
+    }
+
+    inline unsigned long long getSpeculatedCalls() const {
+        return speculatedCalls;
+    }
+
+    inline unsigned long long getMispredictions() const {
+        return mispredictions;
+    }
+
+    inline unsigned long long getStallSlices() const {
+        return stallSlices;
+    }
+
+    inline unsigned long long getDemotedCalls() const {
+        return demotedCalls;
+    }
+
+protected:
+    typedef enum Opcode_ {
+        APPLY_LIGTH = 0,
+        STOP_APPLY_LIGTH,
+        APPLY_TEMPERATURE,
+        STOP_APPLY_TEMPERATURE,
+        STIR,
+        STOP_STIR,
+        CENTRIFUGATE,
+        STOP_CENTRIFUGATE,
+        SHAKE,
+        STOP_SHAKE,
+        START_ELECTROPHORESIS,
+        STOP_ELECTROPHORESIS,
+        GET_VIRTUAL_VOLUME,
+        LOAD_CONTAINER,
+        START_MEASURE_OD,
+        GET_MEASURE_OD,
+        START_MEASURE_TEMPERATURE,
+        GET_MEASURE_TEMPERATURE,
+        START_MEASURE_LUMINISCENSE,
+        GET_MEASURE_LUMINISCENSE,
+        START_MEASURE_VOLUME,
+        GET_MEASURE_VOLUME,
+        START_MEASURE_FLUORESCENCE,
+        GET_MEASURE_FLUORESCENCE,
+        SET_CONTINUOS_FLOW,
+        STOP_CONTINUOS_FLOW,
+        TRANSFER,
+        STOP_TRANSFER,
+        MIX,
+        STOP_MIX,
+        SET_TIME_STEP,
+        TIME_STEP,
+        FLUSH
+    } Opcode;
+
+    /**
+     * containers are indices into containerNames, -1 when unused; only the arguments of the opcode are set.
+     * result is the slot where a call that hands a value back leaves it, -1 for the rest
+     */
+    typedef struct QueuedCall_ {
+        int opcode;
+        int containers[3];
+        units::Length lengths[2];
+        units::Frequency frequency;
+        units::LuminousIntensity intensity;
+        units::Temperature temperature;
+        units::ElectricField field;
+        units::Volume volumes[2];
+        units::Volumetric_Flow rate;
+        units::Time time;
+        int result;
+    } QueuedCall;
+
+    /** written by the I/O thread before ready is set under resultMutex, read by the executor after */
+    typedef struct PendingResult_ {
+        bool ready;
+        double od;
+        units::Volume volume;
+        units::Temperature temperature;
+        units::LuminousIntensity intensity;
+        units::Time time;
+        std::shared_ptr<ElectrophoresisResult> electrophoresis;
+        std::string error;
+    } PendingResult;
+
+    typedef struct LaneEntry_ {
+        QueuedCall call;
+        CommandClass commandClass;
+        bool closesSlice;
+        unsigned long long slice;
+        unsigned long long sequence;
+        std::chrono::steady_clock::time_point queuedAt;
+    } LaneEntry;
+
+    typedef struct Speculation_ {
+        int result;
+        std::string operation;
+        units::Volume volume;
+        QueuedCall stop;
+        TickTimebase::Ticks estimate;
+        TickTimebase::Ticks issuedAt;
+        TickTimebase::Ticks duration;
+        bool learnt;
+        bool stopped;
+    } Speculation;
+
+    typedef struct DurationHistory_ {
+        double totalMs;
+        double totalMl;
+    } DurationHistory;
+
+    SpscRingBuffer<LaneEntry> lanes[COMMAND_CLASSES];
+    std::vector<std::string> containerNames;
+    std::unordered_map<std::string, int> containerIds;
+    std::size_t internedContainers;
+
+    std::vector<PendingResult> results;
+    std::vector<int> freeResults;
+    std::mutex resultMutex;
+    std::condition_variable resultReady;
+    std::atomic<unsigned long long> released;
+    std::atomic<bool> stopping;
+    std::thread ioThread;
+
+    std::mutex errorMutex;
+    std::string error;
+
+    mutable std::mutex statisticsMutex;
+    std::vector<LaneStatistics> laneStatistics;
+
+    units::Time timeSlice;
+    unsigned long long queuedCalls;
+    unsigned long long fullQueueWaits;
+    unsigned long long blockingCalls;
+
+    bool speculationEnabled;
+    DurationModel durationModel;
+    units::Time initialTimePerMl;
+    std::map<std::string, DurationHistory> history;
+    std::map<std::string, Speculation> speculations;
+    TickTimebase::Ticks elapsed;
+    unsigned long long speculatedCalls;
+    unsigned long long mispredictions;
+    unsigned long long stallSlices;
+    TickTimebase::Ticks stalled;
+
+    bool prioritiesEnabled;
+    std::vector<int> containerLanes;
+    std::vector<int> sliceContainers;
+    unsigned long long postedSlice;
+    unsigned long long nextSequence;
+    unsigned long long demotedCalls;
+
+    int intern(const std::string & container) throw(std::runtime_error);
+    QueuedCall newCall(int opcode, int container0 = -1, int container1 = -1, int container2 = -1) const;
+
+    PendingResult & waitResult(CommandClass commandClass, QueuedCall & call) throw(std::runtime_error);
+    int acquireResult() throw(std::runtime_error);
+    void waitFor(int result);
+    void releaseResult(int result);
+
+    units::Time speculate(const std::string & operation,
+                          const std::string & key,
+                          QueuedCall call,
+                          const QueuedCall & stop,
+                          units::Volume volume) throw(std::runtime_error);
+    units::Time estimate(const std::string & operation, units::Volume volume) const;
+    void learn(Speculation & speculation);
+    bool settle(const std::string & key) throw(std::runtime_error);
+    void step() throw(std::runtime_error);
+    bool isHeld() const;
+
+    void post(CommandClass commandClass, const QueuedCall & call) throw(std::runtime_error);
+    void postBarrier(const QueuedCall & call) throw(std::runtime_error);
+    void push(int lane, CommandClass commandClass, bool closesSlice, const QueuedCall & call) throw(std::runtime_error);
+    void release();
+    void checkError() throw(std::runtime_error);
+    void run();
+    void dispatch(const QueuedCall & call);
+    int nextLane(unsigned long long slice, unsigned long long releasedSequence);
+    bool lanesEmpty() const;
+
+    template<typename F>
+    void answer(int result, F function) {
+        PendingResult & pending = results[result];
+        try {
+            function(pending);
+        } catch (std::exception & e) {
+            pending.error = e.what();
+        } catch (...) {
+            pending.error = "unknown error";
+        }
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            pending.ready = true;
+        }
+        resultReady.notify_all();
+    }
+};
+
+#endif // ASYNCACTUATORSINTERFACE_H
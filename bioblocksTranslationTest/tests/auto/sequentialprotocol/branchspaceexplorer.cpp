@@ -0,0 +1,261 @@
+#include "branchspaceexplorer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "simulatedactuatorsinterface.h"
+
+namespace {
+
+const int visitedShards = 16;
+
+void hashBytes(unsigned long long & hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for(size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+void hashString(unsigned long long & hash, const std::string & text) {
+    hashBytes(hash, text.data(), text.size() + 1);
+}
+
+void hashNumber(unsigned long long & hash, double value) {
+    long long quantized = std::llround(value * 1e6);
+    hashBytes(hash, &quantized, sizeof(quantized));
+}
+
+}
+
+BranchSpaceExplorer::BranchSpaceExplorer(GraphFactory graphFactory, unsigned int threads, unsigned long long maxSlices) :
+    graphFactory(graphFactory), threads(threads), maxSlices(maxSlices), pendingPaths(0),
+    paths(0), prunedPaths(0), boundedPaths(0), states(0), steals(0)
+{
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+BranchSpaceExplorer::~BranchSpaceExplorer()
+{
+
+}
+
+void BranchSpaceExplorer::setOutcomes(const std::string & measurement, const std::vector<double> & values) {
+    outcomes[measurement] = values;
+}
+
+void BranchSpaceExplorer::addInvariant(const std::string & name, VolumeInvariant invariant) {
+    invariants.push_back(std::make_pair(name, invariant));
+}
+
+void BranchSpaceExplorer::addVolumeBounds(const std::string & container, double minMl, double maxMl) {
+    std::string name = container + " in [" + std::to_string(minMl) + "ml, " + std::to_string(maxMl) + "ml]";
+    addInvariant(name, [container, minMl, maxMl](const std::map<std::string, double> & volumesMl) {
+        auto it = volumesMl.find(container);
+        return it == volumesMl.end() || (it->second >= minMl && it->second <= maxMl);
+    });
+}
+
+void BranchSpaceExplorer::setVariableCapture(VariableCapture captureVariables) {
+    this->captureVariables = captureVariables;
+}
+
+BranchSpaceExplorer::ExplorationResult BranchSpaceExplorer::explore() throw(std::runtime_error) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    queues.clear();
+    for(unsigned int i = 0; i < threads; i++) {
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    visited.clear();
+    for(int i = 0; i < visitedShards; i++) {
+        visited.push_back(std::unique_ptr<VisitedShard>(new VisitedShard()));
+    }
+    violations.clear();
+    paths = 0;
+    prunedPaths = 0;
+    boundedPaths = 0;
+    states = 0;
+    steals = 0;
+
+    pendingPaths = 0;
+    push(0, Path());
+
+    std::vector<std::thread> workers;
+    for(unsigned int i = 1; i < threads; i++) {
+        workers.push_back(std::thread(&BranchSpaceExplorer::work, this, i));
+    }
+    work(0);
+
+    for(std::thread & thread: workers) {
+        thread.join();
+    }
+
+    ExplorationResult result;
+    result.paths = paths;
+    result.prunedPaths = prunedPaths;
+    result.boundedPaths = boundedPaths;
+    result.states = states;
+    result.steals = steals;
+    result.violations = violations;
+    result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void BranchSpaceExplorer::work(unsigned int worker) {
+    Path path;
+    while(pendingPaths > 0) {
+        if (pop(worker, path) || steal(worker, path)) {
+            runPath(path, worker);
+            pendingPaths--;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void BranchSpaceExplorer::runPath(const Path & path, unsigned int worker) {
+    SimulatedActuatorsInterface simulated;
+    ExplorationActuatorsInterface interface(&simulated, outcomes, path);
+
+    try {
+        std::shared_ptr<ProtocolGraph> protocol = graphFactory();
+        ProtocolExecutor executor(protocol, &interface);
+        if (captureVariables) {
+            VariableCapture capture = captureVariables;
+            executor.setVariableHooks([protocol, capture](std::map<std::string, double> & variables) {
+                capture(protocol, variables);
+            }, ProtocolExecutor::VariableRestoreFunction());
+        }
+        while(executor.executeNextNode()) {
+            for(const ExplorationActuatorsInterface::BranchingPoint & point: interface.takeBranchingPoints()) {
+                for(size_t outcome = 1; outcome < point.outcomes; outcome++) {
+                    Path sibling(interface.getChoices().begin(), interface.getChoices().begin() + point.choice);
+                    sibling.push_back(outcome);
+                    push(worker, sibling);
+                }
+            }
+
+            if (interface.takeSliceElapsed() && !checkInvariants(interface)) {
+                paths++;
+                return;
+            }
+
+            size_t choice;
+            if (interface.takeChoiceMade(choice) && captureVariables && choice + 1 >= path.size() &&
+                !markVisited(executor, interface))
+            {
+                prunedPaths++;
+                return;
+            }
+
+            if (interface.getElapsedSlices() > maxSlices) {
+                boundedPaths++;
+                return;
+            }
+        }
+        if (checkInvariants(interface)) {
+            paths++;
+        }
+    } catch (std::exception & e) {
+        addViolation(std::string("execution error: ") + e.what(), interface);
+    }
+}
+
+void BranchSpaceExplorer::push(unsigned int worker, const Path & path) {
+    pendingPaths++;
+    std::lock_guard<std::mutex> lock(queues[worker]->mutex);
+    queues[worker]->paths.push_back(path);
+}
+
+bool BranchSpaceExplorer::pop(unsigned int worker, Path & path) {
+    std::lock_guard<std::mutex> lock(queues[worker]->mutex);
+    if (queues[worker]->paths.empty()) {
+        return false;
+    }
+    path = queues[worker]->paths.back();
+    queues[worker]->paths.pop_back();
+    return true;
+}
+
+bool BranchSpaceExplorer::steal(unsigned int worker, Path & path) {
+    for(unsigned int i = 1; i < queues.size(); i++) {
+        WorkerQueue & victim = *queues[(worker + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.paths.empty()) {
+            path = victim.paths.front();
+            victim.paths.pop_front();
+            steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BranchSpaceExplorer::checkInvariants(ExplorationActuatorsInterface & interface) {
+    if (invariants.empty()) {
+        return true;
+    }
+
+    std::map<std::string, double> volumes = interface.getVolumes();
+    for(const std::pair<std::string, VolumeInvariant> & invariant: invariants) {
+        if (!invariant.second(volumes)) {
+            addViolation(invariant.first, interface);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BranchSpaceExplorer::markVisited(const ProtocolExecutor & executor, ExplorationActuatorsInterface & interface) {
+    ExecutionCheckpoint checkpoint = executor.makeCheckpoint();
+
+    unsigned long long hash = 14695981039346656037ULL;
+    hashBytes(hash, &checkpoint.elapsedSlices, sizeof(checkpoint.elapsedSlices));
+    for(int node: checkpoint.frontier) {
+        hashBytes(hash, &node, sizeof(node));
+    }
+    for(const ActiveCommand & command: checkpoint.activeCommands) {
+        hashBytes(hash, &command.type, sizeof(command.type));
+        hashString(hash, command.source);
+        hashString(hash, command.target);
+        for(double value: command.values) {
+            hashNumber(hash, value);
+        }
+    }
+    for(const std::pair<const std::string, double> & volume: interface.getVolumes()) {
+        hashString(hash, volume.first);
+        hashNumber(hash, volume.second);
+    }
+    for(const std::pair<const std::string, double> & value: interface.getLastValues()) {
+        hashString(hash, value.first);
+        hashNumber(hash, value.second);
+    }
+    for(const std::pair<const std::string, double> & variable: checkpoint.variables) {
+        hashString(hash, variable.first);
+        hashNumber(hash, variable.second);
+    }
+
+    VisitedShard & shard = *visited[hash % visited.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.states.insert(hash).second) {
+        return false;
+    }
+    states++;
+    return true;
+}
+
+void BranchSpaceExplorer::addViolation(const std::string & invariant, ExplorationActuatorsInterface & interface) {
+    Violation violation;
+    violation.invariant = invariant;
+    violation.values = interface.getValues();
+    violation.slice = interface.getElapsedSlices();
+    violation.volumesMl = interface.getVolumes();
+
+    std::lock_guard<std::mutex> lock(resultMutex);
+    violations.push_back(violation);
+}
@@ -0,0 +1,120 @@
+#ifndef BRANCHSPACEEXPLORER_H
+#define BRANCHSPACEEXPLORER_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <protocolGraph/ProtocolGraph.h>
+
+#include "explorationactuatorsinterface.h"
+#include "protocolexecutor.h"
+
+/**
+ * Executes a protocol under every combination of measurement outcomes, checking invariants over the
+ * simulated container volumes.
+ *
+ * The conditions of a ProtocolGraph can not be inspected, what they depend on is the values handed back
+ * by the measurements, so the execution forks there: every measurement type with a set of outcomes
+ * ("OD", "Temperature", "Luminiscense", "Volume", "Fluorescence") is a branching point. A path is the list
+ * of outcomes chosen; it is executed from the start against a SimulatedActuatorsInterface, and every new
+ * branching point it reaches adds the paths with the other outcomes to the pool.
+ *
+ * With a variable capture set, after every outcome the state (frontier, elapsed slices, active commands,
+ * volumes, last value of every sensor and the graph variables the capture hands back) is hashed; a path
+ * that reaches a state already seen stops there, whatever follows was already explored. The elapsed slices
+ * are part of the state, so only paths that reach the same state at the same slice are merged, not a state
+ * that repeats later in time. ProtocolGraph does not expose its variables, so without a capture two states
+ * can not be told equal and nothing is pruned. Paths longer than maxSlices stop and are counted as bounded.
+ *
+ * Paths are distributed over a work-stealing pool: every worker pushes and pops the paths it creates at
+ * the back of its own queue and steals from the front of the others when it runs out. A violation keeps
+ * the outcomes of its path, which can be given as is to a StringActuatorsInterface to reproduce it.
+ */
+class BranchSpaceExplorer
+{
+public:
+    typedef std::function<std::shared_ptr<ProtocolGraph>()> GraphFactory;
+    typedef std::function<bool(const std::map<std::string, double> &)> VolumeInvariant;
+    typedef std::function<void(const std::shared_ptr<ProtocolGraph> &, std::map<std::string, double> &)> VariableCapture;
+
+    typedef struct Violation_ {
+        std::string invariant;
+        std::vector<double> values;
+        unsigned long long slice;
+        std::map<std::string, double> volumesMl;
+    } Violation;
+
+    typedef struct ExplorationResult_ {
+        unsigned long long paths = 0;
+        unsigned long long prunedPaths = 0;
+        unsigned long long boundedPaths = 0;
+        unsigned long long states = 0;
+        unsigned long long steals = 0;
+        std::vector<Violation> violations;
+        double durationMs = 0;
+    } ExplorationResult;
+
+    BranchSpaceExplorer(GraphFactory graphFactory, unsigned int threads = 0, unsigned long long maxSlices = 100000);
+    virtual ~BranchSpaceExplorer();
+
+    void setOutcomes(const std::string & measurement, const std::vector<double> & values);
+    void addInvariant(const std::string & name, VolumeInvariant invariant);
+    void addVolumeBounds(const std::string & container, double minMl, double maxMl);
+    void setVariableCapture(VariableCapture captureVariables);
+
+    ExplorationResult explore() throw(std::runtime_error);
+
+protected:
+    typedef std::vector<int> Path;
+
+    typedef struct WorkerQueue_ {
+        std::mutex mutex;
+        std::deque<Path> paths;
+    } WorkerQueue;
+
+    typedef struct VisitedShard_ {
+        std::mutex mutex;
+        std::unordered_set<unsigned long long> states;
+    } VisitedShard;
+
+    GraphFactory graphFactory;
+    unsigned int threads;
+    unsigned long long maxSlices;
+
+    std::map<std::string, std::vector<double>> outcomes;
+    std::vector<std::pair<std::string, VolumeInvariant>> invariants;
+    VariableCapture captureVariables;
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::unique_ptr<VisitedShard>> visited;
+    std::atomic<unsigned long long> pendingPaths;
+
+    std::atomic<unsigned long long> paths;
+    std::atomic<unsigned long long> prunedPaths;
+    std::atomic<unsigned long long> boundedPaths;
+    std::atomic<unsigned long long> states;
+    std::atomic<unsigned long long> steals;
+    std::mutex resultMutex;
+    std::vector<Violation> violations;
+
+    void work(unsigned int worker);
+    void runPath(const Path & path, unsigned int worker);
+
+    void push(unsigned int worker, const Path & path);
+    bool pop(unsigned int worker, Path & path);
+    bool steal(unsigned int worker, Path & path);
+
+    bool checkInvariants(ExplorationActuatorsInterface & interface);
+    bool markVisited(const ProtocolExecutor & executor, ExplorationActuatorsInterface & interface);
+    void addViolation(const std::string & invariant, ExplorationActuatorsInterface & interface);
+};
+
+#endif // BRANCHSPACEEXPLORER_H
@@ -0,0 +1,390 @@
+#include "commandoptimizingactuatorsinterface.h"
+
+#include <algorithm>
+
+CommandOptimizingActuatorsInterface::CommandOptimizingActuatorsInterface(
+        ActuatorsExecutionInterface* actuatorInterface,
+        bool keepLiteralStream) :
+    ForwardingActuatorsInterface(actuatorInterface), keepLiteralStream(keepLiteralStream)
+{
+    holding = true;
+    cancelledPairs = 0;
+    droppedSetPoints = 0;
+    mergedChanges = 0;
+    removedCommands = 0;
+}
+
+CommandOptimizingActuatorsInterface::~CommandOptimizingActuatorsInterface()
+{
+
+}
+
+void CommandOptimizingActuatorsInterface::flush() {
+    for(const PendingSetPoint & setPoint: pending) {
+        auto backend = backendSetPoints.find(setPoint.key);
+        bool backendActive = backend != backendSetPoints.end();
+
+        unsigned int sent = 0;
+        if (setPoint.active == backendActive && (!setPoint.active || backend->second == setPoint.values)) {
+            if (setPoint.commands > 1) {
+                cancelledPairs++;
+            } else {
+                droppedSetPoints++;
+            }
+        } else if (!setPoint.active) {
+            sendStop(setPoint.key);
+            backendSetPoints.erase(backend);
+            sent = 1;
+        } else {
+            sendSetPoint(setPoint.key, setPoint.values);
+            backendSetPoints[setPoint.key] = setPoint.values;
+            if (setPoint.commands > 1) {
+                mergedChanges++;
+            }
+            sent = 1;
+        }
+        removedCommands += setPoint.commands - sent;
+    }
+    pending.clear();
+}
+
+void CommandOptimizingActuatorsInterface::setHolding(bool holding) {
+    this->holding = holding;
+    if (!holding) {
+        flush();
+    }
+}
+
+void CommandOptimizingActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {
+    if (keepLiteralStream) {
+        actuatorInterface->applyLigth(sourceId, wavelength, intensity);
+        return;
+    }
+    setPoint(ActiveCommand::light, sourceId, "", {wavelength.to(units::nm), intensity.to(units::cd)});
+}
+
+void CommandOptimizingActuatorsInterface::stopApplyLigth(const std::string & sourceId) {
+    if (keepLiteralStream) {
+        actuatorInterface->stopApplyLigth(sourceId);
+        return;
+    }
+    stopSetPoint(ActiveCommand::light, sourceId);
+}
+
+void CommandOptimizingActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {
+    if (keepLiteralStream) {
+        actuatorInterface->applyTemperature(sourceId, temperature);
+        return;
+    }
+    setPoint(ActiveCommand::temperature, sourceId, "", {temperature.to(units::C)});
+}
+
+void CommandOptimizingActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {
+    if (keepLiteralStream) {
+        actuatorInterface->stopApplyTemperature(sourceId);
+        return;
+    }
+    stopSetPoint(ActiveCommand::temperature, sourceId);
+}
+
+void CommandOptimizingActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {
+    if (keepLiteralStream) {
+        actuatorInterface->stir(idSource, intensity);
+        return;
+    }
+    setPoint(ActiveCommand::stir, idSource, "", {intensity.to(units::Hz)});
+}
+
+void CommandOptimizingActuatorsInterface::stopStir(const std::string & idSource) {
+    if (keepLiteralStream) {
+        actuatorInterface->stopStir(idSource);
+        return;
+    }
+    stopSetPoint(ActiveCommand::stir, idSource);
+}
+
+void CommandOptimizingActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {
+    if (keepLiteralStream) {
+        actuatorInterface->centrifugate(idSource, intensity);
+        return;
+    }
+    setPoint(ActiveCommand::centrifugate, idSource, "", {intensity.to(units::Hz)});
+}
+
+void CommandOptimizingActuatorsInterface::stopCentrifugate(const std::string & idSource) {
+    if (keepLiteralStream) {
+        actuatorInterface->stopCentrifugate(idSource);
+        return;
+    }
+    stopSetPoint(ActiveCommand::centrifugate, idSource);
+}
+
+void CommandOptimizingActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {
+    if (keepLiteralStream) {
+        actuatorInterface->shake(idSource, intensity);
+        return;
+    }
+    setPoint(ActiveCommand::shake, idSource, "", {intensity.to(units::Hz)});
+}
+
+void CommandOptimizingActuatorsInterface::stopShake(const std::string & idSource) {
+    if (keepLiteralStream) {
+        actuatorInterface->stopShake(idSource);
+        return;
+    }
+    stopSetPoint(ActiveCommand::shake, idSource);
+}
+
+void CommandOptimizingActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {
+    flush();
+    actuatorInterface->startElectrophoresis(idSource, fieldStrenght);
+}
+
+std::shared_ptr<ElectrophoresisResult> CommandOptimizingActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    flush();
+    return actuatorInterface->stopElectrophoresis(idSource);
+}
+
+units::Volume CommandOptimizingActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    flush();
+    return actuatorInterface->getVirtualVolume(sourceId);
+}
+
+void CommandOptimizingActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    flush();
+    actuatorInterface->loadContainer(sourceId, initialVolume);
+}
+
+void CommandOptimizingActuatorsInterface::startMeasureOD(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length wavelength)
+{
+    flush();
+    actuatorInterface->startMeasureOD(sourceId, measurementFrequency, wavelength);
+}
+
+double CommandOptimizingActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    flush();
+    return actuatorInterface->getMeasureOD(sourceId);
+}
+
+void CommandOptimizingActuatorsInterface::startMeasureTemperature(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    flush();
+    actuatorInterface->startMeasureTemperature(sourceId, measurementFrequency);
+}
+
+units::Temperature CommandOptimizingActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    flush();
+    return actuatorInterface->getMeasureTemperature(sourceId);
+}
+
+void CommandOptimizingActuatorsInterface::startMeasureLuminiscense(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    flush();
+    actuatorInterface->startMeasureLuminiscense(sourceId, measurementFrequency);
+}
+
+units::LuminousIntensity CommandOptimizingActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    flush();
+    return actuatorInterface->getMeasureLuminiscense(sourceId);
+}
+
+void CommandOptimizingActuatorsInterface::startMeasureVolume(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    flush();
+    actuatorInterface->startMeasureVolume(sourceId, measurementFrequency);
+}
+
+units::Volume CommandOptimizingActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    flush();
+    return actuatorInterface->getMeasureVolume(sourceId);
+}
+
+void CommandOptimizingActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+    flush();
+    actuatorInterface->startMeasureFluorescence(sourceId, measurementFrequency, excitation, emission);
+}
+
+units::LuminousIntensity CommandOptimizingActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    flush();
+    return actuatorInterface->getMeasureFluorescence(sourceId);
+}
+
+void CommandOptimizingActuatorsInterface::setContinuosFlow(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volumetric_Flow rate)
+{
+    if (keepLiteralStream) {
+        actuatorInterface->setContinuosFlow(idSource, idTarget, rate);
+        return;
+    }
+    setPoint(ActiveCommand::continuous_flow, idSource, idTarget, {rate.to(units::ml/units::hr)});
+}
+
+void CommandOptimizingActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {
+    if (keepLiteralStream) {
+        actuatorInterface->stopContinuosFlow(idSource, idTarget);
+        return;
+    }
+    stopSetPoint(ActiveCommand::continuous_flow, idSource, idTarget);
+}
+
+units::Time CommandOptimizingActuatorsInterface::transfer(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volume volume)
+{
+    flush();
+    return actuatorInterface->transfer(idSource, idTarget, volume);
+}
+
+void CommandOptimizingActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {
+    flush();
+    actuatorInterface->stopTransfer(idSource, idTarget);
+}
+
+units::Time CommandOptimizingActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    flush();
+    return actuatorInterface->mix(idSource1, idSource2, idTarget, volume1, volume2);
+}
+
+void CommandOptimizingActuatorsInterface::stopMix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget)
+{
+    flush();
+    actuatorInterface->stopMix(idSource1, idSource2, idTarget);
+}
+
+void CommandOptimizingActuatorsInterface::setTimeStep(units::Time time) {
+    flush();
+    actuatorInterface->setTimeStep(time);
+}
+
+units::Time CommandOptimizingActuatorsInterface::timeStep() {
+    flush();
+    return actuatorInterface->timeStep();
+}
+
+void CommandOptimizingActuatorsInterface::setPoint(
+        int type,
+        const std::string & source,
+        const std::string & target,
+        const std::vector<double> & values)
+{
+    SetPointKey key = std::make_tuple(type, source, target);
+    auto it = std::find_if(pending.begin(), pending.end(), [&key](const PendingSetPoint & setPoint) {
+        return setPoint.key == key;
+    });
+
+    if (it == pending.end()) {
+        PendingSetPoint setPoint;
+        setPoint.key = key;
+        setPoint.active = true;
+        setPoint.values = values;
+        setPoint.commands = 1;
+        pending.push_back(setPoint);
+    } else {
+        it->active = true;
+        it->values = values;
+        it->commands++;
+    }
+    if (!holding) {
+        flush();
+    }
+}
+
+void CommandOptimizingActuatorsInterface::stopSetPoint(int type, const std::string & source, const std::string & target) {
+    SetPointKey key = std::make_tuple(type, source, target);
+    auto it = std::find_if(pending.begin(), pending.end(), [&key](const PendingSetPoint & setPoint) {
+        return setPoint.key == key;
+    });
+
+    if (it == pending.end()) {
+        PendingSetPoint setPoint;
+        setPoint.key = key;
+        setPoint.active = false;
+        setPoint.commands = 1;
+        pending.push_back(setPoint);
+    } else {
+        it->active = false;
+        it->values.clear();
+        it->commands++;
+    }
+    if (!holding) {
+        flush();
+    }
+}
+
+void CommandOptimizingActuatorsInterface::sendSetPoint(const SetPointKey & key, const std::vector<double> & values) {
+    const std::string & source = std::get<1>(key);
+    switch (std::get<0>(key)) {
+    case ActiveCommand::light:
+        actuatorInterface->applyLigth(source, values[0] * units::nm, values[1] * units::cd);
+        break;
+    case ActiveCommand::temperature:
+        actuatorInterface->applyTemperature(source, values[0] * units::C);
+        break;
+    case ActiveCommand::stir:
+        actuatorInterface->stir(source, values[0] * units::Hz);
+        break;
+    case ActiveCommand::centrifugate:
+        actuatorInterface->centrifugate(source, values[0] * units::Hz);
+        break;
+    case ActiveCommand::shake:
+        actuatorInterface->shake(source, values[0] * units::Hz);
+        break;
+    case ActiveCommand::continuous_flow:
+        actuatorInterface->setContinuosFlow(source, std::get<2>(key), values[0] * (units::ml/units::hr));
+        break;
+    default:
+        break;
+    }
+}
+
+void CommandOptimizingActuatorsInterface::sendStop(const SetPointKey & key) {
+    const std::string & source = std::get<1>(key);
+    switch (std::get<0>(key)) {
+    case ActiveCommand::light:
+        actuatorInterface->stopApplyLigth(source);
+        break;
+    case ActiveCommand::temperature:
+        actuatorInterface->stopApplyTemperature(source);
+        break;
+    case ActiveCommand::stir:
+        actuatorInterface->stopStir(source);
+        break;
+    case ActiveCommand::centrifugate:
+        actuatorInterface->stopCentrifugate(source);
+        break;
+    case ActiveCommand::shake:
+        actuatorInterface->stopShake(source);
+        break;
+    case ActiveCommand::continuous_flow:
+        actuatorInterface->stopContinuosFlow(source, std::get<2>(key));
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef COMMANDOPTIMIZINGACTUATORSINTERFACE_H
+#define COMMANDOPTIMIZINGACTUATORSINTERFACE_H
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "executioncheckpoint.h"
+#include "forwardingactuatorsinterface.h"
+
+/**
+ * Removes redundant set-point commands (light, temperature, stir, centrifugate, shake and continuous flows)
+ * before they reach the backend.
+ *
+ * Set-point commands are held until the end of the slice, or until any other command has to be sent, and
+ * only the final value of every actuator is compared with what the backend already has:
+ *  - a stop followed by a start with the same parameters is cancelled,
+ *  - a set-point equal to the one in effect is dropped,
+ *  - several changes of the same actuator are merged into the last one, sent without stopping it first.
+ * Held commands are sent in the order they were first issued. With keepLiteralStream every command is
+ * forwarded as it comes. With holding disabled set-points are sent as they come, only the ones equal to
+ * the set-point in effect are dropped, but the backend state is still followed for when holding resumes.
+ */
+class CommandOptimizingActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    CommandOptimizingActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface, bool keepLiteralStream = false);
+    virtual ~CommandOptimizingActuatorsInterface();
+
+    void flush();
+    void setHolding(bool holding);
+
+    virtual void applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity);
+    virtual void stopApplyLigth(const std::string & sourceId);
+
+    virtual void applyTemperature(const std::string & sourceId, units::Temperature temperature);
+    virtual void stopApplyTemperature(const std::string & sourceId);
+
+    virtual void stir(const std::string & idSource, units::Frequency intensity);
+    virtual void stopStir(const std::string & idSource);
+
+    virtual void centrifugate(const std::string & idSource, units::Frequency intensity);
+    virtual void stopCentrifugate(const std::string & idSource);
+
+    virtual void shake(const std::string & idSource, units::Frequency intensity);
+    virtual void stopShake(const std::string & idSource);
+
+    virtual void startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght);
+    virtual std::shared_ptr<ElectrophoresisResult> stopElectrophoresis(const std::string & idSource);
+
+    virtual units::Volume getVirtualVolume(const std::string & sourceId);
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual void startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength);
+    virtual double getMeasureOD(const std::string & sourceId);
+
+    virtual void startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+
+    virtual void startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+
+    virtual void startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+
+    virtual void startMeasureFluorescence(const std::string & sourceId,
+                                          units::Frequency measurementFrequency,
+                                          units::Length excitation,
+                                          units::Length emission);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual void setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate);
+    virtual void stopContinuosFlow(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume);
+    virtual void stopTransfer(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time mix(const std::string & idSource1,
+                            const std::string & idSource2,
+                            const std::string & idTarget,
+                            units::Volume volume1,
+                            units::Volume volume2);
+
+    virtual void stopMix(const std::string & idSource1,
+                         const std::string & idSource2,
+                         const std::string & idTarget);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    inline unsigned long long getCancelledPairs() const {
+        return cancelledPairs;
+    }
+
+    inline unsigned long long getDroppedSetPoints() const {
+        return droppedSetPoints;
+    }
+
+    inline unsigned long long getMergedChanges() const {
+        return mergedChanges;
+    }
+
+    inline unsigned long long getRemovedCommands() const {
+        return removedCommands;
+    }
+
+protected:
+    typedef std::tuple<int, std::string, std::string> SetPointKey;
+
+    typedef struct PendingSetPoint_ {
+        SetPointKey key;
+        bool active;
+        std::vector<double> values;
+        unsigned int commands;
+    } PendingSetPoint;
+
+    bool keepLiteralStream;
+    bool holding;
+    std::map<SetPointKey, std::vector<double>> backendSetPoints;
+    std::vector<PendingSetPoint> pending;
+
+    unsigned long long cancelledPairs;
+    unsigned long long droppedSetPoints;
+    unsigned long long mergedChanges;
+    unsigned long long removedCommands;
+
+    void setPoint(int type, const std::string & source, const std::string & target, const std::vector<double> & values);
+    void stopSetPoint(int type, const std::string & source, const std::string & target = "");
+
+    void sendSetPoint(const SetPointKey & key, const std::vector<double> & values);
+    void sendStop(const SetPointKey & key);
+};
+
+#endif // COMMANDOPTIMIZINGACTUATORSINTERFACE_H
@@ -0,0 +1,96 @@
+#include "executioncheckpoint.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <cereal/archives/portable_binary.hpp>
+
+void ExecutionCheckpoint::apply(const ExecutionCheckpoint & record) throw(std::invalid_argument) {
+    if (readLogFrom != 0 || record.readLogFrom > readLog.size()) {
+        throw(std::invalid_argument("imposible to apply the checkpoint, its read log does not follow this one"));
+    }
+
+    elapsedSlices = record.elapsedSlices;
+    timeSlice = record.timeSlice;
+    elapsedTicks = record.elapsedTicks;
+    frontier = record.frontier;
+    activeCommands = record.activeCommands;
+    volumes = record.volumes;
+    variables = record.variables;
+
+    readLog.resize(record.readLogFrom);
+    readLog.insert(readLog.end(), record.readLog.begin(), record.readLog.end());
+}
+
+size_t ExecutionCheckpoint::save(const std::string & path) const throw(std::runtime_error) {
+    // written aside and renamed so a crash in the middle never leaves a truncated checkpoint
+    std::string tempPath = path + ".tmp";
+    size_t bytes = 0;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw(std::runtime_error("imposible to open " + tempPath));
+        }
+        cereal::PortableBinaryOutputArchive archive(out);
+        archive(*this);
+        bytes = (size_t) out.tellp();
+    }
+    std::remove(path.c_str());
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        throw(std::runtime_error("imposible to rename " + tempPath + " to " + path));
+    }
+    return bytes;
+}
+
+size_t ExecutionCheckpoint::append(const std::string & path) const throw(std::runtime_error) {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    if (!out.is_open()) {
+        throw(std::runtime_error("imposible to open " + path));
+    }
+    std::streampos start = out.tellp();
+    {
+        cereal::PortableBinaryOutputArchive archive(out);
+        archive(*this);
+    }
+    out.flush();
+    if (!out) {
+        throw(std::runtime_error("imposible to append to " + path));
+    }
+    return (size_t) (out.tellp() - start);
+}
+
+ExecutionCheckpoint ExecutionCheckpoint::load(const std::string & path) throw(std::invalid_argument) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        // a crash between remove and rename leaves only the aside copy
+        in.open(path + ".tmp", std::ios::binary);
+        if (!in.is_open()) {
+            throw(std::invalid_argument("imposible to open " + path));
+        }
+    }
+
+    ExecutionCheckpoint checkpoint;
+    try {
+        cereal::PortableBinaryInputArchive archive(in);
+        archive(checkpoint);
+    } catch (cereal::Exception & e) {
+        throw(std::invalid_argument("corrupted checkpoint " + path + ": " + e.what()));
+    }
+
+    std::ifstream journal(path + ".journal", std::ios::binary);
+    while(journal.is_open() && journal.peek() != std::ifstream::traits_type::eof()) {
+        ExecutionCheckpoint record;
+        try {
+            cereal::PortableBinaryInputArchive archive(journal);
+            archive(record);
+        } catch (cereal::Exception & e) {
+            // the last append did not finish, the checkpoint before it is the last one
+            break;
+        }
+        // a crash between writing a new base and removing the journal leaves records the base already has
+        if (record.elapsedSlices > checkpoint.elapsedSlices) {
+            checkpoint.apply(record);
+        }
+    }
+    return checkpoint;
+}
@@ -0,0 +1,107 @@
+#ifndef EXECUTIONCHECKPOINT_H
+#define EXECUTIONCHECKPOINT_H
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include "ticktimebase.h"
+
+/**
+ * An actuator command that is still in effect at checkpoint time: a loaded container, a set-point
+ * (flow, temperature, stir...), a running measurement or a transfer or mix still moving liquid. Values are
+ * stored in fixed units: ml, ml/h, Cº, Hz, nm, cd, V/cm and ms. A transfer keeps {volume, duration, elapsed}
+ * and a mix {volume1, volume2, duration, elapsed}, its second source in secondSource.
+ */
+struct ActiveCommand
+{
+    typedef enum CommandType_ {
+        load_container = 0,
+        light,
+        temperature,
+        stir,
+        centrifugate,
+        shake,
+        electrophoresis,
+        continuous_flow,
+        measure_od,
+        measure_temperature,
+        measure_luminiscense,
+        measure_volume,
+        measure_fluorescence,
+        transfer,
+        mix
+    } CommandType;
+
+    int type;
+    std::string source;
+    std::string target;
+    std::string secondSource;
+    std::vector<double> values;
+
+    template<class Archive>
+    void serialize(Archive & ar) {
+        ar(type, source, target, secondSource, values);
+    }
+};
+
+/**
+ * A value handed back to the graph by the backend (time steps and durations in ms, volumes in ml),
+ * repeated times times in a row.
+ */
+struct ReadLogEntry
+{
+    double value;
+    unsigned long long times;
+
+    template<class Archive>
+    void serialize(Archive & ar) {
+        ar(value, times);
+    }
+};
+
+/**
+ * Full state of an in-flight protocol execution: enough to resume it in a new process without sending again
+ * the commands already executed.
+ *
+ * volumes holds the volume of every loaded container at checkpoint time (ml), the one re-loaded on resume.
+ * readLog holds the values read by the graph from entry readLogFrom on, run-length encoded: a graph with no
+ * variable hooks is brought to the checkpoint by running it again with these answers and without touching
+ * the backend, so resuming it is a replay of the whole execution, only the instrument is spared.
+ *
+ * On disk a checkpoint is a base, written whole, and a journal next to it (path + ".journal") where the
+ * later checkpoints are appended with only the entries of the read log that changed since the previous one
+ * (readLogFrom > 0). load() applies the journal on the base; a record torn by a crash in the middle of an
+ * append is dropped, and so are the records of a journal older than its base.
+ */
+struct ExecutionCheckpoint
+{
+    unsigned long long elapsedSlices = 0;
+    TickTimebase::Ticks timeSlice = 0;
+    TickTimebase::Ticks elapsedTicks = 0;
+    std::vector<int> frontier;
+    std::vector<ActiveCommand> activeCommands;
+    std::map<std::string, double> volumes;
+    unsigned long long readLogFrom = 0;
+    std::vector<ReadLogEntry> readLog;
+    std::map<std::string, double> variables;
+
+    template<class Archive>
+    void serialize(Archive & ar) {
+        ar(elapsedSlices, timeSlice, elapsedTicks, frontier, activeCommands, volumes, readLogFrom, readLog, variables);
+    }
+
+    void apply(const ExecutionCheckpoint & record) throw(std::invalid_argument);
+
+    size_t save(const std::string & path) const throw(std::runtime_error);
+    size_t append(const std::string & path) const throw(std::runtime_error);
+    static ExecutionCheckpoint load(const std::string & path) throw(std::invalid_argument);
+};
+
+#endif // EXECUTIONCHECKPOINT_H
@@ -0,0 +1,126 @@
+#include "explorationactuatorsinterface.h"
+
+#include <algorithm>
+
+ExplorationActuatorsInterface::ExplorationActuatorsInterface(
+        ActuatorsExecutionInterface* actuatorInterface,
+        const std::map<std::string, std::vector<double>> & outcomes,
+        const std::vector<int> & prefix) :
+    ForwardingActuatorsInterface(actuatorInterface), outcomes(outcomes), choices(prefix)
+{
+    choiceMade = false;
+    lastChoice = 0;
+    sliceElapsed = false;
+    elapsedSlices = 0;
+}
+
+ExplorationActuatorsInterface::~ExplorationActuatorsInterface()
+{
+
+}
+
+void ExplorationActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    if (std::find(containers.begin(), containers.end(), sourceId) == containers.end()) {
+        containers.push_back(sourceId);
+    }
+    actuatorInterface->loadContainer(sourceId, initialVolume);
+}
+
+double ExplorationActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    double value;
+    if (choose("OD", sourceId, value)) {
+        return value;
+    }
+    return actuatorInterface->getMeasureOD(sourceId);
+}
+
+units::Temperature ExplorationActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    double value;
+    if (choose("Temperature", sourceId, value)) {
+        return value * units::C;
+    }
+    return actuatorInterface->getMeasureTemperature(sourceId);
+}
+
+units::LuminousIntensity ExplorationActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    double value;
+    if (choose("Luminiscense", sourceId, value)) {
+        return value * units::cd;
+    }
+    return actuatorInterface->getMeasureLuminiscense(sourceId);
+}
+
+units::Volume ExplorationActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    double value;
+    if (choose("Volume", sourceId, value)) {
+        return value * units::ml;
+    }
+    return actuatorInterface->getMeasureVolume(sourceId);
+}
+
+units::LuminousIntensity ExplorationActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    double value;
+    if (choose("Fluorescence", sourceId, value)) {
+        return value * units::cd;
+    }
+    return actuatorInterface->getMeasureFluorescence(sourceId);
+}
+
+units::Time ExplorationActuatorsInterface::timeStep() {
+    elapsedSlices++;
+    sliceElapsed = true;
+    return actuatorInterface->timeStep();
+}
+
+std::map<std::string, double> ExplorationActuatorsInterface::getVolumes() {
+    std::map<std::string, double> volumes;
+    for(const std::string & container: containers) {
+        volumes[container] = actuatorInterface->getVirtualVolume(container).to(units::ml);
+    }
+    return volumes;
+}
+
+std::vector<ExplorationActuatorsInterface::BranchingPoint> ExplorationActuatorsInterface::takeBranchingPoints() {
+    std::vector<BranchingPoint> points;
+    points.swap(newBranchingPoints);
+    return points;
+}
+
+bool ExplorationActuatorsInterface::takeChoiceMade(size_t & choice) {
+    bool made = choiceMade;
+    choice = lastChoice;
+    choiceMade = false;
+    return made;
+}
+
+bool ExplorationActuatorsInterface::takeSliceElapsed() {
+    bool elapsed = sliceElapsed;
+    sliceElapsed = false;
+    return elapsed;
+}
+
+bool ExplorationActuatorsInterface::choose(const std::string & measurement, const std::string & sourceId, double & value) {
+    auto it = outcomes.find(measurement);
+    if (it == outcomes.end() || it->second.empty()) {
+        return false;
+    }
+
+    size_t choice = values.size();
+    if (choice >= choices.size()) {
+        choices.push_back(0);
+        if (it->second.size() > 1) {
+            BranchingPoint point;
+            point.choice = choice;
+            point.outcomes = it->second.size();
+            newBranchingPoints.push_back(point);
+        }
+    }
+
+    value = it->second[choices[choice] % it->second.size()];
+    values.push_back(value);
+    lastValues[measurement + "(" + sourceId + ")"] = value;
+
+    choiceMade = true;
+    lastChoice = choice;
+    return true;
+}
@@ -0,0 +1,79 @@
+#ifndef EXPLORATIONACTUATORSINTERFACE_H
+#define EXPLORATIONACTUATORSINTERFACE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "forwardingactuatorsinterface.h"
+
+/**
+ * Interface used by BranchSpaceExplorer to drive one path of the exploration.
+ *
+ * The measurements with a set of outcomes do not read the wrapped interface: the n-th of those reads
+ * returns the outcome chosen by the n-th entry of the path prefix, and the first one after the prefix
+ * returns the first outcome and is reported as a new branching point. Measurements without outcomes and
+ * every other call go to the wrapped interface (a SimulatedActuatorsInterface that keeps the volumes).
+ */
+class ExplorationActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    typedef struct BranchingPoint_ {
+        size_t choice;
+        size_t outcomes;
+    } BranchingPoint;
+
+    ExplorationActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface,
+                                  const std::map<std::string, std::vector<double>> & outcomes,
+                                  const std::vector<int> & prefix);
+    virtual ~ExplorationActuatorsInterface();
+
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual double getMeasureOD(const std::string & sourceId);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual units::Time timeStep();
+
+    std::map<std::string, double> getVolumes();
+    std::vector<BranchingPoint> takeBranchingPoints();
+    bool takeChoiceMade(size_t & choice);
+    bool takeSliceElapsed();
+
+    inline const std::vector<int> & getChoices() const {
+        return choices;
+    }
+
+    inline const std::vector<double> & getValues() const {
+        return values;
+    }
+
+    inline const std::map<std::string, double> & getLastValues() const {
+        return lastValues;
+    }
+
+    inline unsigned long long getElapsedSlices() const {
+        return elapsedSlices;
+    }
+
+protected:
+    const std::map<std::string, std::vector<double>> & outcomes;
+    std::vector<int> choices;
+
+    std::vector<double> values;
+    std::map<std::string, double> lastValues;
+    std::vector<std::string> containers;
+    std::vector<BranchingPoint> newBranchingPoints;
+
+    bool choiceMade;
+    size_t lastChoice;
+    bool sliceElapsed;
+    unsigned long long elapsedSlices;
+
+    bool choose(const std::string & measurement, const std::string & sourceId, double & value);
+};
+
+#endif // EXPLORATIONACTUATORSINTERFACE_H
@@ -0,0 +1,176 @@
+#include "forwardingactuatorsinterface.h"
+
+ForwardingActuatorsInterface::ForwardingActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface) :
+    actuatorInterface(actuatorInterface)
+{
+
+}
+
+ForwardingActuatorsInterface::~ForwardingActuatorsInterface()
+{
+
+}
+
+void ForwardingActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {
+    actuatorInterface->applyLigth(sourceId, wavelength, intensity);
+}
+
+void ForwardingActuatorsInterface::stopApplyLigth(const std::string & sourceId) {
+    actuatorInterface->stopApplyLigth(sourceId);
+}
+
+void ForwardingActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {
+    actuatorInterface->applyTemperature(sourceId, temperature);
+}
+
+void ForwardingActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {
+    actuatorInterface->stopApplyTemperature(sourceId);
+}
+
+void ForwardingActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {
+    actuatorInterface->stir(idSource, intensity);
+}
+
+void ForwardingActuatorsInterface::stopStir(const std::string & idSource) {
+    actuatorInterface->stopStir(idSource);
+}
+
+void ForwardingActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {
+    actuatorInterface->centrifugate(idSource, intensity);
+}
+
+void ForwardingActuatorsInterface::stopCentrifugate(const std::string & idSource) {
+    actuatorInterface->stopCentrifugate(idSource);
+}
+
+void ForwardingActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {
+    actuatorInterface->shake(idSource, intensity);
+}
+
+void ForwardingActuatorsInterface::stopShake(const std::string & idSource) {
+    actuatorInterface->stopShake(idSource);
+}
+
+void ForwardingActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {
+    actuatorInterface->startElectrophoresis(idSource, fieldStrenght);
+}
+
+std::shared_ptr<ElectrophoresisResult> ForwardingActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    return actuatorInterface->stopElectrophoresis(idSource);
+}
+
+units::Volume ForwardingActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    return actuatorInterface->getVirtualVolume(sourceId);
+}
+
+void ForwardingActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    actuatorInterface->loadContainer(sourceId, initialVolume);
+}
+
+void ForwardingActuatorsInterface::startMeasureOD(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length wavelength)
+{
+    actuatorInterface->startMeasureOD(sourceId, measurementFrequency, wavelength);
+}
+
+double ForwardingActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    return actuatorInterface->getMeasureOD(sourceId);
+}
+
+void ForwardingActuatorsInterface::startMeasureTemperature(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    actuatorInterface->startMeasureTemperature(sourceId, measurementFrequency);
+}
+
+units::Temperature ForwardingActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    return actuatorInterface->getMeasureTemperature(sourceId);
+}
+
+void ForwardingActuatorsInterface::startMeasureLuminiscense(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    actuatorInterface->startMeasureLuminiscense(sourceId, measurementFrequency);
+}
+
+units::LuminousIntensity ForwardingActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    return actuatorInterface->getMeasureLuminiscense(sourceId);
+}
+
+void ForwardingActuatorsInterface::startMeasureVolume(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    actuatorInterface->startMeasureVolume(sourceId, measurementFrequency);
+}
+
+units::Volume ForwardingActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    return actuatorInterface->getMeasureVolume(sourceId);
+}
+
+void ForwardingActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+    actuatorInterface->startMeasureFluorescence(sourceId, measurementFrequency, excitation, emission);
+}
+
+units::LuminousIntensity ForwardingActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    return actuatorInterface->getMeasureFluorescence(sourceId);
+}
+
+units::Time ForwardingActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    return actuatorInterface->mix(idSource1, idSource2, idTarget, volume1, volume2);
+}
+
+void ForwardingActuatorsInterface::stopMix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget)
+{
+    actuatorInterface->stopMix(idSource1, idSource2, idTarget);
+}
+
+void ForwardingActuatorsInterface::setContinuosFlow(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volumetric_Flow rate)
+{
+    actuatorInterface->setContinuosFlow(idSource, idTarget, rate);
+}
+
+void ForwardingActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {
+    actuatorInterface->stopContinuosFlow(idSource, idTarget);
+}
+
+units::Time ForwardingActuatorsInterface::transfer(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volume volume)
+{
+    return actuatorInterface->transfer(idSource, idTarget, volume);
+}
+
+void ForwardingActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {
+    actuatorInterface->stopTransfer(idSource, idTarget);
+}
+
+void ForwardingActuatorsInterface::setTimeStep(units::Time time) {
+    actuatorInterface->setTimeStep(time);
+}
+
+units::Time ForwardingActuatorsInterface::timeStep() {
+    return actuatorInterface->timeStep();
+}
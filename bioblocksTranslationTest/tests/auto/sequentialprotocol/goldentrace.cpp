@@ -0,0 +1,95 @@
+#include "goldentrace.h"
+
+#include <fstream>
+#include <sstream>
+
+std::string GoldenTrace::compress(const std::string & trace) {
+    std::ostringstream compressed;
+
+    std::string last;
+    unsigned long long repetitions = 0;
+    std::istringstream in(trace);
+    std::string command;
+    while(true) {
+        bool more = (bool) std::getline(in, command, ';');
+        if (more && repetitions > 0 && command == last) {
+            repetitions++;
+            continue;
+        }
+
+        if (repetitions > 1) {
+            compressed << repetitions << "*";
+        }
+        if (repetitions > 0) {
+            compressed << last << ";\n";
+        }
+
+        if (!more) {
+            break;
+        }
+        last = command;
+        repetitions = 1;
+    }
+    return compressed.str();
+}
+
+std::string GoldenTrace::expand(const std::string & compressed) throw(std::invalid_argument) {
+    std::istringstream in(compressed);
+    GoldenTraceReader reader(in);
+
+    std::string trace;
+    std::string command;
+    while(reader.next(command)) {
+        trace += command + ";";
+    }
+    return trace;
+}
+
+void GoldenTrace::write(const std::string & trace, const std::string & path) throw(std::runtime_error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw(std::runtime_error("imposible to open " + path));
+    }
+    out << compress(trace);
+}
+
+GoldenTraceReader::GoldenTraceReader(std::istream & in) :
+    in(in)
+{
+    pendingRepetitions = 0;
+}
+
+GoldenTraceReader::~GoldenTraceReader()
+{
+
+}
+
+bool GoldenTraceReader::next(std::string & command) throw(std::invalid_argument) {
+    while(pendingRepetitions == 0) {
+        std::string token;
+        if (!std::getline(in, token, ';')) {
+            return false;
+        }
+
+        size_t first = token.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            continue;
+        }
+        token = token.substr(first);
+
+        pendingRepetitions = 1;
+        size_t star = token.find('*');
+        if (star != std::string::npos && star > 0 && token.find_first_not_of("0123456789") == star) {
+            pendingRepetitions = std::stoull(token.substr(0, star));
+            token = token.substr(star + 1);
+        }
+        if (pendingRepetitions == 0) {
+            throw(std::invalid_argument("golden trace with a run of zero commands: " + token));
+        }
+        this->command = token;
+    }
+
+    pendingRepetitions--;
+    command = this->command;
+    return true;
+}
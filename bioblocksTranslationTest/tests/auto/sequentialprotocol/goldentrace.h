@@ -0,0 +1,44 @@
+#ifndef GOLDENTRACE_H
+#define GOLDENTRACE_H
+
+#include <istream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Run-length compressed execution traces.
+ *
+ * A golden trace is the list of commands of StringActuatorsInterface, one per line, where a run of the
+ * same command repeated N times is written once as "N*command;". Long runs of timeStep(); are what makes
+ * expected traces big, so weeks of simulated time fit in a few lines.
+ */
+class GoldenTrace
+{
+public:
+    static std::string compress(const std::string & trace);
+    static std::string expand(const std::string & compressed) throw(std::invalid_argument);
+
+    static void write(const std::string & trace, const std::string & path) throw(std::runtime_error);
+
+private:
+    GoldenTrace() {}
+};
+
+/**
+ * Reads the commands of a golden trace one at a time, expanding the runs on the fly.
+ */
+class GoldenTraceReader
+{
+public:
+    GoldenTraceReader(std::istream & in);
+    virtual ~GoldenTraceReader();
+
+    bool next(std::string & command) throw(std::invalid_argument);
+
+protected:
+    std::istream & in;
+    std::string command;
+    unsigned long long pendingRepetitions;
+};
+
+#endif // GOLDENTRACE_H
@@ -0,0 +1,454 @@
+#include "lazybranchactuatorsinterface.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+/** containers and values of a call, the values in the fixed units of ActiveCommand, so replays are matched on every argument */
+std::string describe(const std::string & containers, std::initializer_list<double> values) {
+    std::ostringstream stream;
+    stream << std::setprecision(17) << containers;
+    for(double value: values) {
+        stream << "," << value;
+    }
+    return stream.str();
+}
+
+}
+
+LazyBranchActuatorsInterface::LazyBranchActuatorsInterface(
+        ActuatorsExecutionInterface* actuatorInterface,
+        const LazyBranchTranslator* translator) :
+    ForwardingActuatorsInterface(actuatorInterface), translator(translator)
+{
+    replayed = 0;
+    replayedTimes = 0;
+    replayedCalls = 0;
+    elapsed = 0;
+    dropped = false;
+}
+
+LazyBranchActuatorsInterface::~LazyBranchActuatorsInterface()
+{
+
+}
+
+void LazyBranchActuatorsInterface::startReplay() {
+    replayed = 0;
+    replayedTimes = 0;
+    elapsed = 0;
+}
+
+void LazyBranchActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {
+    std::string arguments = describe(sourceId, {wavelength.to(units::nm), intensity.to(units::cd)});
+    if (replay("applyLigth", arguments)) {
+        return;
+    }
+    checkMarker(sourceId);
+    actuatorInterface->applyLigth(sourceId, wavelength, intensity);
+    record("applyLigth", arguments);
+}
+
+void LazyBranchActuatorsInterface::stopApplyLigth(const std::string & sourceId) {
+    if (replay("stopApplyLigth", sourceId)) {
+        return;
+    }
+    checkMarker(sourceId);
+    actuatorInterface->stopApplyLigth(sourceId);
+    record("stopApplyLigth", sourceId);
+}
+
+void LazyBranchActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {
+    std::string arguments = describe(sourceId, {temperature.to(units::C)});
+    if (replay("applyTemperature", arguments)) {
+        return;
+    }
+    checkMarker(sourceId);
+    actuatorInterface->applyTemperature(sourceId, temperature);
+    record("applyTemperature", arguments);
+}
+
+void LazyBranchActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {
+    if (replay("stopApplyTemperature", sourceId)) {
+        return;
+    }
+    checkMarker(sourceId);
+    actuatorInterface->stopApplyTemperature(sourceId);
+    record("stopApplyTemperature", sourceId);
+}
+
+void LazyBranchActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {
+    std::string arguments = describe(idSource, {intensity.to(units::Hz)});
+    if (replay("stir", arguments)) {
+        return;
+    }
+    checkMarker(idSource);
+    actuatorInterface->stir(idSource, intensity);
+    record("stir", arguments);
+}
+
+void LazyBranchActuatorsInterface::stopStir(const std::string & idSource) {
+    if (replay("stopStir", idSource)) {
+        return;
+    }
+    checkMarker(idSource);
+    actuatorInterface->stopStir(idSource);
+    record("stopStir", idSource);
+}
+
+void LazyBranchActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {
+    std::string arguments = describe(idSource, {intensity.to(units::Hz)});
+    if (replay("centrifugate", arguments)) {
+        return;
+    }
+    checkMarker(idSource);
+    actuatorInterface->centrifugate(idSource, intensity);
+    record("centrifugate", arguments);
+}
+
+void LazyBranchActuatorsInterface::stopCentrifugate(const std::string & idSource) {
+    if (replay("stopCentrifugate", idSource)) {
+        return;
+    }
+    checkMarker(idSource);
+    actuatorInterface->stopCentrifugate(idSource);
+    record("stopCentrifugate", idSource);
+}
+
+void LazyBranchActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {
+    std::string arguments = describe(idSource, {intensity.to(units::Hz)});
+    if (replay("shake", arguments)) {
+        return;
+    }
+    checkMarker(idSource);
+    actuatorInterface->shake(idSource, intensity);
+    record("shake", arguments);
+}
+
+void LazyBranchActuatorsInterface::stopShake(const std::string & idSource) {
+    if (replay("stopShake", idSource)) {
+        return;
+    }
+    checkMarker(idSource);
+    actuatorInterface->stopShake(idSource);
+    record("stopShake", idSource);
+}
+
+void LazyBranchActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {
+    std::string arguments = describe(idSource, {fieldStrenght.to(units::V / units::cm)});
+    if (replay("startElectrophoresis", arguments)) {
+        return;
+    }
+    checkMarker(idSource);
+    actuatorInterface->startElectrophoresis(idSource, fieldStrenght);
+    record("startElectrophoresis", arguments);
+}
+
+std::shared_ptr<ElectrophoresisResult> LazyBranchActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    const RecordedCall* recorded = replay("stopElectrophoresis", idSource);
+    if (recorded) {
+        return recorded->result;
+    }
+    checkMarker(idSource);
+    std::shared_ptr<ElectrophoresisResult> result = actuatorInterface->stopElectrophoresis(idSource);
+    record("stopElectrophoresis", idSource, 0, result);
+    return result;
+}
+
+units::Volume LazyBranchActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    const RecordedCall* recorded = replay("getVirtualVolume", sourceId);
+    if (recorded) {
+        return recorded->value * units::ml;
+    }
+    checkMarker(sourceId);
+    units::Volume value = actuatorInterface->getVirtualVolume(sourceId);
+    record("getVirtualVolume", sourceId, value.to(units::ml));
+    return value;
+}
+
+void LazyBranchActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    if (translator->markerBranch(sourceId) != -1 || !loadedContainers.insert(sourceId).second) {
+        return;
+    }
+    actuatorInterface->loadContainer(sourceId, initialVolume);
+}
+
+void LazyBranchActuatorsInterface::startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength) {
+    std::string arguments = describe(sourceId, {measurementFrequency.to(units::Hz), wavelength.to(units::nm)});
+    if (replay("startMeasureOD", arguments)) {
+        return;
+    }
+    checkMarker(sourceId);
+    actuatorInterface->startMeasureOD(sourceId, measurementFrequency, wavelength);
+    record("startMeasureOD", arguments);
+}
+
+double LazyBranchActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    const RecordedCall* recorded = replay("getMeasureOD", sourceId);
+    if (recorded) {
+        return recorded->value;
+    }
+    checkMarker(sourceId);
+    double value = actuatorInterface->getMeasureOD(sourceId);
+    record("getMeasureOD", sourceId, value);
+    return value;
+}
+
+void LazyBranchActuatorsInterface::startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency) {
+    std::string arguments = describe(sourceId, {measurementFrequency.to(units::Hz)});
+    if (replay("startMeasureTemperature", arguments)) {
+        return;
+    }
+    checkMarker(sourceId);
+    actuatorInterface->startMeasureTemperature(sourceId, measurementFrequency);
+    record("startMeasureTemperature", arguments);
+}
+
+units::Temperature LazyBranchActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    const RecordedCall* recorded = replay("getMeasureTemperature", sourceId);
+    if (recorded) {
+        return recorded->value * units::C;
+    }
+    checkMarker(sourceId);
+    units::Temperature value = actuatorInterface->getMeasureTemperature(sourceId);
+    record("getMeasureTemperature", sourceId, value.to(units::C));
+    return value;
+}
+
+void LazyBranchActuatorsInterface::startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency) {
+    std::string arguments = describe(sourceId, {measurementFrequency.to(units::Hz)});
+    if (replay("startMeasureLuminiscense", arguments)) {
+        return;
+    }
+    checkMarker(sourceId);
+    actuatorInterface->startMeasureLuminiscense(sourceId, measurementFrequency);
+    record("startMeasureLuminiscense", arguments);
+}
+
+units::LuminousIntensity LazyBranchActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    const RecordedCall* recorded = replay("getMeasureLuminiscense", sourceId);
+    if (recorded) {
+        return recorded->value * units::cd;
+    }
+    checkMarker(sourceId);
+    units::LuminousIntensity value = actuatorInterface->getMeasureLuminiscense(sourceId);
+    record("getMeasureLuminiscense", sourceId, value.to(units::cd));
+    return value;
+}
+
+void LazyBranchActuatorsInterface::startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency) {
+    std::string arguments = describe(sourceId, {measurementFrequency.to(units::Hz)});
+    if (replay("startMeasureVolume", arguments)) {
+        return;
+    }
+    checkMarker(sourceId);
+    actuatorInterface->startMeasureVolume(sourceId, measurementFrequency);
+    record("startMeasureVolume", arguments);
+}
+
+units::Volume LazyBranchActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    const RecordedCall* recorded = replay("getMeasureVolume", sourceId);
+    if (recorded) {
+        return recorded->value * units::ml;
+    }
+    checkMarker(sourceId);
+    units::Volume value = actuatorInterface->getMeasureVolume(sourceId);
+    record("getMeasureVolume", sourceId, value.to(units::ml));
+    return value;
+}
+
+void LazyBranchActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+    std::string arguments = describe(sourceId, {measurementFrequency.to(units::Hz), excitation.to(units::nm), emission.to(units::nm)});
+    if (replay("startMeasureFluorescence", arguments)) {
+        return;
+    }
+    checkMarker(sourceId);
+    actuatorInterface->startMeasureFluorescence(sourceId, measurementFrequency, excitation, emission);
+    record("startMeasureFluorescence", arguments);
+}
+
+units::LuminousIntensity LazyBranchActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    const RecordedCall* recorded = replay("getMeasureFluorescence", sourceId);
+    if (recorded) {
+        return recorded->value * units::cd;
+    }
+    checkMarker(sourceId);
+    units::LuminousIntensity value = actuatorInterface->getMeasureFluorescence(sourceId);
+    record("getMeasureFluorescence", sourceId, value.to(units::cd));
+    return value;
+}
+
+void LazyBranchActuatorsInterface::setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate) {
+    std::string arguments = describe(idSource + "," + idTarget, {rate.to(units::ml / units::hr)});
+    if (replay("setContinuosFlow", arguments)) {
+        return;
+    }
+    checkMarker(idSource);
+    checkMarker(idTarget);
+    actuatorInterface->setContinuosFlow(idSource, idTarget, rate);
+    record("setContinuosFlow", arguments);
+}
+
+void LazyBranchActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {
+    std::string arguments = idSource + "," + idTarget;
+    if (replay("stopContinuosFlow", arguments)) {
+        return;
+    }
+    checkMarker(idSource);
+    checkMarker(idTarget);
+    actuatorInterface->stopContinuosFlow(idSource, idTarget);
+    record("stopContinuosFlow", arguments);
+}
+
+units::Time LazyBranchActuatorsInterface::transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume) {
+    std::string arguments = describe(idSource + "," + idTarget, {volume.to(units::ml)});
+    const RecordedCall* recorded = replay("transfer", arguments);
+    if (recorded) {
+        return recorded->value * units::ms;
+    }
+    checkMarker(idSource);
+    checkMarker(idTarget);
+    units::Time value = actuatorInterface->transfer(idSource, idTarget, volume);
+    record("transfer", arguments, value.to(units::ms));
+    return value;
+}
+
+void LazyBranchActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {
+    std::string arguments = idSource + "," + idTarget;
+    if (replay("stopTransfer", arguments)) {
+        return;
+    }
+    checkMarker(idSource);
+    checkMarker(idTarget);
+    actuatorInterface->stopTransfer(idSource, idTarget);
+    record("stopTransfer", arguments);
+}
+
+units::Time LazyBranchActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    std::string arguments = describe(idSource1 + "," + idSource2 + "," + idTarget, {volume1.to(units::ml), volume2.to(units::ml)});
+    const RecordedCall* recorded = replay("mix", arguments);
+    if (recorded) {
+        return recorded->value * units::ms;
+    }
+    checkMarker(idSource1);
+    checkMarker(idSource2);
+    checkMarker(idTarget);
+    units::Time value = actuatorInterface->mix(idSource1, idSource2, idTarget, volume1, volume2);
+    record("mix", arguments, value.to(units::ms));
+    return value;
+}
+
+void LazyBranchActuatorsInterface::stopMix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget)
+{
+    std::string arguments = idSource1 + "," + idSource2 + "," + idTarget;
+    if (replay("stopMix", arguments)) {
+        return;
+    }
+    checkMarker(idSource1);
+    checkMarker(idSource2);
+    checkMarker(idTarget);
+    actuatorInterface->stopMix(idSource1, idSource2, idTarget);
+    record("stopMix", arguments);
+}
+
+void LazyBranchActuatorsInterface::setTimeStep(units::Time time) {
+    std::string arguments = describe("", {time.to(units::ms)});
+    if (replay("setTimeStep", arguments)) {
+        return;
+    }
+    actuatorInterface->setTimeStep(time);
+    record("setTimeStep", arguments, time.to(units::ms));
+}
+
+units::Time LazyBranchActuatorsInterface::timeStep() {
+    const RecordedCall* recorded = replay("timeStep", "");
+    if (recorded) {
+        elapsed = TickTimebase::add(elapsed, TickTimebase::fromTime(recorded->value * units::ms));
+        return recorded->value * units::ms;
+    }
+    units::Time slice = actuatorInterface->timeStep();
+    elapsed = TickTimebase::add(elapsed, TickTimebase::fromTime(slice));
+    record("timeStep", "", slice.to(units::ms));
+    return slice;
+}
+
+const LazyBranchActuatorsInterface::RecordedCall* LazyBranchActuatorsInterface::replay(
+        const std::string & name,
+        const std::string & arguments) throw(std::runtime_error)
+{
+    if (!isReplaying()) {
+        return nullptr;
+    }
+
+    const RecordedCall & recorded = calls[replayed];
+    if (recorded.name != name || recorded.arguments != arguments) {
+        throw(std::runtime_error("imposible to splice the branch, call " + std::to_string(replayedCalls) + " was " +
+                                 recorded.name + "(" + recorded.arguments + ") and now is " + name + "(" + arguments + ")"));
+    }
+
+    replayedTimes++;
+    if (replayedTimes == recorded.times) {
+        replayed++;
+        replayedTimes = 0;
+    }
+    replayedCalls++;
+    return &recorded;
+}
+
+void LazyBranchActuatorsInterface::checkMarker(const std::string & containerId) const throw(BranchTaken, std::runtime_error) {
+    int branch = translator->markerBranch(containerId);
+    if (branch != -1 && dropped) {
+        throw(std::runtime_error("imposible to take branch " + std::to_string(branch) +
+                                 ", it was unreachable and the executed prefix has been dropped"));
+    } else if (branch != -1) {
+        throw(BranchTaken(branch));
+    }
+}
+
+void LazyBranchActuatorsInterface::record(
+        const std::string & name,
+        const std::string & arguments,
+        double value,
+        std::shared_ptr<ElectrophoresisResult> result)
+{
+    if (dropped || !translator->hasReachableBranches(elapsed)) {
+        // no branch left to expand, the graph will not be translated again and the prefix will not be replayed
+        calls.clear();
+        replayed = 0;
+        replayedTimes = 0;
+        dropped = true;
+        return;
+    }
+
+    // a slice after another with the same answers is one entry, as in the read log of a checkpoint
+    if (!calls.empty() && !result && !calls.back().result &&
+        calls.back().name == name && calls.back().arguments == arguments && calls.back().value == value)
+    {
+        calls.back().times++;
+    } else {
+        RecordedCall call;
+        call.name = name;
+        call.arguments = arguments;
+        call.value = value;
+        call.times = 1;
+        call.result = result;
+        calls.push_back(call);
+    }
+    replayed = calls.size();
+    replayedTimes = 0;
+}
@@ -0,0 +1,152 @@
+#ifndef LAZYBRANCHACTUATORSINTERFACE_H
+#define LAZYBRANCHACTUATORSINTERFACE_H
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "forwardingactuatorsinterface.h"
+#include "lazybranchtranslator.h"
+
+/**
+ * Interface used by LazyProtocolExecutor between the graphs translated by a LazyBranchTranslator and the
+ * real backend.
+ *
+ * Every forwarded call is recorded with its arguments and the value it returned, run-length encoded so a
+ * long run of identical slices is a single entry. When a command reaches a branch marker a BranchTaken
+ * exception stops the execution before anything of the branch is sent. After startReplay() the recorded
+ * calls are not sent again: the new graph is executed up to the same point getting the recorded values
+ * back, and a call that differs from the recorded one in any argument means the new graph does not share
+ * the executed prefix. Containers are loaded once, in the order the graphs ask for them. The time steps
+ * returned by the backend give the elapsed time; once no deferred branch left can be reached by then (see
+ * LazyBranchTranslator::hasReachableBranches) the graph will not be translated again, the recorded calls
+ * are dropped and nothing else is recorded.
+ */
+class LazyBranchActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    class BranchTaken : public std::runtime_error
+    {
+    public:
+        BranchTaken(int branch) :
+            std::runtime_error("branch " + std::to_string(branch) + " taken"), branch(branch)
+        {
+
+        }
+
+        inline int getBranch() const {
+            return branch;
+        }
+
+    protected:
+        int branch;
+    };
+
+    LazyBranchActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface, const LazyBranchTranslator* translator);
+    virtual ~LazyBranchActuatorsInterface();
+
+    void startReplay();
+
+    virtual void applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity);
+    virtual void stopApplyLigth(const std::string & sourceId);
+
+    virtual void applyTemperature(const std::string & sourceId, units::Temperature temperature);
+    virtual void stopApplyTemperature(const std::string & sourceId);
+
+    virtual void stir(const std::string & idSource, units::Frequency intensity);
+    virtual void stopStir(const std::string & idSource);
+
+    virtual void centrifugate(const std::string & idSource, units::Frequency intensity);
+    virtual void stopCentrifugate(const std::string & idSource);
+
+    virtual void shake(const std::string & idSource, units::Frequency intensity);
+    virtual void stopShake(const std::string & idSource);
+
+    virtual void startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght);
+    virtual std::shared_ptr<ElectrophoresisResult> stopElectrophoresis(const std::string & idSource);
+
+    virtual units::Volume getVirtualVolume(const std::string & sourceId);
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual void startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength);
+    virtual double getMeasureOD(const std::string & sourceId);
+
+    virtual void startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+
+    virtual void startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+
+    virtual void startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+
+    virtual void startMeasureFluorescence(const std::string & sourceId,
+                                          units::Frequency measurementFrequency,
+                                          units::Length excitation,
+                                          units::Length emission);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual void setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate);
+    virtual void stopContinuosFlow(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume);
+    virtual void stopTransfer(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time mix(const std::string & idSource1,
+                            const std::string & idSource2,
+                            const std::string & idTarget,
+                            units::Volume volume1,
+                            units::Volume volume2);
+
+    virtual void stopMix(const std::string & idSource1,
+                         const std::string & idSource2,
+                         const std::string & idTarget);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    inline bool isReplaying() const {
+        return replayed < calls.size();
+    }
+
+    inline size_t getRecordedCalls() const {
+        return calls.size();
+    }
+
+    inline unsigned long long getReplayedCalls() const {
+        return replayedCalls;
+    }
+
+    inline bool isRecordingDropped() const {
+        return dropped;
+    }
+
+protected:
+    typedef struct RecordedCall_ {
+        std::string name;
+        std::string arguments;
+        double value;
+        unsigned long long times;
+        std::shared_ptr<ElectrophoresisResult> result;
+    } RecordedCall;
+
+    const LazyBranchTranslator* translator;
+
+    std::vector<RecordedCall> calls;
+    size_t replayed;
+    unsigned long long replayedTimes;
+    unsigned long long replayedCalls;
+    std::set<std::string> loadedContainers;
+    TickTimebase::Ticks elapsed;
+    bool dropped;
+
+    const RecordedCall* replay(const std::string & name, const std::string & arguments) throw(std::runtime_error);
+    void checkMarker(const std::string & containerId) const throw(BranchTaken, std::runtime_error);
+    void record(const std::string & name,
+                const std::string & arguments,
+                double value = 0,
+                std::shared_ptr<ElectrophoresisResult> result = std::shared_ptr<ElectrophoresisResult>());
+};
+
+#endif // LAZYBRANCHACTUATORSINTERFACE_H
@@ -0,0 +1,419 @@
+#include "lazybranchtranslator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+
+#include "protocolanalyzer.h"
+
+namespace {
+
+unsigned int countRenderedBlocks(const std::string & text) {
+    static const std::string key = "\"block_type\"";
+    unsigned int blocks = 0;
+    for(size_t pos = text.find(key); pos != std::string::npos; pos = text.find(key, pos + key.size())) {
+        blocks++;
+    }
+    return blocks;
+}
+
+}
+
+LazyBranchTranslator::LazyBranchTranslator(
+        const std::string & path,
+        const std::string & translatedPath,
+        units::Time timeSlice,
+        const std::string & markerPrefix) throw(std::invalid_argument) :
+    translatedPath(translatedPath), timeSlice(timeSlice), markerPrefix(markerPrefix)
+{
+    translations = 0;
+    translatedBlocks = 0;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw(std::invalid_argument("imposible to open " + path));
+    }
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    std::vector<JsonNode> nodes;
+    size_t pos = 0;
+    try {
+        int root = scanValue(pos, nodes);
+        collectBranches(nodes, root, -1);
+        protocolBlocks = countBlocks(nodes, root);
+        computeDeadlines(path, nodes, root);
+    } catch (std::invalid_argument & e) {
+        throw(std::invalid_argument("error scanning " + path + ": " + e.what()));
+    }
+}
+
+LazyBranchTranslator::~LazyBranchTranslator()
+{
+
+}
+
+std::shared_ptr<ProtocolGraph> LazyBranchTranslator::translate() throw(std::invalid_argument) {
+    std::ofstream out(translatedPath, std::ios::binary);
+    if (!out.is_open()) {
+        throw(std::invalid_argument("imposible to open " + translatedPath));
+    }
+    std::string rendered = render();
+    out << rendered;
+    out.close();
+
+    translations++;
+    translatedBlocks += countRenderedBlocks(rendered);
+    BioBlocksTranslator translator(timeSlice, translatedPath);
+    return translator.translateFile();
+}
+
+std::string LazyBranchTranslator::render() const {
+    std::string out;
+    out.reserve(content.size());
+    renderSpan(out, 0, content.size(), topBranches);
+    return out;
+}
+
+void LazyBranchTranslator::expand(int branch) throw(std::invalid_argument) {
+    if (branch < 0 || branch >= (int) branches.size()) {
+        throw(std::invalid_argument("imposible to expand unknown branch " + std::to_string(branch)));
+    }
+    for(int current = branch; current != -1; current = branches[current].parent) {
+        if (branches[current].deferred) {
+            expanded.insert(current);
+        }
+    }
+}
+
+bool LazyBranchTranslator::hasReachableBranches(TickTimebase::Ticks elapsed) const {
+    for(int branch = 0; branch < (int) branches.size(); branch++) {
+        if (!branches[branch].deferred || isExpanded(branch)) {
+            continue;
+        }
+
+        // a branch inside a deferred branch not taken yet is reached only through it
+        bool reachable = true;
+        for(int current = branch; current != -1 && reachable; current = branches[current].parent) {
+            if (branches[current].deferred && !isExpanded(current)) {
+                reachable = branches[current].deadline >= elapsed;
+            }
+        }
+        if (reachable) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int LazyBranchTranslator::markerBranch(const std::string & containerId) const {
+    if (containerId.compare(0, markerPrefix.size(), markerPrefix) != 0) {
+        return -1;
+    }
+
+    int branch = 0;
+    size_t pos = markerPrefix.size();
+    if (pos == containerId.size() || !std::isdigit((unsigned char) containerId[pos])) {
+        return -1;
+    }
+    for(; pos < containerId.size() && std::isdigit((unsigned char) containerId[pos]); pos++) {
+        branch = branch * 10 + (containerId[pos] - '0');
+    }
+    return branch < (int) branches.size() ? branch : -1;
+}
+
+int LazyBranchTranslator::scanValue(size_t & pos, std::vector<JsonNode> & nodes) const throw(std::invalid_argument) {
+    skipSpaces(pos);
+    if (pos >= content.size()) {
+        throw(std::invalid_argument("unexpected end of file"));
+    }
+
+    int node = nodes.size();
+    nodes.push_back(JsonNode());
+    nodes[node].begin = pos;
+
+    char c = content[pos];
+    if (c == '{') {
+        pos++;
+        skipSpaces(pos);
+        while (pos < content.size() && content[pos] != '}') {
+            std::string key;
+            scanString(pos, key);
+            skipSpaces(pos);
+            if (pos >= content.size() || content[pos] != ':') {
+                throw(std::invalid_argument("expected ':' at byte " + std::to_string(pos)));
+            }
+            pos++;
+            int value = scanValue(pos, nodes);
+            nodes[node].members.push_back(std::make_pair(key, value));
+
+            skipSpaces(pos);
+            if (pos < content.size() && content[pos] == ',') {
+                pos++;
+                skipSpaces(pos);
+            }
+        }
+        pos++;
+    } else if (c == '[') {
+        pos++;
+        skipSpaces(pos);
+        while (pos < content.size() && content[pos] != ']') {
+            int value = scanValue(pos, nodes);
+            nodes[node].items.push_back(value);
+
+            skipSpaces(pos);
+            if (pos < content.size() && content[pos] == ',') {
+                pos++;
+            }
+            skipSpaces(pos);
+        }
+        pos++;
+    } else if (c == '"') {
+        std::string text;
+        scanString(pos, text);
+        nodes[node].text = text;
+    } else {
+        while (pos < content.size() && content[pos] != ',' && content[pos] != '}' && content[pos] != ']' &&
+               !std::isspace((unsigned char) content[pos]))
+        {
+            pos++;
+        }
+    }
+
+    if (pos > content.size()) {
+        throw(std::invalid_argument("unexpected end of file"));
+    }
+    nodes[node].end = pos;
+    return node;
+}
+
+void LazyBranchTranslator::scanString(size_t & pos, std::string & text) const throw(std::invalid_argument) {
+    if (pos >= content.size() || content[pos] != '"') {
+        throw(std::invalid_argument("expected string at byte " + std::to_string(pos)));
+    }
+    for(pos++; pos < content.size() && content[pos] != '"'; pos++) {
+        if (content[pos] == '\\') {
+            pos++;
+        }
+        if (pos < content.size()) {
+            text.push_back(content[pos]);
+        }
+    }
+    if (pos >= content.size()) {
+        throw(std::invalid_argument("unterminated string"));
+    }
+    pos++;
+}
+
+void LazyBranchTranslator::skipSpaces(size_t & pos) const {
+    while (pos < content.size() && std::isspace((unsigned char) content[pos])) {
+        pos++;
+    }
+}
+
+int LazyBranchTranslator::member(const std::vector<JsonNode> & nodes, int node, const std::string & key) const {
+    for(const std::pair<std::string, int> & value: nodes[node].members) {
+        if (value.first == key) {
+            return value.second;
+        }
+    }
+    return -1;
+}
+
+void LazyBranchTranslator::collectBranches(const std::vector<JsonNode> & nodes, int node, int parent) {
+    int blockType = member(nodes, node, "block_type");
+    int branchesNode = member(nodes, node, "branches");
+    bool isIf = blockType != -1 && nodes[blockType].text == "controls_if" && branchesNode != -1;
+
+    for(const std::pair<std::string, int> & value: nodes[node].members) {
+        if (!isIf || value.second != branchesNode) {
+            collectBranches(nodes, value.second, parent);
+            continue;
+        }
+
+        for(int branchNode: nodes[branchesNode].items) {
+            int body = member(nodes, branchNode, "nestedOp");
+            int condition = member(nodes, branchNode, "condition");
+            if (condition != -1) {
+                collectBranches(nodes, condition, parent);
+            }
+            if (body == -1 || nodes[body].items.empty()) {
+                continue;
+            }
+
+            int branch = branches.size();
+            branches.push_back(BranchSpan());
+            branches[branch].begin = nodes[body].begin;
+            branches[branch].end = nodes[body].end;
+            branches[branch].ifBegin = nodes[node].begin;
+            branches[branch].parent = parent;
+            branches[branch].blocks = countBlocks(nodes, body);
+            branches[branch].deadline = TickTimebase::UNBOUNDED;
+            collectContainers(nodes, body, branches[branch]);
+
+            // the marker is a continuous_flow, its containerList, its rate and its containers
+            size_t markerBlocks = 4 + std::max<size_t>(branches[branch].containers.size(), 1);
+            branches[branch].deferred = branches[branch].blocks > markerBlocks;
+
+            if (parent == -1) {
+                topBranches.push_back(branch);
+            } else {
+                branches[parent].children.push_back(branch);
+            }
+            collectBranches(nodes, body, branch);
+        }
+    }
+
+    for(int item: nodes[node].items) {
+        collectBranches(nodes, item, parent);
+    }
+}
+
+void LazyBranchTranslator::collectContainers(const std::vector<JsonNode> & nodes, int node, BranchSpan & branch) const {
+    int blockType = member(nodes, node, "block_type");
+    int name = member(nodes, node, "containerName");
+    if (blockType != -1 && nodes[blockType].text == "container" && name != -1) {
+        const std::string & containerName = nodes[name].text;
+        for(const std::string & known: branch.containerNames) {
+            if (known == containerName) {
+                return;
+            }
+        }
+        branch.containerNames.push_back(containerName);
+        branch.containers.push_back(content.substr(nodes[node].begin, nodes[node].end - nodes[node].begin));
+        return;
+    }
+
+    for(const std::pair<std::string, int> & value: nodes[node].members) {
+        collectContainers(nodes, value.second, branch);
+    }
+    for(int item: nodes[node].items) {
+        collectContainers(nodes, item, branch);
+    }
+}
+
+void LazyBranchTranslator::collectIfs(const std::vector<JsonNode> & nodes, int node, std::vector<size_t> & ifs) const {
+    // same order as ProtocolAnalyzer visits the blocks
+    if (!nodes[node].items.empty()) {
+        for(int item: nodes[node].items) {
+            collectIfs(nodes, item, ifs);
+        }
+        return;
+    }
+
+    int blockType = member(nodes, node, "block_type");
+    if (blockType == -1) {
+        return;
+    }
+
+    int branchesNode = member(nodes, node, "branches");
+    if (nodes[blockType].text == "controls_if") {
+        ifs.push_back(nodes[node].begin);
+        if (branchesNode != -1) {
+            for(int branchNode: nodes[branchesNode].items) {
+                int body = member(nodes, branchNode, "nestedOp");
+                if (body != -1) {
+                    collectIfs(nodes, body, ifs);
+                }
+            }
+        }
+        int elseNode = member(nodes, node, "else");
+        if (elseNode != -1) {
+            collectIfs(nodes, elseNode, ifs);
+        }
+    } else if (nodes[blockType].text == "controls_whileUntil" && branchesNode != -1) {
+        collectIfs(nodes, branchesNode, ifs);
+    }
+}
+
+unsigned int LazyBranchTranslator::countBlocks(const std::vector<JsonNode> & nodes, int node) const {
+    unsigned int blocks = member(nodes, node, "block_type") != -1 ? 1 : 0;
+    for(const std::pair<std::string, int> & value: nodes[node].members) {
+        blocks += countBlocks(nodes, value.second);
+    }
+    for(int item: nodes[node].items) {
+        blocks += countBlocks(nodes, item);
+    }
+    return blocks;
+}
+
+void LazyBranchTranslator::computeDeadlines(const std::string & path, const std::vector<JsonNode> & nodes, int root) {
+    int linkedBlocks = member(nodes, root, "linkedBlocks");
+    if (linkedBlocks == -1) {
+        return;
+    }
+    std::vector<size_t> ifs;
+    for(int track: nodes[linkedBlocks].items) {
+        collectIfs(nodes, track, ifs);
+    }
+
+    ProtocolAnalyzer::ProtocolAnalysis analysis;
+    try {
+        ProtocolAnalyzer analyzer;
+        analysis = analyzer.analyzeFile(path);
+    } catch (std::invalid_argument & e) {
+        // without an analysis no branch has a deadline and the prefix is kept until all are expanded
+        return;
+    }
+
+    std::vector<unsigned int> linkedBefore(analysis.operations.size(), 0);
+    std::vector<int> ifOperations;
+    for(const ProtocolAnalyzer::AnalyzedOperation & operation: analysis.operations) {
+        if (operation.predecessor != -1) {
+            linkedBefore[operation.id] = linkedBefore[operation.predecessor] + 1;
+        } else if (operation.parent != -1) {
+            linkedBefore[operation.id] = linkedBefore[operation.parent] + 1;
+        }
+        if (operation.blockType == "controls_if") {
+            ifOperations.push_back(operation.id);
+        }
+    }
+    if (ifOperations.size() != ifs.size()) {
+        return;
+    }
+
+    TickTimebase::Ticks slice = TickTimebase::fromTime(timeSlice);
+    for(BranchSpan & branch: branches) {
+        for(size_t i = 0; i < ifs.size(); i++) {
+            const ProtocolAnalyzer::AnalyzedOperation & operation = analysis.operations[ifOperations[i]];
+            if (ifs[i] == branch.ifBegin && operation.maxStart != TickTimebase::UNBOUNDED) {
+                branch.deadline = TickTimebase::add(operation.maxStart, TickTimebase::multiply(slice, linkedBefore[operation.id] + 1));
+            }
+        }
+    }
+}
+
+void LazyBranchTranslator::renderSpan(std::string & out, size_t begin, size_t end, const std::vector<int> & children) const {
+    size_t cursor = begin;
+    for(int child: children) {
+        out.append(content, cursor, branches[child].begin - cursor);
+        if (isExpanded(child) || !branches[child].deferred) {
+            renderSpan(out, branches[child].begin, branches[child].end, branches[child].children);
+        } else {
+            out.append(makeMarker(child));
+        }
+        cursor = branches[child].end;
+    }
+    out.append(content, cursor, end - cursor);
+}
+
+std::string LazyBranchTranslator::makeMarker(int branch) const {
+    std::string marker = markerPrefix + std::to_string(branch);
+    std::string containers =
+            "{\"block_type\": \"container\", \"containerName\": \"" + marker + "\", \"type\": \"1\", "
+            "\"destiny\": \"Ambient\", \"initialVolume\": \"0\", \"initialVolumeUnits\": \"ml\"}";
+    for(const std::string & container: branches[branch].containers) {
+        containers += ", " + container;
+    }
+    if (branches[branch].containers.empty()) {
+        containers +=
+                ", {\"block_type\": \"container\", \"containerName\": \"" + marker + "_end\", \"type\": \"1\", "
+                "\"destiny\": \"Ambient\", \"initialVolume\": \"0\", \"initialVolumeUnits\": \"ml\"}";
+    }
+
+    return "[{\"timeOfOperation\": \"-1\", \"timeOfOperation_units\": \"ms\", \"linked\": \"TRUE\", "
+           "\"duration\": \"1\", \"duration_units\": \"s\", \"block_type\": \"continuous_flow\", "
+           "\"source\": {\"block_type\": \"containerList\", \"containerList\": [" + containers + "]}, "
+           "\"rate\": {\"block_type\": \"math_number\", \"value\": \"0\"}, "
+           "\"rate_volume_units\": \"ml\", \"rate_time_units\": \"hr\"}]";
+}
@@ -0,0 +1,126 @@
+#ifndef LAZYBRANCHTRANSLATOR_H
+#define LAZYBRANCHTRANSLATOR_H
+
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <bioblocksTranslation/bioblockstranslator.h>
+
+#include "ticktimebase.h"
+
+/**
+ * Translates the branches of controls_if blocks only when an execution enters them.
+ *
+ * The protocol file is read once and scanned for the byte span of the nestedOp array of every branch of
+ * every controls_if. The translated protocol is the file with each branch body not entered yet replaced by
+ * a marker: a continuous_flow from a container named <markerPrefix><branch> through the containers the body
+ * declares, so the containers are loaded as in the full protocol. Executing the marker tells the branch has
+ * been taken; expand() then puts the original bytes back (the ifs nested inside get their own markers) and
+ * translate() builds the next graph. ProtocolGraph can not be modified once translated, so LazyProtocolExecutor
+ * splices the new branch by replaying the execution up to the marker over the new graph.
+ *
+ * A branch whose body has no more blocks than its marker is rendered in place from the start: deferring it
+ * would cost a translation and a replay for nothing. Every deferred branch gets a deadline from the static
+ * analysis of the protocol, the latest start of its controls_if plus one slice for every linked block before
+ * it, as each of them may round its start up to a slice; once the execution is past the deadline of every
+ * deferred branch not expanded, none of them can be reached and the executed prefix is not needed anymore.
+ * Branches after a block of unknown duration or inside a loop have no deadline.
+ */
+class LazyBranchTranslator
+{
+public:
+    LazyBranchTranslator(const std::string & path,
+                         const std::string & translatedPath,
+                         units::Time timeSlice,
+                         const std::string & markerPrefix = "lazy_branch_") throw(std::invalid_argument);
+    virtual ~LazyBranchTranslator();
+
+    std::shared_ptr<ProtocolGraph> translate() throw(std::invalid_argument);
+    std::string render() const;
+
+    void expand(int branch) throw(std::invalid_argument);
+    int markerBranch(const std::string & containerId) const;
+
+    bool hasReachableBranches(TickTimebase::Ticks elapsed) const;
+
+    inline bool isExpanded(int branch) const {
+        return expanded.find(branch) != expanded.end();
+    }
+
+    inline bool isDeferred(int branch) const {
+        return branches[branch].deferred;
+    }
+
+    inline size_t getBranchesCount() const {
+        return branches.size();
+    }
+
+    inline size_t getExpandedCount() const {
+        return expanded.size();
+    }
+
+    inline unsigned int getTranslations() const {
+        return translations;
+    }
+
+    inline unsigned int getProtocolBlocks() const {
+        return protocolBlocks;
+    }
+
+    inline unsigned long long getTranslatedBlocks() const {
+        return translatedBlocks;
+    }
+
+protected:
+    typedef struct BranchSpan_ {
+        size_t begin;
+        size_t end;
+        size_t ifBegin;
+        int parent;
+        bool deferred;
+        unsigned int blocks;
+        TickTimebase::Ticks deadline;
+        std::vector<int> children;
+        std::vector<std::string> containerNames;
+        std::vector<std::string> containers;
+    } BranchSpan;
+
+    typedef struct JsonNode_ {
+        size_t begin;
+        size_t end;
+        std::string text;
+        std::vector<std::pair<std::string, int>> members;
+        std::vector<int> items;
+    } JsonNode;
+
+    std::string translatedPath;
+    units::Time timeSlice;
+    std::string markerPrefix;
+
+    std::string content;
+    std::vector<BranchSpan> branches;
+    std::vector<int> topBranches;
+    std::set<int> expanded;
+    unsigned int translations;
+    unsigned int protocolBlocks;
+    unsigned long long translatedBlocks;
+
+    int scanValue(size_t & pos, std::vector<JsonNode> & nodes) const throw(std::invalid_argument);
+    void scanString(size_t & pos, std::string & text) const throw(std::invalid_argument);
+    void skipSpaces(size_t & pos) const;
+    int member(const std::vector<JsonNode> & nodes, int node, const std::string & key) const;
+
+    void collectBranches(const std::vector<JsonNode> & nodes, int node, int parent);
+    void collectContainers(const std::vector<JsonNode> & nodes, int node, BranchSpan & branch) const;
+    void collectIfs(const std::vector<JsonNode> & nodes, int node, std::vector<size_t> & ifs) const;
+    unsigned int countBlocks(const std::vector<JsonNode> & nodes, int node) const;
+    void computeDeadlines(const std::string & path, const std::vector<JsonNode> & nodes, int root);
+
+    void renderSpan(std::string & out, size_t begin, size_t end, const std::vector<int> & children) const;
+    std::string makeMarker(int branch) const;
+};
+
+#endif // LAZYBRANCHTRANSLATOR_H
@@ -0,0 +1,34 @@
+#include "lazyprotocolexecutor.h"
+
+LazyProtocolExecutor::LazyProtocolExecutor(
+        const std::string & path,
+        const std::string & translatedPath,
+        units::Time timeSlice,
+        ActuatorsExecutionInterface* actuatorInterface) throw(std::invalid_argument) :
+    translator(path, translatedPath, timeSlice), lazyInterface(actuatorInterface, &translator)
+{
+
+}
+
+LazyProtocolExecutor::~LazyProtocolExecutor()
+{
+
+}
+
+void LazyProtocolExecutor::execute() throw(std::invalid_argument, std::runtime_error) {
+    while(true) {
+        std::shared_ptr<ProtocolGraph> protocol = translator.translate();
+
+        lazyInterface.startReplay();
+        ProtocolExecutor executor(protocol, &lazyInterface);
+        try {
+            executor.execute();
+            return;
+        } catch (LazyBranchActuatorsInterface::BranchTaken & taken) {
+            if (translator.isExpanded(taken.getBranch())) {
+                throw(std::runtime_error("imposible to expand branch " + std::to_string(taken.getBranch()) + " twice"));
+            }
+            translator.expand(taken.getBranch());
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef LAZYPROTOCOLEXECUTOR_H
+#define LAZYPROTOCOLEXECUTOR_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <protocolGraph/ProtocolGraph.h>
+
+#include "lazybranchactuatorsinterface.h"
+#include "lazybranchtranslator.h"
+#include "protocolexecutor.h"
+
+/**
+ * Executes a protocol translating its controls_if branches the first time they are taken.
+ *
+ * The protocol is translated with every branch body replaced by a marker. When the execution reaches a
+ * marker the branch is expanded, the protocol translated again and the new graph executed from the start:
+ * the commands already sent are replayed with their recorded values, so the backend sees a single
+ * execution, and the branch goes on from the point where the marker was. Of the branches bigger than their
+ * marker only the ones taken are ever translated, each of them once; the others go with the protocol.
+ *
+ * ProtocolGraph takes no nodes once translated and the node ids of two translations are not related, so
+ * the frontier of the old graph can not be carried over to the new one: every branch taken costs a
+ * translation and a walk of the executed prefix, which sends nothing and reads nothing from the backend.
+ * The recorded calls are run-length encoded, so a prefix of repeated slices costs one entry, and are dropped
+ * once no deferred branch can be reached anymore. getTranslatedBlocks() and getReplayedCalls() give the cost
+ * to compare with translating the whole protocol once.
+ */
+class LazyProtocolExecutor
+{
+public:
+    LazyProtocolExecutor(const std::string & path,
+                         const std::string & translatedPath,
+                         units::Time timeSlice,
+                         ActuatorsExecutionInterface* actuatorInterface) throw(std::invalid_argument);
+    virtual ~LazyProtocolExecutor();
+
+    void execute() throw(std::invalid_argument, std::runtime_error);
+
+    inline const LazyBranchTranslator & getTranslator() const {
+        return translator;
+    }
+
+    inline unsigned long long getReplayedCalls() const {
+        return lazyInterface.getReplayedCalls();
+    }
+
+    inline size_t getRecordedCalls() const {
+        return lazyInterface.getRecordedCalls();
+    }
+
+    inline bool isRecordingDropped() const {
+        return lazyInterface.isRecordingDropped();
+    }
+
+    inline unsigned long long getTranslatedBlocks() const {
+        return translator.getTranslatedBlocks();
+    }
+
+protected:
+    LazyBranchTranslator translator;
+    LazyBranchActuatorsInterface lazyInterface;
+};
+
+#endif // LAZYPROTOCOLEXECUTOR_H
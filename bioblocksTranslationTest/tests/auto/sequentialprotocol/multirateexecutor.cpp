@@ -0,0 +1,205 @@
+#include "multirateexecutor.h"
+
+#include <algorithm>
+
+#include "protocoljson.h"
+#include "timesliceselector.h"
+
+namespace {
+
+TickTimebase::Ticks gcd(TickTimebase::Ticks a, TickTimebase::Ticks b) {
+    while (b != 0) {
+        TickTimebase::Ticks rest = a % b;
+        a = b;
+        b = rest;
+    }
+    return a;
+}
+
+int findRoot(std::vector<int> & parents, int track) {
+    while (parents[track] != track) {
+        parents[track] = parents[parents[track]];
+        track = parents[track];
+    }
+    return track;
+}
+
+}
+
+MultiRateExecutor::MultiRateExecutor(
+        const std::string & path,
+        const std::string & workDir,
+        ActuatorsExecutionInterface* actuatorInterface,
+        units::Time fallbackSlice) throw(std::invalid_argument) :
+    protocol(ProtocolJson::read(path)), workDir(workDir), actuatorInterface(actuatorInterface), fallbackSlice(fallbackSlice)
+{
+    now = 0;
+    backendSteps = 0;
+
+    if (protocol.count("linkedBlocks") == 0 || !protocol["linkedBlocks"].is_array()) {
+        throw(std::invalid_argument("protocol without linkedBlocks"));
+    }
+    splitTracks();
+}
+
+MultiRateExecutor::~MultiRateExecutor()
+{
+
+}
+
+void MultiRateExecutor::setTrackSlice(int track, units::Time timeSlice) throw(std::invalid_argument) {
+    if (track < 0 || track >= (int) protocol["linkedBlocks"].size()) {
+        throw(std::invalid_argument("imposible to set the slice of unknown track " + std::to_string(track)));
+    }
+
+    TickTimebase::Ticks ticks = TickTimebase::fromTime(timeSlice);
+    if (ticks <= 0) {
+        throw(std::invalid_argument("imposible to use a slice of " + std::to_string(ticks) + " ticks"));
+    }
+    trackSlices[track] = ticks;
+}
+
+void MultiRateExecutor::execute() throw(std::invalid_argument, std::runtime_error) {
+    std::vector<ScheduledGroup> scheduled;
+    for(TrackGroup & group: groups) {
+        nlohmann::json groupJson = groupProtocol(group);
+        group.timeSlice = groupSlice(group, groupJson);
+        group.slices = 0;
+
+        std::string groupPath = workDir + "/track_" + std::to_string(group.tracks.front()) + ".json";
+        ProtocolJson::write(groupJson, groupPath);
+        BioBlocksTranslator translator(TickTimebase::toTime(group.timeSlice), groupPath);
+
+        ScheduledGroup entry;
+        entry.interface = std::make_shared<TrackActuatorsInterface>(actuatorInterface, &loadedContainers);
+        entry.executor = std::make_shared<ProtocolExecutor>(translator.translateFile(), entry.interface.get());
+        entry.nextBoundary = 0;
+        scheduled.push_back(entry);
+    }
+
+    now = 0;
+    backendSteps = 0;
+    TickTimebase::Ticks backendSlice = 0;
+    while(true) {
+        for(size_t i = 0; i < scheduled.size(); i++) {
+            ScheduledGroup & entry = scheduled[i];
+            if (entry.interface->isWaitingSlice() || entry.executor->hasFinished()) {
+                continue;
+            }
+
+            while(!entry.interface->isWaitingSlice() && entry.executor->executeNextNode());
+            if (entry.interface->isWaitingSlice()) {
+                entry.nextBoundary = TickTimebase::add(now, groups[i].timeSlice);
+                if (entry.nextBoundary == TickTimebase::UNBOUNDED) {
+                    throw(std::runtime_error("imposible to schedule the tracks from " + std::to_string(groups[i].tracks.front()) +
+                                             " after " + std::to_string(groups[i].slices) + " slices, out of the range of ticks"));
+                }
+                groups[i].slices++;
+            }
+        }
+
+        TickTimebase::Ticks next = TickTimebase::UNBOUNDED;
+        for(const ScheduledGroup & entry: scheduled) {
+            if (entry.interface->isWaitingSlice()) {
+                next = std::min(next, entry.nextBoundary);
+            }
+        }
+        if (next == TickTimebase::UNBOUNDED) {
+            break;
+        }
+
+        if (next - now != backendSlice) {
+            backendSlice = next - now;
+            actuatorInterface->setTimeStep(TickTimebase::toTime(backendSlice));
+        }
+        actuatorInterface->timeStep();
+        backendSteps++;
+        now = next;
+
+        for(ScheduledGroup & entry: scheduled) {
+            if (entry.interface->isWaitingSlice() && entry.nextBoundary == now) {
+                entry.interface->sliceDone();
+            }
+        }
+    }
+}
+
+unsigned long long MultiRateExecutor::getSingleRateSlices() const {
+    TickTimebase::Ticks slice = 0;
+    for(const TrackGroup & group: groups) {
+        slice = gcd(slice, group.timeSlice);
+    }
+    return TickTimebase::slicesFor(now, slice);
+}
+
+void MultiRateExecutor::splitTracks() {
+    const nlohmann::json & tracks = protocol["linkedBlocks"];
+
+    std::vector<int> parents(tracks.size());
+    std::map<std::string, int> variableOwners;
+    for(size_t track = 0; track < tracks.size(); track++) {
+        parents[track] = track;
+
+        std::set<std::string> variables;
+        collectVariables(tracks[track], variables);
+        for(const std::string & variable: variables) {
+            auto it = variableOwners.find(variable);
+            if (it == variableOwners.end()) {
+                variableOwners.insert(std::make_pair(variable, track));
+            } else {
+                parents[findRoot(parents, track)] = findRoot(parents, it->second);
+            }
+        }
+    }
+
+    std::map<int, size_t> groupOfRoot;
+    for(size_t track = 0; track < tracks.size(); track++) {
+        int root = findRoot(parents, track);
+        auto it = groupOfRoot.find(root);
+        if (it == groupOfRoot.end()) {
+            it = groupOfRoot.insert(std::make_pair(root, groups.size())).first;
+            groups.push_back(TrackGroup{std::vector<int>(), 0, 0});
+        }
+        groups[it->second].tracks.push_back(track);
+    }
+}
+
+nlohmann::json MultiRateExecutor::groupProtocol(const TrackGroup & group) const {
+    nlohmann::json groupJson = protocol;
+    groupJson["linkedBlocks"] = nlohmann::json::array();
+    for(int track: group.tracks) {
+        groupJson["linkedBlocks"].push_back(protocol["linkedBlocks"][track]);
+    }
+    return groupJson;
+}
+
+TickTimebase::Ticks MultiRateExecutor::groupSlice(const TrackGroup & group, const nlohmann::json & groupJson) const throw(std::invalid_argument) {
+    TickTimebase::Ticks slice = 0;
+    for(int track: group.tracks) {
+        auto it = trackSlices.find(track);
+        if (it != trackSlices.end()) {
+            slice = gcd(slice, it->second);
+        }
+    }
+
+    if (slice == 0) {
+        TimeSliceSelector selector(fallbackSlice);
+        slice = TickTimebase::fromTime(selector.selectTimeSlice(groupJson));
+    }
+    return slice;
+}
+
+void MultiRateExecutor::collectVariables(const nlohmann::json & value, std::set<std::string> & variables) {
+    if (value.is_object()) {
+        if (ProtocolJson::isBlock(value) && value.count("variable") > 0 && value["variable"].is_string()) {
+            variables.insert(value["variable"].get<std::string>());
+        }
+        for(auto it = value.begin(); it != value.end(); ++it) {
+            collectVariables(it.value(), variables);
+        }
+    } else if (value.is_array()) {
+        for(const nlohmann::json & element: value) {
+            collectVariables(element, variables);
+        }
+    }
+}
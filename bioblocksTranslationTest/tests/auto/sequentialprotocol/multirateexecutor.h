@@ -0,0 +1,89 @@
+#ifndef MULTIRATEEXECUTOR_H
+#define MULTIRATEEXECUTOR_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+#include <protocolGraph/ProtocolGraph.h>
+
+#include "protocolexecutor.h"
+#include "ticktimebase.h"
+#include "trackactuatorsinterface.h"
+
+/**
+ * Executes every linkedBlocks track of a protocol with its own time slice.
+ *
+ * BioBlocksTranslator takes a single slice, so the protocol is split: tracks that share a variable stay
+ * together, every group is written to its own file in the work directory and translated with its slice,
+ * the one set with setTrackSlice() for its tracks or else the coarsest one that lands on all its times
+ * (TimeSliceSelector). The groups share one timeline in ticks: at every boundary the groups due run, in
+ * track order, until they ask for their next time step, and the backend is advanced to the nearest next
+ * boundary with a single timeStep(), so commands reach it ordered by time and, at the same time, by track.
+ * The backend gets a setTimeStep every time the distance to the next boundary changes.
+ */
+class MultiRateExecutor
+{
+public:
+    typedef struct TrackGroup_ {
+        std::vector<int> tracks;
+        TickTimebase::Ticks timeSlice;
+        unsigned long long slices;
+    } TrackGroup;
+
+    MultiRateExecutor(const std::string & path,
+                      const std::string & workDir,
+                      ActuatorsExecutionInterface* actuatorInterface,
+                      units::Time fallbackSlice = 1*units::s) throw(std::invalid_argument);
+    virtual ~MultiRateExecutor();
+
+    void setTrackSlice(int track, units::Time timeSlice) throw(std::invalid_argument);
+
+    void execute() throw(std::invalid_argument, std::runtime_error);
+
+    unsigned long long getSingleRateSlices() const;
+
+    inline const std::vector<TrackGroup> & getGroups() const {
+        return groups;
+    }
+
+    inline unsigned long long getBackendSteps() const {
+        return backendSteps;
+    }
+
+    inline TickTimebase::Ticks getElapsedTicks() const {
+        return now;
+    }
+
+protected:
+    typedef struct ScheduledGroup_ {
+        std::shared_ptr<TrackActuatorsInterface> interface;
+        std::shared_ptr<ProtocolExecutor> executor;
+        TickTimebase::Ticks nextBoundary;
+    } ScheduledGroup;
+
+    nlohmann::json protocol;
+    std::string workDir;
+    ActuatorsExecutionInterface* actuatorInterface;
+    units::Time fallbackSlice;
+
+    std::vector<TrackGroup> groups;
+    std::map<int, TickTimebase::Ticks> trackSlices;
+    std::set<std::string> loadedContainers;
+
+    TickTimebase::Ticks now;
+    unsigned long long backendSteps;
+
+    void splitTracks();
+    nlohmann::json groupProtocol(const TrackGroup & group) const;
+    TickTimebase::Ticks groupSlice(const TrackGroup & group, const nlohmann::json & groupJson) const throw(std::invalid_argument);
+
+    static void collectVariables(const nlohmann::json & value, std::set<std::string> & variables);
+};
+
+#endif // MULTIRATEEXECUTOR_H
@@ -0,0 +1,205 @@
+#include "parameterizedprotocol.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "protocoljson.h"
+
+namespace {
+
+// marks the place of every parameter value in the serialized protocol, it can not be part of a protocol
+const char tokenMark = '\x01';
+
+const std::string variablePrefix = "parameter_";
+
+}
+
+ParameterizedProtocol::ParameterizedProtocol(const std::string & path) throw(std::invalid_argument)
+{
+    load(ProtocolJson::read(path));
+}
+
+ParameterizedProtocol::ParameterizedProtocol(const nlohmann::json & protocol) throw(std::invalid_argument)
+{
+    load(protocol);
+}
+
+ParameterizedProtocol::~ParameterizedProtocol()
+{
+
+}
+
+std::string ParameterizedProtocol::instantiate(const std::vector<double> & values) const throw(std::invalid_argument) {
+    if (values.size() != parameters.size()) {
+        throw(std::invalid_argument("imposible to instantiate the protocol with " + std::to_string(values.size()) +
+                                    " values, it has " + std::to_string(parameters.size()) + " parameters"));
+    }
+
+    std::vector<std::string> formatted;
+    formatted.reserve(values.size());
+    for(double value: values) {
+        formatted.push_back(formatValue(value));
+    }
+
+    std::string out;
+    out.reserve(text.size() + slots.size() * 8);
+
+    size_t cursor = 0;
+    for(const ValueSlot & slot: slots) {
+        out.append(text, cursor, slot.textEnd - cursor);
+        out.append(formatted[slot.parameter]);
+        cursor = slot.textEnd;
+    }
+    out.append(text, cursor, std::string::npos);
+    return out;
+}
+
+std::string ParameterizedProtocol::instantiate(const std::map<std::string, double> & values) const throw(std::invalid_argument) {
+    std::vector<double> bound = defaults;
+    for(const std::pair<const std::string, double> & value: values) {
+        int index = parameterIndex(value.first);
+        if (index == -1) {
+            throw(std::invalid_argument("imposible to bind unknown parameter " + value.first));
+        }
+        bound[index] = value.second;
+    }
+    return instantiate(bound);
+}
+
+std::shared_ptr<ProtocolGraph> ParameterizedProtocol::translate(
+        const std::vector<double> & values,
+        units::Time timeSlice,
+        const std::string & path) const throw(std::invalid_argument)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        throw(std::invalid_argument("imposible to open " + path));
+    }
+    out << instantiate(values);
+    out.close();
+
+    BioBlocksTranslator translator(timeSlice, path);
+    return translator.translateFile();
+}
+
+std::shared_ptr<ProtocolGraph> ParameterizedProtocol::translateLowered(units::Time timeSlice, const std::string & path) const
+    throw(std::invalid_argument)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        throw(std::invalid_argument("imposible to open " + path));
+    }
+    out << lowered;
+    out.close();
+
+    BioBlocksTranslator translator(timeSlice, path);
+    return translator.translateFile();
+}
+
+std::string ParameterizedProtocol::variableName(int parameter) const {
+    return variablePrefix + parameters[parameter];
+}
+
+int ParameterizedProtocol::parameterIndex(const std::string & name) const {
+    for(size_t i = 0; i < parameters.size(); i++) {
+        if (parameters[i] == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ParameterizedProtocol::load(nlohmann::json protocol) throw(std::invalid_argument) {
+    nlohmann::json lowering = protocol;
+    std::vector<int> slotParameters;
+    try {
+        markParameters(protocol, slotParameters);
+        lowerParameters(lowering);
+    } catch (std::invalid_argument & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument(std::string("malformed protocol: ") + e.what()));
+    }
+
+    // the tokens are serialized as \u0001<slot>\u0001, every one is cut out and its end remembered
+    std::string dumped = protocol.dump();
+    std::string escapedMark = "\\u0001";
+
+    text.reserve(dumped.size());
+    size_t cursor = 0;
+    for(size_t slot = 0; slot < slotParameters.size(); slot++) {
+        std::string token = escapedMark + std::to_string(slot) + escapedMark;
+        size_t pos = dumped.find(token, cursor);
+        if (pos == std::string::npos) {
+            throw(std::invalid_argument("imposible to find parameter " + parameters[slotParameters[slot]] + " in the protocol"));
+        }
+        text.append(dumped, cursor, pos - cursor);
+        slots.push_back(ValueSlot{text.size(), slotParameters[slot]});
+        cursor = pos + token.size();
+    }
+    text.append(dumped, cursor, std::string::npos);
+    lowered = lowering.dump();
+}
+
+void ParameterizedProtocol::markParameters(nlohmann::json & value, std::vector<int> & slotParameters) throw(std::invalid_argument) {
+    if (ProtocolJson::isBlock(value, "math_number") && value.count("parameter") > 0) {
+        std::string name = value["parameter"].get<std::string>();
+        double literal = std::stod(value["value"].get<std::string>());
+
+        int index = parameterIndex(name);
+        if (index == -1) {
+            index = parameters.size();
+            parameters.push_back(name);
+            defaults.push_back(literal);
+        } else if (defaults[index] != literal) {
+            throw(std::invalid_argument("parameter " + name + " has different values: " +
+                                        formatValue(defaults[index]) + " and " + formatValue(literal)));
+        }
+
+        value.erase("parameter");
+        value["value"] = slotToken(slotParameters.size());
+        slotParameters.push_back(index);
+        return;
+    }
+
+    if (value.is_object()) {
+        for(auto it = value.begin(); it != value.end(); ++it) {
+            markParameters(it.value(), slotParameters);
+        }
+    } else if (value.is_array()) {
+        for(nlohmann::json & element: value) {
+            markParameters(element, slotParameters);
+        }
+    }
+}
+
+void ParameterizedProtocol::lowerParameters(nlohmann::json & value) const {
+    if (ProtocolJson::isBlock(value, "math_number") && value.count("parameter") > 0) {
+        std::string name = value["parameter"].get<std::string>();
+        value = nlohmann::json::object();
+        value["block_type"] = "variables_get";
+        value["variable"] = variablePrefix + name;
+        return;
+    }
+
+    if (value.is_object()) {
+        for(auto it = value.begin(); it != value.end(); ++it) {
+            lowerParameters(it.value());
+        }
+    } else if (value.is_array()) {
+        for(nlohmann::json & element: value) {
+            lowerParameters(element);
+        }
+    }
+}
+
+std::string ParameterizedProtocol::slotToken(size_t slot) {
+    return std::string(1, tokenMark) + std::to_string(slot) + std::string(1, tokenMark);
+}
+
+std::string ParameterizedProtocol::formatValue(double value) {
+    std::ostringstream out;
+    out.precision(15);
+    out << value;
+    return out.str();
+}
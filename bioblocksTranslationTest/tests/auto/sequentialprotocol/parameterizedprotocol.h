@@ -0,0 +1,79 @@
+#ifndef PARAMETERIZEDPROTOCOL_H
+#define PARAMETERIZEDPROTOCOL_H
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+#include <bioblocksTranslation/bioblockstranslator.h>
+
+/**
+ * A BioBlocks protocol whose math_number blocks marked with a "parameter" name can be given new values:
+ *      {"block_type": "math_number", "value": "21", "parameter": "rate"}
+ *
+ * The json is read, checked and serialized once, cut at every parameter value. A variant is the
+ * concatenation of those pieces with the bound values, so instantiating it costs the copy of the text and
+ * the formatting of the parameters, no json is parsed nor dumped again. Blocks marked with the same name
+ * share the parameter.
+ *
+ * The protocol is also lowered once: every parameter block becomes a variables_get of the graph variable
+ * variableName(parameter), which nothing in the protocol sets. translateLowered() builds a graph whose
+ * parameters are bound by setting those variables, the text of the variant is never built.
+ */
+class ParameterizedProtocol
+{
+public:
+    ParameterizedProtocol(const std::string & path) throw(std::invalid_argument);
+    ParameterizedProtocol(const nlohmann::json & protocol) throw(std::invalid_argument);
+    virtual ~ParameterizedProtocol();
+
+    std::string instantiate(const std::vector<double> & values) const throw(std::invalid_argument);
+    std::string instantiate(const std::map<std::string, double> & values) const throw(std::invalid_argument);
+
+    std::shared_ptr<ProtocolGraph> translate(const std::vector<double> & values,
+                                             units::Time timeSlice,
+                                             const std::string & path) const throw(std::invalid_argument);
+    std::shared_ptr<ProtocolGraph> translateLowered(units::Time timeSlice, const std::string & path) const throw(std::invalid_argument);
+
+    std::string variableName(int parameter) const;
+
+    int parameterIndex(const std::string & name) const;
+
+    inline const std::vector<std::string> & getParameters() const {
+        return parameters;
+    }
+
+    inline const std::vector<double> & getDefaults() const {
+        return defaults;
+    }
+
+    inline const std::string & getLowered() const {
+        return lowered;
+    }
+
+protected:
+    typedef struct ValueSlot_ {
+        size_t textEnd;
+        int parameter;
+    } ValueSlot;
+
+    std::vector<std::string> parameters;
+    std::vector<double> defaults;
+
+    std::string text;
+    std::vector<ValueSlot> slots;
+    std::string lowered;
+
+    void load(nlohmann::json protocol) throw(std::invalid_argument);
+    void markParameters(nlohmann::json & value, std::vector<int> & slotParameters) throw(std::invalid_argument);
+    void lowerParameters(nlohmann::json & value) const;
+
+    static std::string slotToken(size_t slot);
+    static std::string formatValue(double value);
+};
+
+#endif // PARAMETERIZEDPROTOCOL_H
@@ -0,0 +1,123 @@
+#include "parametersweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+ParameterSweep::ParameterSweep(const ParameterizedProtocol & protocol, units::Time timeSlice, unsigned int threads) :
+    protocol(protocol), timeSlice(timeSlice), threads(threads), translations(0)
+{
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+ParameterSweep::~ParameterSweep()
+{
+
+}
+
+void ParameterSweep::setVariableBinder(VariableBinder bindVariable) {
+    this->bindVariable = bindVariable;
+}
+
+std::vector<std::vector<double>> ParameterSweep::grid(const std::vector<std::vector<double>> & axes) {
+    std::vector<std::vector<double>> variants(1);
+    for(const std::vector<double> & axis: axes) {
+        std::vector<std::vector<double>> extended;
+        extended.reserve(variants.size() * axis.size());
+        for(const std::vector<double> & variant: variants) {
+            for(double value: axis) {
+                extended.push_back(variant);
+                extended.back().push_back(value);
+            }
+        }
+        variants.swap(extended);
+    }
+    return variants;
+}
+
+std::vector<ParameterSweep::VariantResult> ParameterSweep::run(
+        const std::vector<std::vector<double>> & variants,
+        VariantFunction function,
+        const std::string & workDir) throw(std::invalid_argument)
+{
+    for(const std::vector<double> & values: variants) {
+        if (values.size() != protocol.getParameters().size()) {
+            throw(std::invalid_argument("imposible to run a variant with " + std::to_string(values.size()) +
+                                        " values, the protocol has " + std::to_string(protocol.getParameters().size()) +
+                                        " parameters"));
+        }
+    }
+
+    std::vector<VariantResult> results(variants.size());
+    std::atomic<size_t> nextVariant(0);
+    translations = 0;
+
+    auto worker = [&](unsigned int workerId) {
+        std::string path = workDir + "/variant_" + std::to_string(workerId) + ".json";
+        for(size_t i = nextVariant++; i < variants.size(); i = nextVariant++) {
+            if (bindVariable) {
+                results[i] = runBound(variants[i], function, path);
+            } else {
+                results[i] = runVariant(variants[i], function, path);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(unsigned int i = 1; i < std::min<size_t>(threads, variants.size()); i++) {
+        workers.push_back(std::thread(worker, i));
+    }
+    worker(0);
+
+    for(std::thread & thread: workers) {
+        thread.join();
+    }
+    return results;
+}
+
+ParameterSweep::VariantResult ParameterSweep::runVariant(
+        const std::vector<double> & values,
+        VariantFunction function,
+        const std::string & path)
+{
+    VariantResult result;
+    result.values = values;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    try {
+        std::shared_ptr<ProtocolGraph> graph = protocol.translate(values, timeSlice, path);
+        translations++;
+        result.output = function(graph, values);
+    } catch (std::exception & e) {
+        result.error = e.what();
+    }
+    result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+ParameterSweep::VariantResult ParameterSweep::runBound(
+        const std::vector<double> & values,
+        VariantFunction function,
+        const std::string & path)
+{
+    VariantResult result;
+    result.values = values;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    try {
+        // an executed graph keeps its loop counters, time variables and node state, every variant gets a new one
+        std::shared_ptr<ProtocolGraph> graph = protocol.translateLowered(timeSlice, path);
+        translations++;
+        for(size_t i = 0; i < values.size(); i++) {
+            bindVariable(graph, protocol.variableName(i), values[i]);
+        }
+        result.output = function(graph, values);
+    } catch (std::exception & e) {
+        result.error = e.what();
+    }
+    result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
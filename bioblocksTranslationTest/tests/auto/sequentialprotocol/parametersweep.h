@@ -0,0 +1,74 @@
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <protocolGraph/ProtocolGraph.h>
+
+#include "parameterizedprotocol.h"
+
+/**
+ * Runs the variants of a ParameterizedProtocol over a pool of worker threads.
+ *
+ * Every variant is a vector of values, in the order of ParameterizedProtocol::getParameters(); grid()
+ * builds the cartesian product of a list of values per parameter. Workers take the next pending variant
+ * as soon as they are free, write it to their own file in the work directory, translate it and hand the
+ * graph to the variant function, whose text is kept as the output of the variant (an execution trace, a
+ * score...). A variant that fails keeps the error and does not stop the sweep.
+ *
+ * ProtocolGraph has no way to set a variable, so with a variable binder, given by whoever has that access,
+ * every variant is a translation of the lowered protocol with one variable set per parameter. An executed
+ * graph keeps its loop counters, time variables and node state and ProtocolGraph can neither reset nor
+ * copy a graph, so no graph is executed twice: every variant is translated again, the binder only saves
+ * instantiating its text. Without a binder every variant is translated from its own text.
+ */
+class ParameterSweep
+{
+public:
+    typedef std::function<std::string(std::shared_ptr<ProtocolGraph>, const std::vector<double> &)> VariantFunction;
+    typedef std::function<void(std::shared_ptr<ProtocolGraph>, const std::string &, double)> VariableBinder;
+
+    typedef struct VariantResult_ {
+        std::vector<double> values;
+        std::string output;
+        std::string error;
+        double durationMs;
+    } VariantResult;
+
+    ParameterSweep(const ParameterizedProtocol & protocol, units::Time timeSlice, unsigned int threads = 0);
+    virtual ~ParameterSweep();
+
+    static std::vector<std::vector<double>> grid(const std::vector<std::vector<double>> & axes);
+
+    void setVariableBinder(VariableBinder bindVariable);
+
+    std::vector<VariantResult> run(const std::vector<std::vector<double>> & variants,
+                                   VariantFunction function,
+                                   const std::string & workDir) throw(std::invalid_argument);
+
+    VariantResult runVariant(const std::vector<double> & values,
+                             VariantFunction function,
+                             const std::string & path);
+
+    inline unsigned int getTranslations() const {
+        return translations;
+    }
+
+protected:
+    const ParameterizedProtocol & protocol;
+    units::Time timeSlice;
+    unsigned int threads;
+    VariableBinder bindVariable;
+    std::atomic<unsigned int> translations;
+
+    VariantResult runBound(const std::vector<double> & values,
+                           VariantFunction function,
+                           const std::string & path);
+};
+
+#endif // PARAMETERSWEEP_H
@@ -0,0 +1,325 @@
+#include "partitionactuatorsinterface.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+PartitionActuatorsInterface::PartitionActuatorsInterface(
+        ActuatorsExecutionInterface* actuatorInterface,
+        int partition,
+        const std::map<std::string, int> & ownership,
+        int channel) :
+    ForwardingActuatorsInterface(actuatorInterface), partition(partition), ownership(ownership), channel(channel)
+{
+    calls = 0;
+}
+
+PartitionActuatorsInterface::~PartitionActuatorsInterface()
+{
+
+}
+
+void PartitionActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {
+    if (route(sourceId)) {
+        actuatorInterface->applyLigth(sourceId, wavelength, intensity);
+    }
+}
+
+void PartitionActuatorsInterface::stopApplyLigth(const std::string & sourceId) {
+    if (route(sourceId)) {
+        actuatorInterface->stopApplyLigth(sourceId);
+    }
+}
+
+void PartitionActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {
+    if (route(sourceId)) {
+        actuatorInterface->applyTemperature(sourceId, temperature);
+    }
+}
+
+void PartitionActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {
+    if (route(sourceId)) {
+        actuatorInterface->stopApplyTemperature(sourceId);
+    }
+}
+
+void PartitionActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {
+    if (route(idSource)) {
+        actuatorInterface->stir(idSource, intensity);
+    }
+}
+
+void PartitionActuatorsInterface::stopStir(const std::string & idSource) {
+    if (route(idSource)) {
+        actuatorInterface->stopStir(idSource);
+    }
+}
+
+void PartitionActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {
+    if (route(idSource)) {
+        actuatorInterface->centrifugate(idSource, intensity);
+    }
+}
+
+void PartitionActuatorsInterface::stopCentrifugate(const std::string & idSource) {
+    if (route(idSource)) {
+        actuatorInterface->stopCentrifugate(idSource);
+    }
+}
+
+void PartitionActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {
+    if (route(idSource)) {
+        actuatorInterface->shake(idSource, intensity);
+    }
+}
+
+void PartitionActuatorsInterface::stopShake(const std::string & idSource) {
+    if (route(idSource)) {
+        actuatorInterface->stopShake(idSource);
+    }
+}
+
+void PartitionActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {
+    if (route(idSource)) {
+        actuatorInterface->startElectrophoresis(idSource, fieldStrenght);
+    }
+}
+
+std::shared_ptr<ElectrophoresisResult> PartitionActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    if (route(idSource)) {
+        return actuatorInterface->stopElectrophoresis(idSource);
+    }
+    return std::make_shared<ElectrophoresisResult>();
+}
+
+units::Volume PartitionActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    std::uint64_t index = calls;
+    bool owner = route(sourceId);
+    double value = owner ? actuatorInterface->getVirtualVolume(sourceId).to(units::ml) : 0;
+    return share(owner, index, value) * units::ml;
+}
+
+void PartitionActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    if (route(sourceId)) {
+        actuatorInterface->loadContainer(sourceId, initialVolume);
+    }
+}
+
+void PartitionActuatorsInterface::startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength) {
+    if (route(sourceId)) {
+        actuatorInterface->startMeasureOD(sourceId, measurementFrequency, wavelength);
+    }
+}
+
+double PartitionActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    std::uint64_t index = calls;
+    bool owner = route(sourceId);
+    double value = owner ? actuatorInterface->getMeasureOD(sourceId) : 0;
+    return share(owner, index, value);
+}
+
+void PartitionActuatorsInterface::startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency) {
+    if (route(sourceId)) {
+        actuatorInterface->startMeasureTemperature(sourceId, measurementFrequency);
+    }
+}
+
+units::Temperature PartitionActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    std::uint64_t index = calls;
+    bool owner = route(sourceId);
+    double value = owner ? actuatorInterface->getMeasureTemperature(sourceId).to(units::C) : 0;
+    return share(owner, index, value) * units::C;
+}
+
+void PartitionActuatorsInterface::startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency) {
+    if (route(sourceId)) {
+        actuatorInterface->startMeasureLuminiscense(sourceId, measurementFrequency);
+    }
+}
+
+units::LuminousIntensity PartitionActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    std::uint64_t index = calls;
+    bool owner = route(sourceId);
+    double value = owner ? actuatorInterface->getMeasureLuminiscense(sourceId).to(units::cd) : 0;
+    return share(owner, index, value) * units::cd;
+}
+
+void PartitionActuatorsInterface::startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency) {
+    if (route(sourceId)) {
+        actuatorInterface->startMeasureVolume(sourceId, measurementFrequency);
+    }
+}
+
+units::Volume PartitionActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    std::uint64_t index = calls;
+    bool owner = route(sourceId);
+    double value = owner ? actuatorInterface->getMeasureVolume(sourceId).to(units::ml) : 0;
+    return share(owner, index, value) * units::ml;
+}
+
+void PartitionActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+    if (route(sourceId)) {
+        actuatorInterface->startMeasureFluorescence(sourceId, measurementFrequency, excitation, emission);
+    }
+}
+
+units::LuminousIntensity PartitionActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    std::uint64_t index = calls;
+    bool owner = route(sourceId);
+    double value = owner ? actuatorInterface->getMeasureFluorescence(sourceId).to(units::cd) : 0;
+    return share(owner, index, value) * units::cd;
+}
+
+void PartitionActuatorsInterface::setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate) {
+    if (route(idSource)) {
+        actuatorInterface->setContinuosFlow(idSource, idTarget, rate);
+    }
+}
+
+void PartitionActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {
+    if (route(idSource)) {
+        actuatorInterface->stopContinuosFlow(idSource, idTarget);
+    }
+}
+
+units::Time PartitionActuatorsInterface::transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume) {
+    std::uint64_t index = calls;
+    bool owner = route(idSource);
+    double value = owner ? actuatorInterface->transfer(idSource, idTarget, volume).to(units::ms) : 0;
+    return share(owner, index, value) * units::ms;
+}
+
+void PartitionActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {
+    if (route(idSource)) {
+        actuatorInterface->stopTransfer(idSource, idTarget);
+    }
+}
+
+units::Time PartitionActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    std::uint64_t index = calls;
+    bool owner = route(idSource1);
+    double value = owner ? actuatorInterface->mix(idSource1, idSource2, idTarget, volume1, volume2).to(units::ms) : 0;
+    return share(owner, index, value) * units::ms;
+}
+
+void PartitionActuatorsInterface::stopMix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget)
+{
+    if (route(idSource1)) {
+        actuatorInterface->stopMix(idSource1, idSource2, idTarget);
+    }
+}
+
+void PartitionActuatorsInterface::setTimeStep(units::Time time) {
+    routeAll();
+    actuatorInterface->setTimeStep(time);
+}
+
+units::Time PartitionActuatorsInterface::timeStep() {
+    routeAll();
+    return actuatorInterface->timeStep();
+}
+
+void PartitionActuatorsInterface::sendJournal() throw(std::runtime_error) {
+    Message message{DONE, (std::uint32_t) partition, journal.size(), 0};
+    if (!sendAll(channel, &message, sizeof(Message)) ||
+            !sendAll(channel, journal.data(), journal.size() * sizeof(std::uint64_t)))
+    {
+        throw(std::runtime_error("imposible to send the journal of partition " + std::to_string(partition)));
+    }
+}
+
+bool PartitionActuatorsInterface::sendAll(int channel, const void* data, size_t size) {
+#ifndef _WIN32
+    const char* bytes = static_cast<const char*>(data);
+    while(size > 0) {
+#ifdef MSG_NOSIGNAL
+        ssize_t sent = ::send(channel, bytes, size, MSG_NOSIGNAL);
+#else
+        ssize_t sent = ::send(channel, bytes, size, 0);
+#endif
+        if (sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= sent;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PartitionActuatorsInterface::receiveAll(int channel, void* data, size_t size) {
+#ifndef _WIN32
+    char* bytes = static_cast<char*>(data);
+    while(size > 0) {
+        ssize_t received = ::recv(channel, bytes, size, 0);
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= received;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PartitionActuatorsInterface::route(const std::string & container) {
+    std::uint64_t index = calls++;
+
+    auto it = ownership.find(container);
+    int owner = (it != ownership.end() ? it->second : 0);
+    if (owner == partition) {
+        journal.push_back(index);
+        return true;
+    }
+    return false;
+}
+
+void PartitionActuatorsInterface::routeAll() {
+    journal.push_back(calls++);
+}
+
+double PartitionActuatorsInterface::share(bool owner, std::uint64_t index, double value) throw(std::runtime_error) {
+    if (owner) {
+        Message message{VALUE, (std::uint32_t) partition, index, value};
+        if (!sendAll(channel, &message, sizeof(Message))) {
+            throw(std::runtime_error("imposible to publish value " + std::to_string(index) + " of partition " + std::to_string(partition)));
+        }
+        return value;
+    }
+
+    auto it = receivedValues.find(index);
+    while(it == receivedValues.end()) {
+        Message message;
+        if (!receiveAll(channel, &message, sizeof(Message)) || message.type != VALUE) {
+            throw(std::runtime_error("partition " + std::to_string(partition) + " lost the coordinator waiting for value " +
+                                     std::to_string(index)));
+        }
+        it = receivedValues.insert(std::make_pair(message.index, message.value)).first;
+        if (message.index != index) {
+            it = receivedValues.find(index);
+        }
+    }
+
+    value = it->second;
+    receivedValues.erase(it);
+    return value;
+}
@@ -0,0 +1,126 @@
+#ifndef PARTITIONACTUATORSINTERFACE_H
+#define PARTITIONACTUATORSINTERFACE_H
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "forwardingactuatorsinterface.h"
+
+/**
+ * View of the instrument of one controller process of a PartitionedExecutor.
+ *
+ * Every process executes the whole graph, so all of them make the same calls in the same order and number
+ * every call the same way. A call is only sent to the controller of the partition that owns its container
+ * (the source for transfers, flows and mixes), time steps go to all of them. Values read from the
+ * instrument are the only thing shared: the owner publishes them on the channel to the coordinator and the
+ * other processes wait for them there, so every replica takes the same branches. The number of every call
+ * sent to the controller is kept in the journal, the single process order of the commands.
+ */
+class PartitionActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    typedef enum MessageType_ {
+        VALUE = 0,
+        DONE,
+        FAILED
+    } MessageType;
+
+    /** DONE is followed by index call numbers of the journal, FAILED by index characters of the error */
+    typedef struct Message_ {
+        std::uint32_t type;
+        std::uint32_t partition;
+        std::uint64_t index;
+        double value;
+    } Message;
+
+    PartitionActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface,
+                                int partition,
+                                const std::map<std::string, int> & ownership,
+                                int channel);
+    virtual ~PartitionActuatorsInterface();
+
+    virtual void applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity);
+    virtual void stopApplyLigth(const std::string & sourceId);
+
+    virtual void applyTemperature(const std::string & sourceId, units::Temperature temperature);
+    virtual void stopApplyTemperature(const std::string & sourceId);
+
+    virtual void stir(const std::string & idSource, units::Frequency intensity);
+    virtual void stopStir(const std::string & idSource);
+
+    virtual void centrifugate(const std::string & idSource, units::Frequency intensity);
+    virtual void stopCentrifugate(const std::string & idSource);
+
+    virtual void shake(const std::string & idSource, units::Frequency intensity);
+    virtual void stopShake(const std::string & idSource);
+
+    virtual void startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght);
+    virtual std::shared_ptr<ElectrophoresisResult> stopElectrophoresis(const std::string & idSource);
+
+    virtual units::Volume getVirtualVolume(const std::string & sourceId);
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual void startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength);
+    virtual double getMeasureOD(const std::string & sourceId);
+
+    virtual void startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+
+    virtual void startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+
+    virtual void startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+
+    virtual void startMeasureFluorescence(const std::string & sourceId,
+                                          units::Frequency measurementFrequency,
+                                          units::Length excitation,
+                                          units::Length emission);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual void setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate);
+    virtual void stopContinuosFlow(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume);
+    virtual void stopTransfer(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time mix(const std::string & idSource1,
+                            const std::string & idSource2,
+                            const std::string & idTarget,
+                            units::Volume volume1,
+                            units::Volume volume2);
+
+    virtual void stopMix(const std::string & idSource1,
+                         const std::string & idSource2,
+                         const std::string & idTarget);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    void sendJournal() throw(std::runtime_error);
+
+    inline const std::vector<std::uint64_t> & getJournal() const {
+        return journal;
+    }
+
+    static bool sendAll(int channel, const void* data, size_t size);
+    static bool receiveAll(int channel, void* data, size_t size);
+
+protected:
+    int partition;
+    const std::map<std::string, int> & ownership;
+    int channel;
+
+    std::uint64_t calls;
+    std::vector<std::uint64_t> journal;
+    std::map<std::uint64_t, double> receivedValues;
+
+    bool route(const std::string & container);
+    void routeAll();
+    double share(bool owner, std::uint64_t index, double value) throw(std::runtime_error);
+};
+
+#endif // PARTITIONACTUATORSINTERFACE_H
@@ -0,0 +1,171 @@
+#include "partitionedexecutor.h"
+
+#include <cstdio>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "protocolexecutor.h"
+
+PartitionedExecutor::PartitionedExecutor(
+        GraphFactory graphFactory,
+        InterfaceFactory interfaceFactory,
+        const std::map<std::string, int> & ownership,
+        int partitions,
+        FinishFunction finish) throw(std::invalid_argument) :
+    graphFactory(graphFactory), interfaceFactory(interfaceFactory), ownership(ownership), partitions(partitions), finish(finish)
+{
+    if (partitions <= 0) {
+        throw(std::invalid_argument("imposible to execute in " + std::to_string(partitions) + " partitions"));
+    }
+    for(const auto & owner: ownership) {
+        if (owner.second < 0 || owner.second >= partitions) {
+            throw(std::invalid_argument("container " + owner.first + " owned by unknown partition " + std::to_string(owner.second)));
+        }
+    }
+    relayedValues = 0;
+}
+
+PartitionedExecutor::~PartitionedExecutor()
+{
+
+}
+
+void PartitionedExecutor::execute() throw(std::runtime_error) {
+#ifndef _WIN32
+    journals.assign(partitions, std::vector<std::uint64_t>());
+    relayedValues = 0;
+
+    std::vector<int> channels;
+    std::vector<int> processes;
+    std::fflush(nullptr);
+    for(int partition = 0; partition < partitions; partition++) {
+        int ends[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) != 0) {
+            coordinate(channels, processes);
+            throw(std::runtime_error("imposible to open the channel of partition " + std::to_string(partition)));
+        }
+
+        pid_t process = fork();
+        if (process == 0) {
+            close(ends[0]);
+            for(int channel: channels) {
+                close(channel);
+            }
+            _exit(runPartition(partition, ends[1]));
+        }
+
+        close(ends[1]);
+        if (process < 0) {
+            close(ends[0]);
+            coordinate(channels, processes);
+            throw(std::runtime_error("imposible to start the controller process of partition " + std::to_string(partition)));
+        }
+        channels.push_back(ends[0]);
+        processes.push_back(process);
+    }
+    coordinate(channels, processes);
+#else
+    throw(std::runtime_error("imposible to start controller processes, partitioned execution needs a POSIX system"));
+#endif
+}
+
+int PartitionedExecutor::runPartition(int partition, int channel) {
+    try {
+        std::shared_ptr<ActuatorsExecutionInterface> actuatorInterface = interfaceFactory(partition);
+        PartitionActuatorsInterface partitionInterface(actuatorInterface.get(), partition, ownership, channel);
+
+        ProtocolExecutor executor(graphFactory(), &partitionInterface);
+        executor.execute();
+
+        if (finish) {
+            finish(partition, actuatorInterface.get());
+        }
+        partitionInterface.sendJournal();
+        return 0;
+    } catch (std::exception & e) {
+        std::string error = e.what();
+        PartitionActuatorsInterface::Message message{PartitionActuatorsInterface::FAILED, (std::uint32_t) partition, error.size(), 0};
+        PartitionActuatorsInterface::sendAll(channel, &message, sizeof(message));
+        PartitionActuatorsInterface::sendAll(channel, error.data(), error.size());
+        return 1;
+    }
+}
+
+void PartitionedExecutor::coordinate(const std::vector<int> & channels, const std::vector<int> & processes) throw(std::runtime_error) {
+#ifndef _WIN32
+    std::vector<bool> finished(channels.size(), false);
+    size_t running = (channels.size() == (size_t) partitions ? channels.size() : 0);
+    std::string error;
+
+    while(running > 0 && error.empty()) {
+        std::vector<pollfd> polled;
+        std::vector<int> polledPartitions;
+        for(size_t partition = 0; partition < channels.size(); partition++) {
+            if (!finished[partition]) {
+                polled.push_back(pollfd{channels[partition], POLLIN, 0});
+                polledPartitions.push_back(partition);
+            }
+        }
+
+        if (poll(polled.data(), polled.size(), -1) < 0) {
+            if (errno != EINTR) {
+                error = "imposible to wait for the controller processes";
+            }
+            continue;
+        }
+
+        for(size_t i = 0; i < polled.size() && error.empty(); i++) {
+            if (polled[i].revents == 0) {
+                continue;
+            }
+
+            int partition = polledPartitions[i];
+            PartitionActuatorsInterface::Message message;
+            if (!PartitionActuatorsInterface::receiveAll(channels[partition], &message, sizeof(message))) {
+                error = "controller process of partition " + std::to_string(partition) + " ended without finishing";
+            } else if (message.type == PartitionActuatorsInterface::VALUE) {
+                for(size_t other = 0; other < channels.size(); other++) {
+                    if ((int) other != partition && !finished[other]) {
+                        PartitionActuatorsInterface::sendAll(channels[other], &message, sizeof(message));
+                    }
+                }
+                relayedValues++;
+            } else if (message.type == PartitionActuatorsInterface::DONE) {
+                journals[partition].resize(message.index);
+                if (!PartitionActuatorsInterface::receiveAll(channels[partition], journals[partition].data(),
+                                                             message.index * sizeof(std::uint64_t)))
+                {
+                    error = "imposible to receive the journal of partition " + std::to_string(partition);
+                }
+                finished[partition] = true;
+                running--;
+            } else {
+                std::string text(message.index, '\0');
+                PartitionActuatorsInterface::receiveAll(channels[partition], &text[0], text.size());
+                error = "partition " + std::to_string(partition) + " failed: " + text;
+            }
+        }
+    }
+
+    for(size_t partition = 0; partition < processes.size(); partition++) {
+        if (!error.empty() || channels.size() != (size_t) partitions) {
+            kill(processes[partition], SIGKILL);
+        }
+        close(channels[partition]);
+
+        int status;
+        waitpid(processes[partition], &status, 0);
+    }
+
+    if (!error.empty()) {
+        throw(std::runtime_error(error));
+    }
+#endif
+}
@@ -0,0 +1,68 @@
+#ifndef PARTITIONEDEXECUTOR_H
+#define PARTITIONEDEXECUTOR_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <protocolGraph/ProtocolGraph.h>
+
+#include "partitionactuatorsinterface.h"
+
+/**
+ * Executes a protocol split among several controller processes, each one owning some containers.
+ *
+ * The nodes of a ProtocolGraph can not be inspected to cut it by container, so every controller process
+ * executes its own copy of the graph (from the graph factory) against its own interface (from the interface
+ * factory) through a PartitionActuatorsInterface, which only lets through the calls on the containers of the
+ * partition. Containers not in the ownership map belong to partition 0. The processes are forked and joined
+ * to the coordinator, this process, by a Unix socket pair; the only messages are the values read by the
+ * owner of a container, relayed by the coordinator to the other partitions, so the copies take the same
+ * branches and stay in the order of a single process execution, given back by the journals.
+ *
+ * The finish function is called in every controller process after the execution, with its interface, to
+ * store whatever it has to keep: the process ends right after. Only available on POSIX systems.
+ */
+class PartitionedExecutor
+{
+public:
+    typedef std::function<std::shared_ptr<ProtocolGraph>()> GraphFactory;
+    typedef std::function<std::shared_ptr<ActuatorsExecutionInterface>(int partition)> InterfaceFactory;
+    typedef std::function<void(int partition, ActuatorsExecutionInterface* actuatorInterface)> FinishFunction;
+
+    PartitionedExecutor(GraphFactory graphFactory,
+                        InterfaceFactory interfaceFactory,
+                        const std::map<std::string, int> & ownership,
+                        int partitions,
+                        FinishFunction finish = FinishFunction()) throw(std::invalid_argument);
+    virtual ~PartitionedExecutor();
+
+    void execute() throw(std::runtime_error);
+
+    inline const std::vector<std::uint64_t> & getJournal(int partition) const {
+        return journals[partition];
+    }
+
+    inline unsigned long long getRelayedValues() const {
+        return relayedValues;
+    }
+
+protected:
+    GraphFactory graphFactory;
+    InterfaceFactory interfaceFactory;
+    std::map<std::string, int> ownership;
+    int partitions;
+    FinishFunction finish;
+
+    std::vector<std::vector<std::uint64_t>> journals;
+    unsigned long long relayedValues;
+
+    int runPartition(int partition, int channel);
+    void coordinate(const std::vector<int> & channels, const std::vector<int> & processes) throw(std::runtime_error);
+};
+
+#endif // PARTITIONEDEXECUTOR_H
@@ -0,0 +1,461 @@
+#include "protocolanalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+#include "protocoljson.h"
+
+namespace {
+
+bool isLinked(const nlohmann::json & block) {
+    if (block.count("linked") > 0 && block["linked"].get<std::string>() == "TRUE") {
+        return true;
+    }
+    if (block.count("timeOfOperation") == 0) {
+        return true;
+    }
+    return std::stod(block["timeOfOperation"].get<std::string>()) < 0;
+}
+
+}
+
+ProtocolAnalyzer::ProtocolAnalyzer(unsigned int maxLoopIterations) :
+    maxLoopIterations(maxLoopIterations)
+{
+
+}
+
+ProtocolAnalyzer::~ProtocolAnalyzer()
+{
+
+}
+
+ProtocolAnalyzer::ProtocolAnalysis ProtocolAnalyzer::analyzeFile(const std::string & path) throw(std::invalid_argument) {
+    return analyze(ProtocolJson::read(path));
+}
+
+ProtocolAnalyzer::ProtocolAnalysis ProtocolAnalyzer::analyze(const nlohmann::json & protocol) throw(std::invalid_argument) {
+    analysis = ProtocolAnalysis();
+    constants.clear();
+    flows.clear();
+    branchStack.clear();
+
+    if (protocol.count("linkedBlocks") == 0) {
+        throw(std::invalid_argument("protocol without linkedBlocks"));
+    }
+
+    try {
+        for(const nlohmann::json & track: protocol["linkedBlocks"]) {
+            Bounds end = analyzeSequence(track, Bounds{0, 0}, -1, false);
+            analysis.minDuration = std::max(analysis.minDuration, end.min);
+            analysis.maxDuration = std::max(analysis.maxDuration, end.max);
+        }
+    } catch (std::invalid_argument & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument(std::string("malformed protocol: ") + e.what()));
+    }
+
+    computeLatestStarts();
+    computeCriticalPath();
+    computeOccupancy();
+    computeFlowConflicts();
+    return analysis;
+}
+
+ProtocolAnalyzer::Bounds ProtocolAnalyzer::analyzeSequence(
+        const nlohmann::json & blocks,
+        Bounds start,
+        int parent,
+        bool conditional) throw(std::invalid_argument)
+{
+    if (ProtocolJson::isBlock(blocks)) {
+        nlohmann::json sequence = nlohmann::json::array();
+        sequence.push_back(blocks);
+        return analyzeSequence(sequence, start, parent, conditional);
+    }
+
+    Bounds cursor = start;
+    int predecessor = -1;
+    for(const nlohmann::json & block: blocks) {
+        bool linked = isLinked(block);
+
+        Bounds blockStart = cursor;
+        if (!linked) {
+            TickTimebase::Ticks time = ProtocolJson::timeToTicks(block, "timeOfOperation", "timeOfOperation_units");
+            blockStart = Bounds{time, time};
+        }
+
+        int id;
+        Bounds duration = analyzeBlock(block, blockStart, linked ? predecessor : -1, parent, conditional, id);
+        cursor = Bounds{blockStart.min + duration.min, TickTimebase::add(blockStart.max, duration.max)};
+        predecessor = id;
+    }
+    return cursor;
+}
+
+ProtocolAnalyzer::Bounds ProtocolAnalyzer::analyzeBlock(
+        const nlohmann::json & block,
+        Bounds start,
+        int predecessor,
+        int parent,
+        bool conditional,
+        int & id) throw(std::invalid_argument)
+{
+    id = analysis.operations.size();
+
+    AnalyzedOperation operation;
+    operation.id = id;
+    operation.parent = parent;
+    operation.predecessor = predecessor;
+    operation.blockType = block["block_type"].get<std::string>();
+    operation.earliestStart = start.min;
+    operation.maxStart = start.max;
+    operation.latestStart = start.max;
+    operation.slack = 0;
+    operation.conditional = conditional;
+    collectContainers(block, operation.containers);
+    analysis.operations.push_back(operation);
+
+    Bounds duration;
+    const std::string & type = operation.blockType;
+    if (type == "controls_if") {
+        duration = ifDuration(block, start, id);
+    } else if (type == "controls_whileUntil") {
+        duration = loopDuration(block, start, id);
+    } else {
+        duration = blockDuration(block);
+    }
+
+    if (type == "variables_set") {
+        double value = evaluateConstant(block["value"]);
+        if (!conditional && !std::isnan(value)) {
+            constants[block["variable"].get<std::string>()] = value;
+        } else {
+            constants.erase(block["variable"].get<std::string>());
+        }
+    } else if (type == "continuous_flow") {
+        collectFlows(block, id);
+    }
+
+    analysis.operations[id].minEnd = start.min + duration.min;
+    analysis.operations[id].maxEnd = TickTimebase::add(start.max, duration.max);
+    return duration;
+}
+
+ProtocolAnalyzer::Bounds ProtocolAnalyzer::blockDuration(const nlohmann::json & block) throw(std::invalid_argument) {
+    const std::string type = block["block_type"].get<std::string>();
+    if (block.count("duration") > 0) {
+        TickTimebase::Ticks duration = ProtocolJson::timeToTicks(block, "duration", "duration_units");
+        return Bounds{duration, duration};
+    } else if (type == "thermocycling") {
+        return thermocyclingDuration(block);
+    } else if (type == "variables_set") {
+        return Bounds{0, 0};
+    }
+    // pipette and the like: the duration is only known when the backend executes it
+    return Bounds{0, TickTimebase::UNBOUNDED};
+}
+
+ProtocolAnalyzer::Bounds ProtocolAnalyzer::loopDuration(const nlohmann::json & block, Bounds start, int id) throw(std::invalid_argument) {
+    if (block.count("branches") == 0) {
+        return Bounds{0, 0};
+    }
+
+    size_t firstBodyOperation = analysis.operations.size();
+    Bounds bodyEnd = analyzeSequence(block["branches"], start, id, true);
+    TickTimebase::Ticks bodyMax = TickTimebase::UNBOUNDED;
+    if (start.max != TickTimebase::UNBOUNDED && bodyEnd.max != TickTimebase::UNBOUNDED) {
+        bodyMax = bodyEnd.max - start.max;
+    }
+
+    TickTimebase::Ticks loopMax = TickTimebase::UNBOUNDED;
+    TickTimebase::Ticks laterIterations = TickTimebase::UNBOUNDED;
+    if (maxLoopIterations > 0 && bodyMax != TickTimebase::UNBOUNDED) {
+        loopMax = TickTimebase::multiply(bodyMax, maxLoopIterations);
+        laterIterations = TickTimebase::multiply(bodyMax, maxLoopIterations - 1);
+    }
+
+    // the body may run again after the first iteration, shift its upper bounds
+    for(size_t i = firstBodyOperation; i < analysis.operations.size(); i++) {
+        analysis.operations[i].maxStart = TickTimebase::add(analysis.operations[i].maxStart, laterIterations);
+        analysis.operations[i].maxEnd = TickTimebase::add(analysis.operations[i].maxEnd, laterIterations);
+    }
+    return Bounds{0, loopMax};
+}
+
+ProtocolAnalyzer::Bounds ProtocolAnalyzer::ifDuration(const nlohmann::json & block, Bounds start, int id) throw(std::invalid_argument) {
+    Bounds duration{TickTimebase::UNBOUNDED, 0};
+
+    int branchNumber = 0;
+    if (block.count("branches") > 0) {
+        for(const nlohmann::json & branch: block["branches"]) {
+            Bounds end = start;
+            branchStack.push_back(std::make_pair(id, branchNumber));
+            if (branch.count("nestedOp") > 0) {
+                end = analyzeSequence(branch["nestedOp"], start, id, true);
+            }
+            branchStack.pop_back();
+
+            duration.min = std::min(duration.min, end.min - start.min);
+            duration.max = std::max(duration.max, end.max == TickTimebase::UNBOUNDED ? TickTimebase::UNBOUNDED : end.max - start.max);
+            branchNumber++;
+        }
+    }
+
+    if (block.count("else") > 0) {
+        branchStack.push_back(std::make_pair(id, branchNumber));
+        Bounds end = analyzeSequence(block["else"], start, id, true);
+        branchStack.pop_back();
+
+        duration.min = std::min(duration.min, end.min - start.min);
+        duration.max = std::max(duration.max, end.max == TickTimebase::UNBOUNDED ? TickTimebase::UNBOUNDED : end.max - start.max);
+    } else {
+        // no branch taken
+        duration.min = 0;
+    }
+    return duration;
+}
+
+ProtocolAnalyzer::Bounds ProtocolAnalyzer::thermocyclingDuration(const nlohmann::json & block) throw(std::invalid_argument) {
+    double cycles = evaluateConstant(block["cycles"]);
+    if (std::isnan(cycles)) {
+        return Bounds{0, TickTimebase::UNBOUNDED};
+    }
+
+    const nlohmann::json & source = block["source"];
+    int steps = std::stoi(source["steps"].get<std::string>());
+    TickTimebase::Ticks cycle = 0;
+    for(int i = 0; i < steps; i++) {
+        cycle += ProtocolJson::timeToTicks(source, "duration" + std::to_string(i), "duration_units" + std::to_string(i));
+    }
+    TickTimebase::Ticks duration = TickTimebase::multiply(cycle, (std::uint64_t) std::max(0.0, std::round(cycles)));
+    return Bounds{duration, duration};
+}
+
+double ProtocolAnalyzer::evaluateConstant(const nlohmann::json & expression) const {
+    if (!ProtocolJson::isBlock(expression)) {
+        return std::nan("");
+    }
+
+    const std::string type = expression["block_type"].get<std::string>();
+    if (type == "math_number") {
+        return std::stod(expression["value"].get<std::string>());
+    } else if (type == "variables_get") {
+        auto it = constants.find(expression["variable"].get<std::string>());
+        return it != constants.end() ? it->second : std::nan("");
+    } else if (type == "math_arithmetic") {
+        double left = evaluateConstant(expression["left"]);
+        double rigth = evaluateConstant(expression["rigth"]);
+        const std::string op = expression["op"].get<std::string>();
+        if (op == "ADD") {
+            return left + rigth;
+        } else if (op == "MINUS") {
+            return left - rigth;
+        } else if (op == "MULTIPLY") {
+            return left * rigth;
+        } else if (op == "DIVIDE") {
+            return left / rigth;
+        }
+    }
+    return std::nan("");
+}
+
+void ProtocolAnalyzer::collectContainers(const nlohmann::json & value, std::vector<std::string> & containers) const {
+    if (ProtocolJson::isBlock(value, "container")) {
+        std::string name = value["containerName"].get<std::string>();
+        if (std::find(containers.begin(), containers.end(), name) == containers.end()) {
+            containers.push_back(name);
+        }
+    } else if (value.is_object()) {
+        for(auto it = value.begin(); it != value.end(); ++it) {
+            // nested operations are analyzed, and own their containers, separately
+            if (it.key() != "branches" && it.key() != "nestedOp" && it.key() != "else") {
+                collectContainers(it.value(), containers);
+            }
+        }
+    } else if (value.is_array()) {
+        for(const nlohmann::json & element: value) {
+            collectContainers(element, containers);
+        }
+    }
+}
+
+void ProtocolAnalyzer::collectFlows(const nlohmann::json & block, int id) {
+    const std::vector<std::string> & containers = analysis.operations[id].containers;
+    for(size_t i = 0; i + 1 < containers.size(); i++) {
+        FlowInterval flow;
+        flow.source = containers[i];
+        flow.target = containers[i + 1];
+        flow.operation = id;
+        flow.branches = branchStack;
+        flows.push_back(flow);
+    }
+}
+
+void ProtocolAnalyzer::computeLatestStarts() {
+    std::vector<int> successors(analysis.operations.size(), -1);
+    std::map<int, std::vector<int>> children;
+    for(const AnalyzedOperation & operation: analysis.operations) {
+        if (operation.predecessor != -1) {
+            successors[operation.predecessor] = operation.id;
+        }
+        children[operation.parent].push_back(operation.id);
+    }
+    computeLatestStarts(children, successors, -1, analysis.maxDuration);
+}
+
+void ProtocolAnalyzer::computeLatestStarts(
+        const std::map<int, std::vector<int>> & children,
+        const std::vector<int> & successors,
+        int parent,
+        TickTimebase::Ticks latestFinish)
+{
+    auto it = children.find(parent);
+    if (it == children.end()) {
+        return;
+    }
+
+    // ids grow along a sequence, the successor of a block is always done before it
+    for(auto child = it->second.rbegin(); child != it->second.rend(); ++child) {
+        AnalyzedOperation & operation = analysis.operations[*child];
+
+        TickTimebase::Ticks finish = latestFinish;
+        if (successors[operation.id] != -1) {
+            finish = std::min(finish, analysis.operations[successors[operation.id]].latestStart);
+        }
+        computeLatestStarts(children, successors, operation.id, finish);
+
+        if (finish == TickTimebase::UNBOUNDED) {
+            operation.latestStart = TickTimebase::UNBOUNDED;
+            operation.slack = TickTimebase::UNBOUNDED;
+        } else if (operation.maxEnd == TickTimebase::UNBOUNDED || operation.maxStart == TickTimebase::UNBOUNDED) {
+            operation.latestStart = operation.maxStart;
+            operation.slack = 0;
+        } else {
+            operation.latestStart = finish - (operation.maxEnd - operation.maxStart);
+            operation.slack = operation.latestStart - operation.maxStart;
+        }
+    }
+}
+
+void ProtocolAnalyzer::computeCriticalPath() {
+    int last = -1;
+    for(const AnalyzedOperation & operation: analysis.operations) {
+        if (operation.parent == -1) {
+            if (last == -1 ||
+                    operation.maxEnd > analysis.operations[last].maxEnd ||
+                    (operation.maxEnd == analysis.operations[last].maxEnd &&
+                     operation.minEnd >= analysis.operations[last].minEnd))
+            {
+                last = operation.id;
+            }
+        }
+    }
+
+    for(int id = last; id != -1; id = analysis.operations[id].predecessor) {
+        analysis.criticalPath.push_back(id);
+    }
+    std::reverse(analysis.criticalPath.begin(), analysis.criticalPath.end());
+}
+
+void ProtocolAnalyzer::computeOccupancy() {
+    for(const AnalyzedOperation & operation: analysis.operations) {
+        for(const std::string & container: operation.containers) {
+            analysis.occupancy[container].push_back(OccupancyInterval{operation.id, operation.earliestStart, operation.maxEnd});
+        }
+    }
+
+    for(auto & entry: analysis.occupancy) {
+        std::sort(entry.second.begin(), entry.second.end(),
+                  [](const OccupancyInterval & a, const OccupancyInterval & b) { return a.start < b.start; });
+    }
+}
+
+void ProtocolAnalyzer::computeFlowConflicts() {
+    const std::vector<AnalyzedOperation> & operations = analysis.operations;
+
+    std::map<std::string, std::vector<const FlowInterval*>> bySource;
+    for(const FlowInterval & flow: flows) {
+        bySource[flow.source].push_back(&flow);
+    }
+
+    typedef struct Endpoint_ {
+        TickTimebase::Ticks at;
+        bool start;
+        size_t flow;
+    } Endpoint;
+
+    for(auto & entry: bySource) {
+        const std::vector<const FlowInterval*> & sourceFlows = entry.second;
+
+        std::vector<Endpoint> endpoints;
+        for(size_t i = 0; i < sourceFlows.size(); i++) {
+            const AnalyzedOperation & operation = operations[sourceFlows[i]->operation];
+            endpoints.push_back(Endpoint{operation.earliestStart, true, i});
+            if (operation.maxEnd != TickTimebase::UNBOUNDED && operation.maxEnd > operation.earliestStart) {
+                endpoints.push_back(Endpoint{operation.maxEnd, false, i});
+            }
+        }
+        // at the same instant ends go before starts, so a restart is not taken as an overlap
+        std::sort(endpoints.begin(), endpoints.end(), [](const Endpoint & a, const Endpoint & b) {
+            if (a.at != b.at) {
+                return a.at < b.at;
+            } else if (a.start != b.start) {
+                return !a.start;
+            }
+            return a.flow < b.flow;
+        });
+
+        std::set<size_t> active;
+        std::vector<size_t> endedNow;
+        TickTimebase::Ticks endedAt = -1;
+        for(const Endpoint & endpoint: endpoints) {
+            if (endpoint.at != endedAt) {
+                endedNow.clear();
+                endedAt = endpoint.at;
+            }
+
+            if (!endpoint.start) {
+                active.erase(endpoint.flow);
+                endedNow.push_back(endpoint.flow);
+                continue;
+            }
+
+            const FlowInterval* second = sourceFlows[endpoint.flow];
+            for(size_t index: active) {
+                const FlowInterval* first = sourceFlows[index];
+                if (!exclusiveFlows(first, second)) {
+                    analysis.flowConflicts.push_back(
+                                FlowConflict{entry.first, first->target, second->target, first->operation, second->operation, endpoint.at});
+                }
+            }
+            for(size_t index: endedNow) {
+                const FlowInterval* first = sourceFlows[index];
+                if (first->target == second->target && !exclusiveFlows(first, second)) {
+                    analysis.flowRestarts.push_back(
+                                FlowConflict{entry.first, first->target, second->target, first->operation, second->operation, endpoint.at});
+                }
+            }
+
+            if (operations[second->operation].maxEnd == endpoint.at) {
+                endedNow.push_back(endpoint.flow);
+            } else {
+                active.insert(endpoint.flow);
+            }
+        }
+    }
+}
+
+bool ProtocolAnalyzer::exclusiveFlows(const FlowInterval* first, const FlowInterval* second) const {
+    // flows in different branches of the same if never run together
+    for(const std::pair<int, int> & branch: first->branches) {
+        for(const std::pair<int, int> & other: second->branches) {
+            if (branch.first == other.first && branch.second != other.second) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,122 @@
+#ifndef PROTOCOLANALYZER_H
+#define PROTOCOLANALYZER_H
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <json.hpp>
+
+#include "ticktimebase.h"
+
+/**
+ * Static timing and resource analysis of a BioBlocks protocol, done before translation.
+ *
+ * The ProtocolGraph built by BioBlocksTranslator does not expose operation durations nor containers, so
+ * the analysis runs over the same json the translator reads. Every block is visited once:
+ *  - start and end times are bounds, in ticks: unknown durations (pipette) and loops give an unbounded
+ *    upper bound,
+ *    ifs give the shortest and the longest branch,
+ *  - a backward pass over the upper bounds gives the latest start of every block that does not delay the
+ *    end of the protocol, and its slack; nested blocks must finish before the block that contains them,
+ *  - the critical path is the chain of linked blocks that ends last under the upper bounds,
+ *  - occupancy intervals are kept per container and continuous flows that pump from the same source at
+ *    the same time are reported as conflicts; a flow stopped and restarted on the same pump at the same
+ *    instant (as the evoprog switching does) is reported as a restart. Flows are swept by their endpoints,
+ *    so a flow without an upper bound does not make the scan quadratic.
+ */
+class ProtocolAnalyzer
+{
+public:
+    typedef struct AnalyzedOperation_ {
+        int id;
+        int parent;
+        int predecessor;
+        std::string blockType;
+        std::vector<std::string> containers;
+        TickTimebase::Ticks earliestStart;
+        TickTimebase::Ticks maxStart;
+        TickTimebase::Ticks latestStart;
+        TickTimebase::Ticks slack;
+        TickTimebase::Ticks minEnd;
+        TickTimebase::Ticks maxEnd;
+        bool conditional;
+    } AnalyzedOperation;
+
+    typedef struct OccupancyInterval_ {
+        int operation;
+        TickTimebase::Ticks start;
+        TickTimebase::Ticks end;
+    } OccupancyInterval;
+
+    typedef struct FlowConflict_ {
+        std::string source;
+        std::string firstTarget;
+        std::string secondTarget;
+        int firstOperation;
+        int secondOperation;
+        TickTimebase::Ticks at;
+    } FlowConflict;
+
+    typedef struct ProtocolAnalysis_ {
+        std::vector<AnalyzedOperation> operations;
+        TickTimebase::Ticks minDuration = 0;
+        TickTimebase::Ticks maxDuration = 0;
+        std::vector<int> criticalPath;
+        std::map<std::string, std::vector<OccupancyInterval>> occupancy;
+        std::vector<FlowConflict> flowConflicts;
+        std::vector<FlowConflict> flowRestarts;
+    } ProtocolAnalysis;
+
+    ProtocolAnalyzer(unsigned int maxLoopIterations = 0);
+    virtual ~ProtocolAnalyzer();
+
+    ProtocolAnalysis analyzeFile(const std::string & path) throw(std::invalid_argument);
+    ProtocolAnalysis analyze(const nlohmann::json & protocol) throw(std::invalid_argument);
+
+protected:
+    typedef struct Bounds_ {
+        TickTimebase::Ticks min;
+        TickTimebase::Ticks max;
+    } Bounds;
+
+    typedef struct FlowInterval_ {
+        std::string source;
+        std::string target;
+        int operation;
+        std::vector<std::pair<int, int>> branches;
+    } FlowInterval;
+
+    unsigned int maxLoopIterations;
+
+    ProtocolAnalysis analysis;
+    std::map<std::string, double> constants;
+    std::vector<FlowInterval> flows;
+    std::vector<std::pair<int, int>> branchStack;
+
+    Bounds analyzeSequence(const nlohmann::json & blocks, Bounds start, int parent, bool conditional) throw(std::invalid_argument);
+    Bounds analyzeBlock(const nlohmann::json & block, Bounds start, int predecessor, int parent, bool conditional, int & id) throw(std::invalid_argument);
+
+    Bounds blockDuration(const nlohmann::json & block) throw(std::invalid_argument);
+    Bounds loopDuration(const nlohmann::json & block, Bounds start, int id) throw(std::invalid_argument);
+    Bounds ifDuration(const nlohmann::json & block, Bounds start, int id) throw(std::invalid_argument);
+    Bounds thermocyclingDuration(const nlohmann::json & block) throw(std::invalid_argument);
+
+    double evaluateConstant(const nlohmann::json & expression) const;
+    void collectContainers(const nlohmann::json & value, std::vector<std::string> & containers) const;
+    void collectFlows(const nlohmann::json & block, int id);
+
+    void computeLatestStarts();
+    void computeLatestStarts(const std::map<int, std::vector<int>> & children,
+                             const std::vector<int> & successors,
+                             int parent,
+                             TickTimebase::Ticks latestFinish);
+    void computeCriticalPath();
+    void computeOccupancy();
+    void computeFlowConflicts();
+    bool exclusiveFlows(const FlowInterval* first, const FlowInterval* second) const;
+};
+
+#endif // PROTOCOLANALYZER_H
@@ -0,0 +1,133 @@
+#include "protocolcorpusrunner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#include <bioblocksTranslation/bioblockstranslator.h>
+
+#include "protocolexecutor.h"
+#include "protocoljson.h"
+#include "stringactuatorsinterface.h"
+#include "tracecomparator.h"
+
+ProtocolCorpusRunner::ProtocolCorpusRunner(unsigned int threads) :
+    threads(threads)
+{
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+ProtocolCorpusRunner::~ProtocolCorpusRunner()
+{
+
+}
+
+std::vector<ProtocolCorpusRunner::ProtocolCase> ProtocolCorpusRunner::readManifest(const nlohmann::json & manifest) throw(std::invalid_argument) {
+    if (!manifest.is_object() || manifest.count("cases") == 0 || !manifest["cases"].is_array()) {
+        throw(std::invalid_argument("manifest without cases array"));
+    }
+
+    std::vector<ProtocolCase> cases;
+    for(const nlohmann::json & entry: manifest["cases"]) {
+        if (entry.count("name") == 0 || entry.count("protocol") == 0 || entry.count("golden") == 0 || entry.count("timeSliceMs") == 0) {
+            throw(std::invalid_argument("manifest case without name, protocol, golden or timeSliceMs: " + entry.dump()));
+        }
+
+        ProtocolCase protocolCase;
+        protocolCase.name = entry["name"].get<std::string>();
+        if (entry.count("description") > 0 && entry["description"].is_array()) {
+            for(const nlohmann::json & line: entry["description"]) {
+                protocolCase.description += line.get<std::string>() + "\n";
+            }
+        } else if (entry.count("description") > 0) {
+            protocolCase.description = entry["description"].get<std::string>();
+        }
+        protocolCase.protocol = entry["protocol"].get<std::string>();
+        protocolCase.golden = entry["golden"].get<std::string>();
+        protocolCase.timeSliceMs = entry["timeSliceMs"].get<double>();
+        if (entry.count("measurements") > 0) {
+            protocolCase.measurements = entry["measurements"].get<std::vector<double>>();
+        }
+        cases.push_back(protocolCase);
+    }
+    return cases;
+}
+
+std::vector<ProtocolCorpusRunner::ProtocolCase> ProtocolCorpusRunner::readManifest(const std::string & path) throw(std::invalid_argument) {
+    return readManifest(ProtocolJson::read(path));
+}
+
+std::vector<ProtocolCorpusRunner::CaseResult> ProtocolCorpusRunner::run(const std::vector<ProtocolCase> & cases, const std::string & baseDir) const {
+    std::vector<CaseResult> results(cases.size());
+    std::atomic<size_t> nextCase(0);
+
+    auto worker = [&]() {
+        for(size_t i = nextCase++; i < cases.size(); i = nextCase++) {
+            results[i] = runCase(cases[i], baseDir);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(unsigned int i = 1; i < std::min<size_t>(threads, cases.size()); i++) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+
+    for(std::thread & thread: workers) {
+        thread.join();
+    }
+    return results;
+}
+
+ProtocolCorpusRunner::CaseResult ProtocolCorpusRunner::runCase(const ProtocolCase & protocolCase, const std::string & baseDir) const {
+    CaseResult result;
+    result.name = protocolCase.name;
+    result.passed = false;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::string protocolPath = baseDir + "/" + protocolCase.protocol;
+    try {
+        std::ifstream golden(baseDir + "/" + protocolCase.golden, std::ios::binary);
+        if (!golden.is_open()) {
+            throw(std::invalid_argument("imposible to open " + protocolCase.golden));
+        }
+
+        BioBlocksTranslator translator(protocolCase.timeSliceMs * units::ms, protocolPath);
+        std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
+
+        TraceComparator comparator(golden);
+        std::ostream output(&comparator);
+        StringActuatorsInterface interface(protocolCase.measurements, &output);
+
+        ProtocolExecutor executor(protocol, &interface);
+        while(!comparator.hasDiverged() && executor.executeNextNode());
+
+        result.passed = comparator.finish();
+        result.report = comparator.report();
+    } catch (std::exception & e) {
+        result.report = e.what();
+    }
+
+    if (!result.passed) {
+        // executed again from scratch, keeping everything this time
+        try {
+            BioBlocksTranslator translator(protocolCase.timeSliceMs * units::ms, protocolPath);
+            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
+
+            StringActuatorsInterface interface(protocolCase.measurements);
+            ProtocolExecutor executor(protocol, &interface);
+            executor.execute();
+
+            result.dump = "protocol:\n" + protocol->toString() + "\nexecution:\n" + interface.getStream().str();
+        } catch (std::exception & e) {
+            result.dump = std::string("imposible to dump the case: ") + e.what();
+        }
+    }
+
+    result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef PROTOCOLCORPUSRUNNER_H
+#define PROTOCOLCORPUSRUNNER_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+/**
+ * Runs the protocol corpus described by a manifest, several cases at a time.
+ *
+ * Every case of the manifest names a protocol file, the time slice, the series of values returned by the
+ * measurements and a golden trace:
+ *      {"name": "loop", "protocol": "loop.json", "timeSliceMs": 200,
+ *       "measurements": [200, 400], "golden": "golden/loop.rle"}
+ * An optional "description", a string or an array of lines, tells what the protocol does. Paths are
+ * relative to the directory given to run(). Each case gets its own translator, executor and
+ * actuators interface, and worker threads take the next pending case as soon as they are free, so the
+ * whole run takes about as long as the slowest case. The execution is compared with the golden trace
+ * while it runs; the protocol graph and the full execution are only dumped for the failing cases.
+ */
+class ProtocolCorpusRunner
+{
+public:
+    typedef struct ProtocolCase_ {
+        std::string name;
+        std::string description;
+        std::string protocol;
+        std::string golden;
+        double timeSliceMs;
+        std::vector<double> measurements;
+    } ProtocolCase;
+
+    typedef struct CaseResult_ {
+        std::string name;
+        bool passed;
+        std::string report;
+        std::string dump;
+        double durationMs;
+    } CaseResult;
+
+    ProtocolCorpusRunner(unsigned int threads = 0);
+    virtual ~ProtocolCorpusRunner();
+
+    static std::vector<ProtocolCase> readManifest(const nlohmann::json & manifest) throw(std::invalid_argument);
+    static std::vector<ProtocolCase> readManifest(const std::string & path) throw(std::invalid_argument);
+
+    std::vector<CaseResult> run(const std::vector<ProtocolCase> & cases, const std::string & baseDir) const;
+    CaseResult runCase(const ProtocolCase & protocolCase, const std::string & baseDir) const;
+
+protected:
+    unsigned int threads;
+};
+
+#endif // PROTOCOLCORPUSRUNNER_H
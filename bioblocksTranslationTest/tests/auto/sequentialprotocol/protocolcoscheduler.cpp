@@ -0,0 +1,96 @@
+#include "protocolcoscheduler.h"
+
+ProtocolCoScheduler::ProtocolCoScheduler(ActuatorsExecutionInterface* actuatorInterface) :
+    actuatorInterface(actuatorInterface)
+{
+    timeSliceSet = false;
+    sharedSlices = 0;
+    mergedTimeSteps = 0;
+}
+
+ProtocolCoScheduler::~ProtocolCoScheduler()
+{
+
+}
+
+void ProtocolCoScheduler::addProtocol(
+        const std::string & name,
+        std::shared_ptr<ProtocolGraph> protocol,
+        const std::map<std::string, std::string> & containerMapping,
+        const std::vector<std::string> & containers) throw(std::invalid_argument)
+{
+    for(const ScheduledProtocol & scheduled: protocols) {
+        if (scheduled.name == name) {
+            throw(std::invalid_argument("protocol " + name + " already added"));
+        }
+    }
+
+    std::map<std::string, std::string> mapping = containerMapping;
+    for(const std::string & container: containers) {
+        mapping.insert(std::make_pair(container, name + "." + container));
+    }
+
+    try {
+        claimContainers(name, mapping);
+    } catch (std::runtime_error & e) {
+        throw(std::invalid_argument(e.what()));
+    }
+
+    ScheduledProtocol scheduled;
+    scheduled.name = name;
+    scheduled.interface = std::make_shared<ResourceMappingActuatorsInterface>(actuatorInterface, this, name, mapping);
+    scheduled.executor = std::make_shared<ProtocolExecutor>(protocol, scheduled.interface.get());
+    protocols.push_back(scheduled);
+}
+
+void ProtocolCoScheduler::execute() throw(std::runtime_error) {
+    bool running = true;
+    while(running) {
+        running = false;
+
+        unsigned int waiting = 0;
+        for(ScheduledProtocol & scheduled: protocols) {
+            while(!scheduled.interface->isWaitingSlice() && scheduled.executor->executeNextNode());
+
+            if (scheduled.interface->isWaitingSlice()) {
+                waiting++;
+            }
+            running = running || !scheduled.executor->hasFinished();
+        }
+
+        if (waiting > 0) {
+            actuatorInterface->timeStep();
+            sharedSlices++;
+            mergedTimeSteps += waiting - 1;
+
+            for(ScheduledProtocol & scheduled: protocols) {
+                scheduled.interface->sliceDone();
+            }
+        }
+    }
+}
+
+void ProtocolCoScheduler::claimContainers(
+        const std::string & protocolName,
+        const std::map<std::string, std::string> & containerMapping) throw(std::runtime_error)
+{
+    for(const auto & mapping: containerMapping) {
+        auto it = containerOwners.find(mapping.second);
+        if (it != containerOwners.end() && it->second != protocolName) {
+            throw(std::runtime_error("container " + mapping.second + " of " + protocolName + " already used by " + it->second));
+        }
+    }
+    for(const auto & mapping: containerMapping) {
+        containerOwners.insert(std::make_pair(mapping.second, protocolName));
+    }
+}
+
+void ProtocolCoScheduler::requestTimeStep(const std::string & protocolName, units::Time timeSlice) throw(std::runtime_error) {
+    if (!timeSliceSet) {
+        this->timeSlice = TickTimebase::fromTime(timeSlice);
+        this->timeSliceSet = true;
+        actuatorInterface->setTimeStep(timeSlice);
+    } else if (this->timeSlice != TickTimebase::fromTime(timeSlice)) {
+        throw(std::runtime_error("protocol " + protocolName + " uses a different time slice than the protocols already running"));
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef PROTOCOLCOSCHEDULER_H
+#define PROTOCOLCOSCHEDULER_H
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <protocolGraph/ProtocolGraph.h>
+
+#include "protocolexecutor.h"
+#include "resourcemappingactuatorsinterface.h"
+#include "ticktimebase.h"
+
+/**
+ * Runs several independent protocols on one instrument and one ActuatorsExecutionInterface.
+ *
+ * Every protocol gets its containers mapped onto physical containers no other protocol uses: the ones
+ * without an explicit mapping are prefixed with the protocol name, and all of them are claimed when the
+ * protocol is added, all or none, so a clash leaves the scheduler as it was. All the
+ * protocols share one timeline: each one runs until it asks for its next time step and then a single
+ * timeStep() is issued for all of them, so the number of timeStep() calls does not grow with the number
+ * of protocols. The protocols must use the same time slice.
+ */
+class ProtocolCoScheduler
+{
+public:
+    ProtocolCoScheduler(ActuatorsExecutionInterface* actuatorInterface);
+    virtual ~ProtocolCoScheduler();
+
+    void addProtocol(const std::string & name,
+                     std::shared_ptr<ProtocolGraph> protocol,
+                     const std::map<std::string, std::string> & containerMapping = std::map<std::string, std::string>(),
+                     const std::vector<std::string> & containers = std::vector<std::string>())
+        throw(std::invalid_argument);
+
+    void execute() throw(std::runtime_error);
+
+    void claimContainers(const std::string & protocolName, const std::map<std::string, std::string> & containerMapping) throw(std::runtime_error);
+    void requestTimeStep(const std::string & protocolName, units::Time timeSlice) throw(std::runtime_error);
+
+    inline unsigned long long getSharedSlices() const {
+        return sharedSlices;
+    }
+
+    inline unsigned long long getMergedTimeSteps() const {
+        return mergedTimeSteps;
+    }
+
+protected:
+    typedef struct ScheduledProtocol_ {
+        std::string name;
+        std::shared_ptr<ResourceMappingActuatorsInterface> interface;
+        std::shared_ptr<ProtocolExecutor> executor;
+    } ScheduledProtocol;
+
+    ActuatorsExecutionInterface* actuatorInterface;
+    std::vector<ScheduledProtocol> protocols;
+    std::map<std::string, std::string> containerOwners;
+
+    bool timeSliceSet;
+    TickTimebase::Ticks timeSlice;
+
+    unsigned long long sharedSlices;
+    unsigned long long mergedTimeSteps;
+};
+
+#endif // PROTOCOLCOSCHEDULER_H
@@ -0,0 +1,195 @@
+#include "protocolexecutor.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "readlogactuatorsinterface.h"
+
+ProtocolExecutor::ProtocolExecutor(std::shared_ptr<ProtocolGraph> protocol, ActuatorsExecutionInterface* actuatorInterface) :
+    protocol(protocol), stateInterface(actuatorInterface)
+{
+    nodes2process.push_back(protocol->getStart()->getContainerId());
+
+    slicesBetweenCheckpoints = 0;
+    lastCheckpointSlice = 0;
+    journaledReadLog = 0;
+    baseBytes = 0;
+    journalBytes = 0;
+
+    conditionCacheEnabled = false;
+    variablesEpoch = 0;
+    conditionEvaluations = 0;
+    conditionsSkipped = 0;
+}
+
+ProtocolExecutor::~ProtocolExecutor()
+{
+
+}
+
+void ProtocolExecutor::execute() {
+    while(executeNextNode());
+}
+
+bool ProtocolExecutor::executeNextNode() {
+    if (nodes2process.empty()) {
+        return false;
+    }
+
+    int nextId = nodes2process.back();
+    nodes2process.pop_back();
+
+    executeNode(nextId);
+    pushSuccessors(nextId);
+
+    checkpointIfNeeded();
+    return true;
+}
+
+void ProtocolExecutor::enableCheckpoints(const std::string & checkpointPath, unsigned int slicesBetweenCheckpoints) {
+    this->checkpointPath = checkpointPath;
+    this->slicesBetweenCheckpoints = slicesBetweenCheckpoints;
+    this->lastCheckpointSlice = stateInterface.getElapsedSlices();
+
+    journaledReadLog = 0;
+    baseBytes = 0;
+    journalBytes = 0;
+}
+
+void ProtocolExecutor::setVariableHooks(VariableCaptureFunction captureVariables, VariableRestoreFunction restoreVariables) {
+    this->captureVariables = captureVariables;
+    this->restoreVariables = restoreVariables;
+}
+
+void ProtocolExecutor::enableConditionCache(bool enabled) {
+    conditionCacheEnabled = enabled;
+    conditionCache.clear();
+}
+
+ExecutionCheckpoint ProtocolExecutor::makeCheckpoint() const {
+    ExecutionCheckpoint checkpoint;
+    stateInterface.fillCheckpoint(checkpoint);
+    checkpoint.frontier = nodes2process;
+    if (captureVariables) {
+        captureVariables(checkpoint.variables);
+    }
+    return checkpoint;
+}
+
+void ProtocolExecutor::resume(const ExecutionCheckpoint & checkpoint) throw(std::invalid_argument) {
+    if (restoreVariables) {
+        nodes2process = checkpoint.frontier;
+        restoreVariables(checkpoint.variables);
+    } else {
+        rebuild(checkpoint);
+    }
+    stateInterface.restore(checkpoint);
+    lastCheckpointSlice = checkpoint.elapsedSlices;
+    variablesEpoch++;
+
+    // the journal on disk does not follow this execution any more, the next checkpoint is a base
+    baseBytes = 0;
+    journalBytes = 0;
+}
+
+void ProtocolExecutor::resume(const std::string & checkpointPath) throw(std::invalid_argument) {
+    resume(ExecutionCheckpoint::load(checkpointPath));
+}
+
+void ProtocolExecutor::rebuild(const ExecutionCheckpoint & checkpoint) throw(std::invalid_argument) {
+    ReadLogActuatorsInterface readLogInterface(checkpoint.readLog);
+    stateInterface.startRebuild(&readLogInterface);
+    nodes2process.assign(1, protocol->getStart()->getContainerId());
+
+    try {
+        // the checkpoint was taken after a node, with the frontier it left: run until the same point
+        while(stateInterface.getElapsedSlices() != checkpoint.elapsedSlices ||
+              nodes2process != checkpoint.frontier ||
+              !readLogInterface.isConsumed())
+        {
+            if (nodes2process.empty() || stateInterface.getElapsedSlices() > checkpoint.elapsedSlices) {
+                throw(std::invalid_argument("imposible to resume, the checkpoint does not belong to this protocol"));
+            }
+
+            int nextId = nodes2process.back();
+            nodes2process.pop_back();
+            executeNode(nextId);
+            pushSuccessors(nextId);
+        }
+    } catch (...) {
+        stateInterface.finishRebuild();
+        throw;
+    }
+    stateInterface.finishRebuild();
+}
+
+void ProtocolExecutor::executeNode(int nodeId) {
+    if (protocol->isCpuOperation(nodeId)) {
+        protocol->getCpuOperation(nodeId)->execute();
+        variablesEpoch++;
+    } else if (protocol->isActuatorOperation(nodeId)) {
+        unsigned long long valuesRead = stateInterface.getValuesRead();
+        protocol->getActuatorOperation(nodeId)->execute(&stateInterface);
+        if (stateInterface.getValuesRead() != valuesRead) {
+            variablesEpoch++;
+        }
+    }
+}
+
+void ProtocolExecutor::pushSuccessors(int nodeId) {
+    ProtocolGraph::ProtocolEdgeVectorPtr leaving = protocol->getProjectingEdges(nodeId);
+    for(const ProtocolGraph::ProtocolEdgePtr & edge: *leaving.get()) {
+        if (conditionMet(edge)) {
+            int nextop = edge->getIdTarget();
+            if (find(nodes2process.begin(), nodes2process.end(), nextop) == nodes2process.end()) {
+                nodes2process.push_back(nextop);
+            }
+        }
+    }
+}
+
+bool ProtocolExecutor::conditionMet(const ProtocolGraph::ProtocolEdgePtr & edge) {
+    if (!conditionCacheEnabled) {
+        conditionEvaluations++;
+        return edge->conditionMet();
+    }
+
+    auto it = conditionCache.find(edge.get());
+    if (it != conditionCache.end() && it->second.first == variablesEpoch) {
+        conditionsSkipped++;
+        return it->second.second;
+    }
+
+    conditionEvaluations++;
+    bool met = edge->conditionMet();
+    conditionCache[edge.get()] = std::make_pair(variablesEpoch, met);
+    return met;
+}
+
+void ProtocolExecutor::checkpointIfNeeded() throw(std::runtime_error) {
+    if (slicesBetweenCheckpoints == 0) {
+        return;
+    }
+
+    // only at slice boundaries: the node that just ran issued the timeStep and its successors are queued
+    unsigned long long elapsed = stateInterface.getElapsedSlices();
+    if (elapsed - lastCheckpointSlice >= slicesBetweenCheckpoints) {
+        std::string journalPath = checkpointPath + ".journal";
+        if (journalBytes >= baseBytes) {
+            baseBytes = makeCheckpoint().save(checkpointPath);
+            std::remove(journalPath.c_str());
+            journalBytes = 0;
+        } else {
+            ExecutionCheckpoint record;
+            stateInterface.fillCheckpoint(record, journaledReadLog);
+            record.frontier = nodes2process;
+            if (captureVariables) {
+                captureVariables(record.variables);
+            }
+            journalBytes += record.append(journalPath);
+        }
+        // the last entry can still grow, it goes again in the next record
+        journaledReadLog = std::max(stateInterface.getReadLogEntries(), (size_t) 1) - 1;
+        lastCheckpointSlice = elapsed;
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef PROTOCOLEXECUTOR_H
+#define PROTOCOLEXECUTOR_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <protocolGraph/ProtocolGraph.h>
+
+#include "activestateactuatorsinterface.h"
+#include "executioncheckpoint.h"
+
+/**
+ * Executes a ProtocolGraph against an ActuatorsExecutionInterface, node by node.
+ *
+ * The frontier and the elapsed slices live in the object instead of on the stack, so the execution can be
+ * stepped, checkpointed every N slices and resumed from a checkpoint in a different process, on a graph
+ * translated again. A checkpoint appends to the journal only what changed since the previous one, and a new
+ * base is written once the journal outgrows the last one, so the bytes written per checkpoint do not grow
+ * with the elapsed time. With variable hooks the graph variables are restored through them; without hooks,
+ * as every translated graph, resuming is a replay: the graph runs again from the first slice against the
+ * read log of the checkpoint, answering every read with the value it got the first time and sending
+ * nothing to the backend, which costs as much as the execution up to the checkpoint minus the instrument.
+ * A checkpoint that this graph does not reach fails to resume.
+ *
+ * With the condition cache enabled an edge condition is not evaluated again while none of the variables
+ * of the graph can have changed: the cache is invalidated by every cpu operation and every actuator
+ * operation that read a new value from the backend. A time step hands back the same slice every time,
+ * so polling a condition slice after slice hits the cache. This relies on a graph that keeps the elapsed
+ * time in a variable adding it up in a cpu operation, which still invalidates the cache. ProtocolGraph does not expose which variables a
+ * condition reads, so any write invalidates every cached condition.
+ */
+class ProtocolExecutor
+{
+public:
+    typedef std::function<void(std::map<std::string, double> &)> VariableCaptureFunction;
+    typedef std::function<void(const std::map<std::string, double> &)> VariableRestoreFunction;
+
+    ProtocolExecutor(std::shared_ptr<ProtocolGraph> protocol, ActuatorsExecutionInterface* actuatorInterface);
+    virtual ~ProtocolExecutor();
+
+    void execute();
+    bool executeNextNode();
+
+    void enableCheckpoints(const std::string & checkpointPath, unsigned int slicesBetweenCheckpoints = 1);
+    void setVariableHooks(VariableCaptureFunction captureVariables, VariableRestoreFunction restoreVariables);
+    void enableConditionCache(bool enabled);
+
+    ExecutionCheckpoint makeCheckpoint() const;
+    void resume(const ExecutionCheckpoint & checkpoint) throw(std::invalid_argument);
+    void resume(const std::string & checkpointPath) throw(std::invalid_argument);
+
+    inline bool hasFinished() const {
+        return nodes2process.empty();
+    }
+
+    inline unsigned long long getElapsedSlices() const {
+        return stateInterface.getElapsedSlices();
+    }
+
+    inline TickTimebase::Ticks getElapsedTicks() const {
+        return stateInterface.getElapsedTicks();
+    }
+
+    inline const std::vector<int> & getFrontier() const {
+        return nodes2process;
+    }
+
+    inline unsigned long long getConditionEvaluations() const {
+        return conditionEvaluations;
+    }
+
+    inline unsigned long long getConditionsSkipped() const {
+        return conditionsSkipped;
+    }
+
+protected:
+    std::shared_ptr<ProtocolGraph> protocol;
+    ActiveStateActuatorsInterface stateInterface;
+    std::vector<int> nodes2process;
+
+    std::string checkpointPath;
+    unsigned int slicesBetweenCheckpoints;
+    unsigned long long lastCheckpointSlice;
+    size_t journaledReadLog;
+    size_t baseBytes;
+    size_t journalBytes;
+
+    VariableCaptureFunction captureVariables;
+    VariableRestoreFunction restoreVariables;
+
+    bool conditionCacheEnabled;
+    unsigned long long variablesEpoch;
+    std::map<const void*, std::pair<unsigned long long, bool>> conditionCache;
+    unsigned long long conditionEvaluations;
+    unsigned long long conditionsSkipped;
+
+    virtual void executeNode(int nodeId);
+    virtual void pushSuccessors(int nodeId);
+
+    bool conditionMet(const ProtocolGraph::ProtocolEdgePtr & edge);
+
+    void rebuild(const ExecutionCheckpoint & checkpoint) throw(std::invalid_argument);
+    void checkpointIfNeeded() throw(std::runtime_error);
+};
+
+#endif // PROTOCOLEXECUTOR_H
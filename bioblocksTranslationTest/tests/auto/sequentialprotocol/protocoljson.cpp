@@ -0,0 +1,84 @@
+#include "protocoljson.h"
+
+#include <algorithm>
+#include <fstream>
+
+nlohmann::json ProtocolJson::read(const std::string & path) throw(std::invalid_argument) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        throw(std::invalid_argument("imposible to open " + path));
+    }
+
+    nlohmann::json protocol;
+    try {
+        in >> protocol;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("error parsing " + path + ": " + e.what()));
+    }
+    return protocol;
+}
+
+void ProtocolJson::write(const nlohmann::json & protocol, const std::string & path) throw(std::invalid_argument) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw(std::invalid_argument("imposible to open " + path));
+    }
+    out << protocol.dump();
+}
+
+bool ProtocolJson::isBlock(const nlohmann::json & value) {
+    return value.is_object() && value.count("block_type") > 0;
+}
+
+bool ProtocolJson::isBlock(const nlohmann::json & value, const std::string & blockType) {
+    return isBlock(value) && value["block_type"].get<std::string>() == blockType;
+}
+
+std::vector<std::string> ProtocolJson::containerNames(const nlohmann::json & value) {
+    std::vector<std::string> names;
+    if (isBlock(value, "container")) {
+        names.push_back(value["containerName"].get<std::string>());
+    } else if (value.is_object() || value.is_array()) {
+        for(const nlohmann::json & element: value) {
+            for(const std::string & name: containerNames(element)) {
+                if (std::find(names.begin(), names.end(), name) == names.end()) {
+                    names.push_back(name);
+                }
+            }
+        }
+    }
+    return names;
+}
+
+TickTimebase::Ticks ProtocolJson::timeToTicks(const nlohmann::json & block, const std::string & valueKey, const std::string & unitsKey) throw(std::invalid_argument) {
+    if (block.count(valueKey) == 0 || block.count(unitsKey) == 0) {
+        throw(std::invalid_argument("block without " + valueKey + " or " + unitsKey));
+    }
+    return TickTimebase::parse(block[valueKey].get<std::string>(), block[unitsKey].get<std::string>());
+}
+
+double ProtocolJson::unitToMs(const std::string & units) throw(std::invalid_argument) {
+    if (units == "ms") {
+        return 1;
+    } else if (units == "s") {
+        return 1000;
+    } else if (units == "minute" || units == "min") {
+        return 60 * 1000;
+    } else if (units == "hr" || units == "h" || units == "hour") {
+        return 60 * 60 * 1000;
+    } else if (units == "day") {
+        return 24 * 60 * 60 * 1000;
+    }
+    throw(std::invalid_argument("unknown time units " + units));
+}
+
+double ProtocolJson::unitToHz(const std::string & units) throw(std::invalid_argument) {
+    if (units == "hz") {
+        return 1;
+    } else if (units == "khz") {
+        return 1000;
+    } else if (units == "mhz") {
+        return 1000 * 1000;
+    }
+    throw(std::invalid_argument("unknown frequency units " + units));
+}
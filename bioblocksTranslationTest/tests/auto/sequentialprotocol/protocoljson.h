@@ -0,0 +1,33 @@
+#ifndef PROTOCOLJSON_H
+#define PROTOCOLJSON_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+#include "ticktimebase.h"
+
+/**
+ * Helpers shared by the passes that work directly over the BioBlocks json.
+ */
+class ProtocolJson
+{
+public:
+    static nlohmann::json read(const std::string & path) throw(std::invalid_argument);
+    static void write(const nlohmann::json & protocol, const std::string & path) throw(std::invalid_argument);
+
+    static bool isBlock(const nlohmann::json & value);
+    static bool isBlock(const nlohmann::json & value, const std::string & blockType);
+    static std::vector<std::string> containerNames(const nlohmann::json & value);
+
+    static TickTimebase::Ticks timeToTicks(const nlohmann::json & block, const std::string & valueKey, const std::string & unitsKey) throw(std::invalid_argument);
+    static double unitToMs(const std::string & units) throw(std::invalid_argument);
+    static double unitToHz(const std::string & units) throw(std::invalid_argument);
+
+private:
+    ProtocolJson() {}
+};
+
+#endif // PROTOCOLJSON_H
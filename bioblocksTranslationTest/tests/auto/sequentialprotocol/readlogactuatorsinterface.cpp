@@ -0,0 +1,134 @@
+#include "readlogactuatorsinterface.h"
+
+ReadLogActuatorsInterface::ReadLogActuatorsInterface(const std::vector<ReadLogEntry> & readLog) :
+    readLog(readLog)
+{
+    nextEntry = 0;
+    usedTimes = 0;
+}
+
+ReadLogActuatorsInterface::~ReadLogActuatorsInterface()
+{
+
+}
+
+void ReadLogActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {}
+
+void ReadLogActuatorsInterface::stopApplyLigth(const std::string & sourceId) {}
+
+void ReadLogActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {}
+
+void ReadLogActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {}
+
+void ReadLogActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {}
+
+void ReadLogActuatorsInterface::stopStir(const std::string & idSource) {}
+
+void ReadLogActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {}
+
+void ReadLogActuatorsInterface::stopCentrifugate(const std::string & idSource) {}
+
+void ReadLogActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {}
+
+void ReadLogActuatorsInterface::stopShake(const std::string & idSource) {}
+
+void ReadLogActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {}
+
+std::shared_ptr<ElectrophoresisResult> ReadLogActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    return nullptr;
+}
+
+units::Volume ReadLogActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    return nextValue() * units::ml;
+}
+
+void ReadLogActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {}
+
+void ReadLogActuatorsInterface::startMeasureOD(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length wavelength)
+{
+
+}
+
+double ReadLogActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    return nextValue();
+}
+
+void ReadLogActuatorsInterface::startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency) {}
+
+units::Temperature ReadLogActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    return nextValue() * units::C;
+}
+
+void ReadLogActuatorsInterface::startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency) {}
+
+units::LuminousIntensity ReadLogActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    return nextValue() * units::cd;
+}
+
+void ReadLogActuatorsInterface::startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency) {}
+
+units::Volume ReadLogActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    return nextValue() * units::ml;
+}
+
+void ReadLogActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+
+}
+
+units::LuminousIntensity ReadLogActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    return nextValue() * units::cd;
+}
+
+void ReadLogActuatorsInterface::setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate) {}
+
+void ReadLogActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {}
+
+units::Time ReadLogActuatorsInterface::transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume) {
+    return nextValue() * units::ms;
+}
+
+void ReadLogActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {}
+
+units::Time ReadLogActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    return nextValue() * units::ms;
+}
+
+void ReadLogActuatorsInterface::stopMix(const std::string & idSource1, const std::string & idSource2, const std::string & idTarget) {}
+
+void ReadLogActuatorsInterface::setTimeStep(units::Time time) {}
+
+units::Time ReadLogActuatorsInterface::timeStep() {
+    return nextValue() * units::ms;
+}
+
+bool ReadLogActuatorsInterface::isConsumed() const {
+    return nextEntry == readLog.size();
+}
+
+double ReadLogActuatorsInterface::nextValue() throw(std::invalid_argument) {
+    if (nextEntry == readLog.size()) {
+        throw(std::invalid_argument("imposible to rebuild the execution, the read log is exhausted"));
+    }
+
+    double value = readLog[nextEntry].value;
+    usedTimes++;
+    if (usedTimes == readLog[nextEntry].times) {
+        nextEntry++;
+        usedTimes = 0;
+    }
+    return value;
+}
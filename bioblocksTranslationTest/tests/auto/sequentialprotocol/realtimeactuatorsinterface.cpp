@@ -0,0 +1,96 @@
+#include "realtimeactuatorsinterface.h"
+
+#include <algorithm>
+#include <thread>
+
+RealTimeActuatorsInterface::RealTimeActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface, bool coalesceOverruns, double timeScale) :
+    ForwardingActuatorsInterface(coalesceOverruns ? &optimizer : actuatorInterface),
+    coalesceOverruns(coalesceOverruns), timeScale(timeScale), optimizer(actuatorInterface)
+{
+    optimizer.setHolding(false);
+
+    timeSlice = 0;
+    sliceDuration = Clock::duration::zero();
+    start = Clock::now();
+    elapsedSlices = 0;
+
+    statistics = RealTimeStatistics();
+    totalJitterUs = 0;
+    sleptSteps = 0;
+}
+
+RealTimeActuatorsInterface::~RealTimeActuatorsInterface()
+{
+
+}
+
+void RealTimeActuatorsInterface::setTimeStep(units::Time time) {
+    timeSlice = TickTimebase::fromTime(time);
+    sliceDuration = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(TickTimebase::toMs(timeSlice) * timeScale));
+    if (sliceDuration <= Clock::duration::zero()) {
+        sliceDuration = Clock::duration(1);
+    }
+
+    actuatorInterface->setTimeStep(time);
+
+    start = Clock::now();
+    elapsedSlices = 0;
+}
+
+units::Time RealTimeActuatorsInterface::timeStep() throw(std::runtime_error) {
+    if (timeSlice <= 0) {
+        throw(std::runtime_error("imposible to pace a time step, the time slice has not been set"));
+    }
+
+    Clock::time_point deadline = start + sliceDuration * (elapsedSlices + 1);
+    Clock::time_point now = Clock::now();
+
+    SliceTiming timing{elapsedSlices, 1, 0, 0};
+    if (now > deadline) {
+        timing.overrunUs = std::chrono::duration<double, std::micro>(now - deadline).count();
+        if (coalesceOverruns) {
+            timing.slices = (now - start) / sliceDuration - elapsedSlices;
+        }
+    } else {
+        std::this_thread::sleep_until(deadline);
+        timing.jitterUs = std::chrono::duration<double, std::micro>(Clock::now() - deadline).count();
+    }
+    elapsedSlices += timing.slices;
+
+    // the held commands of the slices missed before go out with this step
+    units::Time elapsed = actuatorInterface->timeStep();
+    if (timing.slices > 1) {
+        elapsed = TickTimebase::toTime(TickTimebase::multiply(timeSlice, timing.slices));
+    }
+    if (coalesceOverruns) {
+        optimizer.setHolding(timing.slices > 1);
+    }
+
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    if (timing.overrunUs > 0) {
+        statistics.overruns++;
+        statistics.maxOverrunUs = std::max(statistics.maxOverrunUs, timing.overrunUs);
+        statistics.coalescedSlices += timing.slices - 1;
+    } else {
+        totalJitterUs += timing.jitterUs;
+        statistics.maxJitterUs = std::max(statistics.maxJitterUs, timing.jitterUs);
+        sleptSteps++;
+        statistics.meanJitterUs = totalJitterUs / sleptSteps;
+    }
+    statistics.slices = elapsedSlices;
+    statistics.timeSteps++;
+    statistics.mergedCommands = optimizer.getRemovedCommands();
+    sliceTimings.push_back(timing);
+    return elapsed;
+}
+
+RealTimeActuatorsInterface::RealTimeStatistics RealTimeActuatorsInterface::getStatistics() const {
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    return statistics;
+}
+
+std::vector<RealTimeActuatorsInterface::SliceTiming> RealTimeActuatorsInterface::getSliceTimings() const {
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    return sliceTimings;
+}
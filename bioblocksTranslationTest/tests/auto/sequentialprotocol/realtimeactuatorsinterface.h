@@ -0,0 +1,79 @@
+#ifndef REALTIMEACTUATORSINTERFACE_H
+#define REALTIMEACTUATORSINTERFACE_H
+
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "commandoptimizingactuatorsinterface.h"
+#include "forwardingactuatorsinterface.h"
+#include "ticktimebase.h"
+
+/**
+ * Paces the time steps of an execution against the monotonic clock.
+ *
+ * The slice n ends at start + n * slice, where start is the moment setTimeStep is called, so the sleeping
+ * error of one slice is not carried over to the next ones. timeStep() sleeps until the end of the current
+ * slice and records how late the thread woke up (jitter). If the commands of the slice took longer than
+ * the slice itself the step is an overrun: with coalescing enabled the backend gets a single timeStep()
+ * and the graph is told that all the missed slices have elapsed, so the execution catches up with the
+ * clock instead of running late for the rest of the protocol. The commands the graph issues while it
+ * catches up are held until the next time step and merged (see CommandOptimizingActuatorsInterface),
+ * so the backend only gets the final set-point of every actuator.
+ *
+ * Jitter and overrun are kept for every time step as well as aggregated. timeStep() before setTimeStep()
+ * is an error.
+ *
+ * timeScale shortens (< 1) or stretches (> 1) the wall-clock length of every slice, for dry runs.
+ */
+class RealTimeActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    typedef struct RealTimeStatistics_ {
+        unsigned long long slices;
+        unsigned long long timeSteps;
+        unsigned long long overruns;
+        unsigned long long coalescedSlices;
+        double meanJitterUs;
+        double maxJitterUs;
+        double maxOverrunUs;
+        unsigned long long mergedCommands;
+    } RealTimeStatistics;
+
+    typedef struct SliceTiming_ {
+        unsigned long long slice;
+        unsigned long long slices;
+        double jitterUs;
+        double overrunUs;
+    } SliceTiming;
+
+    RealTimeActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface, bool coalesceOverruns = true, double timeScale = 1.0);
+    virtual ~RealTimeActuatorsInterface();
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep() throw(std::runtime_error);
+
+    RealTimeStatistics getStatistics() const;
+    std::vector<SliceTiming> getSliceTimings() const;
+
+protected:
+    bool coalesceOverruns;
+    double timeScale;
+    CommandOptimizingActuatorsInterface optimizer;
+
+    TickTimebase::Ticks timeSlice;
+    Clock::duration sliceDuration;
+    Clock::time_point start;
+    unsigned long long elapsedSlices;
+
+    mutable std::mutex statisticsMutex;
+    RealTimeStatistics statistics;
+    std::vector<SliceTiming> sliceTimings;
+    double totalJitterUs;
+    unsigned long long sleptSteps;
+};
+
+#endif // REALTIMEACTUATORSINTERFACE_H
@@ -0,0 +1,53 @@
+#include "realtimeexecutor.h"
+
+RealTimeExecutor::RealTimeExecutor(
+        std::shared_ptr<ProtocolGraph> protocol,
+        ActuatorsExecutionInterface* actuatorInterface,
+        bool coalesceOverruns,
+        double timeScale) :
+    realTimeInterface(actuatorInterface, coalesceOverruns, timeScale), executor(protocol, &realTimeInterface)
+{
+    running = false;
+    stopRequested = false;
+}
+
+RealTimeExecutor::~RealTimeExecutor()
+{
+    stop();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void RealTimeExecutor::start() throw(std::runtime_error) {
+    if (running || thread.joinable()) {
+        throw(std::runtime_error("real time execution already started"));
+    }
+
+    running = true;
+    stopRequested = false;
+    thread = std::thread(&RealTimeExecutor::run, this);
+}
+
+void RealTimeExecutor::stop() {
+    stopRequested = true;
+}
+
+void RealTimeExecutor::wait() throw(std::runtime_error) {
+    if (thread.joinable()) {
+        thread.join();
+    }
+
+    if (!error.empty()) {
+        throw(std::runtime_error("real time execution failed: " + error));
+    }
+}
+
+void RealTimeExecutor::run() {
+    try {
+        while(!stopRequested && executor.executeNextNode());
+    } catch (std::exception & e) {
+        error = e.what();
+    }
+    running = false;
+}
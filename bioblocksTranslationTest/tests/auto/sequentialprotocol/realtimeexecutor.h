@@ -0,0 +1,64 @@
+#ifndef REALTIMEEXECUTOR_H
+#define REALTIMEEXECUTOR_H
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <protocolGraph/ProtocolGraph.h>
+
+#include "protocolexecutor.h"
+#include "realtimeactuatorsinterface.h"
+
+/**
+ * Runs a ProtocolGraph in real time on its own thread.
+ *
+ * The graph is executed by a ProtocolExecutor whose time steps go through a RealTimeActuatorsInterface,
+ * so every slice lasts its wall-clock length. stop() ends the execution after the node being executed,
+ * wait() joins the thread and rethrows any error raised while executing.
+ */
+class RealTimeExecutor
+{
+public:
+    RealTimeExecutor(std::shared_ptr<ProtocolGraph> protocol,
+                     ActuatorsExecutionInterface* actuatorInterface,
+                     bool coalesceOverruns = true,
+                     double timeScale = 1.0);
+    virtual ~RealTimeExecutor();
+
+    void start() throw(std::runtime_error);
+    void stop();
+    void wait() throw(std::runtime_error);
+
+    inline bool isRunning() const {
+        return running;
+    }
+
+    inline RealTimeActuatorsInterface::RealTimeStatistics getStatistics() const {
+        return realTimeInterface.getStatistics();
+    }
+
+    inline std::vector<RealTimeActuatorsInterface::SliceTiming> getSliceTimings() const {
+        return realTimeInterface.getSliceTimings();
+    }
+
+    inline ProtocolExecutor & getExecutor() {
+        return executor;
+    }
+
+protected:
+    RealTimeActuatorsInterface realTimeInterface;
+    ProtocolExecutor executor;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> stopRequested;
+    std::string error;
+
+    void run();
+};
+
+#endif // REALTIMEEXECUTOR_H
@@ -0,0 +1,110 @@
+#include "repeatcompactor.h"
+
+#include "protocoljson.h"
+
+RepeatCompactor::RepeatCompactor(const std::string & counterPrefix) :
+    counterPrefix(counterPrefix)
+{
+    compactedBlocks = 0;
+}
+
+RepeatCompactor::~RepeatCompactor()
+{
+
+}
+
+nlohmann::json RepeatCompactor::compact(const nlohmann::json & protocol) {
+    compactedBlocks = 0;
+
+    nlohmann::json compacted = protocol;
+    compactValue(compacted);
+    return compacted;
+}
+
+void RepeatCompactor::compactFile(const std::string & path, const std::string & compactedPath) throw(std::invalid_argument) {
+    ProtocolJson::write(compact(ProtocolJson::read(path)), compactedPath);
+}
+
+std::shared_ptr<ProtocolGraph> RepeatCompactor::translateFile(
+        const std::string & path,
+        const std::string & compactedPath,
+        units::Time timeSlice) throw(std::invalid_argument)
+{
+    compactFile(path, compactedPath);
+
+    BioBlocksTranslator translator(timeSlice, compactedPath);
+    return translator.translateFile();
+}
+
+void RepeatCompactor::compactValue(nlohmann::json & value) {
+    if (value.is_object()) {
+        for(auto it = value.begin(); it != value.end(); ++it) {
+            compactValue(it.value());
+        }
+    } else if (value.is_array()) {
+        nlohmann::json compacted = nlohmann::json::array();
+        for(nlohmann::json & element: value) {
+            if (!isRepeated(element)) {
+                compactValue(element);
+                compacted.push_back(element);
+                continue;
+            }
+
+            std::string counter = counterPrefix + std::to_string(compactedBlocks);
+            compactedBlocks++;
+
+            nlohmann::json reset = makeCounterSet(counter, {{"block_type", "math_number"}, {"value", "0"}});
+            reset["timeOfOperation"] = element["timeOfOperation"];
+            reset["timeOfOperation_units"] = element["timeOfOperation_units"];
+            if (element.count("linked") > 0) {
+                reset["linked"] = element["linked"];
+            }
+
+            nlohmann::json increment = makeCounterSet(counter, {
+                {"block_type", "math_arithmetic"},
+                {"left", {{"block_type", "variables_get"}, {"variable", counter}}},
+                {"rigth", {{"block_type", "math_number"}, {"value", "1"}}},
+                {"op", "ADD"}});
+            increment["timeOfOperation"] = "-1";
+            increment["timeOfOperation_units"] = "ms";
+
+            nlohmann::json cycle = element;
+            cycle["cycles"] = {{"block_type", "math_number"}, {"value", "1"}};
+            cycle["timeOfOperation"] = "-1";
+            cycle["timeOfOperation_units"] = "ms";
+            cycle["linked"] = "TRUE";
+
+            nlohmann::json loop = {
+                {"block_type", "controls_whileUntil"},
+                {"condition", {
+                     {"block_type", "logic_compare"},
+                     {"left", {{"block_type", "variables_get"}, {"variable", counter}}},
+                     {"rigth", element["cycles"]},
+                     {"op", "LT"}}},
+                {"branches", nlohmann::json::array({cycle, increment})},
+                {"timeOfOperation", "-1"},
+                {"timeOfOperation_units", "ms"},
+                {"linked", "TRUE"}};
+
+            compacted.push_back(reset);
+            compacted.push_back(loop);
+        }
+        value = compacted;
+    }
+}
+
+bool RepeatCompactor::isRepeated(const nlohmann::json & block) const {
+    if (!ProtocolJson::isBlock(block, "thermocycling") || block.count("cycles") == 0) {
+        return false;
+    }
+
+    const nlohmann::json & cycles = block["cycles"];
+    if (ProtocolJson::isBlock(cycles, "math_number")) {
+        return std::stod(cycles["value"].get<std::string>()) > 1;
+    }
+    return true;
+}
+
+nlohmann::json RepeatCompactor::makeCounterSet(const std::string & counter, const nlohmann::json & value) const {
+    return {{"block_type", "variables_set"}, {"variable", counter}, {"value", value}};
+}
@@ -0,0 +1,48 @@
+#ifndef REPEATCOMPACTOR_H
+#define REPEATCOMPACTOR_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <json.hpp>
+
+#include <bioblocksTranslation/bioblockstranslator.h>
+
+/**
+ * Rewrites thermocycling blocks as a counted loop before translation.
+ *
+ * BioBlocksTranslator unrolls a thermocycling block, so the graph grows with cycles x steps. Loops are
+ * already translated as a cycle in the ProtocolGraph, so every thermocycling block is replaced by:
+ *      counter = 0
+ *      while (counter < cycles) { thermocycling(cycles = 1); counter = counter + 1 }
+ * keeping the timing of the original block. The translated graph and the translation time no longer
+ * depend on the number of cycles.
+ */
+class RepeatCompactor
+{
+public:
+    RepeatCompactor(const std::string & counterPrefix = "repeat_counter_");
+    virtual ~RepeatCompactor();
+
+    nlohmann::json compact(const nlohmann::json & protocol);
+    void compactFile(const std::string & path, const std::string & compactedPath) throw(std::invalid_argument);
+
+    std::shared_ptr<ProtocolGraph> translateFile(const std::string & path,
+                                                 const std::string & compactedPath,
+                                                 units::Time timeSlice) throw(std::invalid_argument);
+
+    inline unsigned int getCompactedBlocks() const {
+        return compactedBlocks;
+    }
+
+protected:
+    std::string counterPrefix;
+    unsigned int compactedBlocks;
+
+    void compactValue(nlohmann::json & value);
+    bool isRepeated(const nlohmann::json & block) const;
+    nlohmann::json makeCounterSet(const std::string & counter, const nlohmann::json & value) const;
+};
+
+#endif // REPEATCOMPACTOR_H
@@ -0,0 +1,74 @@
+#include "replayactuatorsinterface.h"
+
+ReplayActuatorsInterface::ReplayActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface, const SensorLog* log, TickTimebase::Ticks logStart) :
+    ForwardingActuatorsInterface(actuatorInterface), log(log), logStart(logStart)
+{
+    timeSlice = 0;
+    now = 0;
+    replayedReads = 0;
+}
+
+ReplayActuatorsInterface::~ReplayActuatorsInterface()
+{
+
+}
+
+double ReplayActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    double value = actuatorInterface->getMeasureOD(sourceId);
+    replay(sourceId, SensorLog::OD, value);
+    return value;
+}
+
+units::Temperature ReplayActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    units::Temperature measured = actuatorInterface->getMeasureTemperature(sourceId);
+    double value;
+    if (replay(sourceId, SensorLog::TEMPERATURE, value)) {
+        return value * units::C;
+    }
+    return measured;
+}
+
+units::LuminousIntensity ReplayActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    units::LuminousIntensity measured = actuatorInterface->getMeasureLuminiscense(sourceId);
+    double value;
+    if (replay(sourceId, SensorLog::LUMINISCENSE, value)) {
+        return value * units::cd;
+    }
+    return measured;
+}
+
+units::Volume ReplayActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    units::Volume measured = actuatorInterface->getMeasureVolume(sourceId);
+    double value;
+    if (replay(sourceId, SensorLog::VOLUME, value)) {
+        return value * units::ml;
+    }
+    return measured;
+}
+
+units::LuminousIntensity ReplayActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    units::LuminousIntensity measured = actuatorInterface->getMeasureFluorescence(sourceId);
+    double value;
+    if (replay(sourceId, SensorLog::FLUORESCENCE, value)) {
+        return value * units::cd;
+    }
+    return measured;
+}
+
+void ReplayActuatorsInterface::setTimeStep(units::Time time) {
+    timeSlice = TickTimebase::fromTime(time);
+    actuatorInterface->setTimeStep(time);
+}
+
+units::Time ReplayActuatorsInterface::timeStep() {
+    now = TickTimebase::add(now, timeSlice);
+    return actuatorInterface->timeStep();
+}
+
+bool ReplayActuatorsInterface::replay(const std::string & sourceId, SensorLog::SensorType sensor, double & value) {
+    if (log->valueAt(sourceId, sensor, TickTimebase::add(logStart, now), value)) {
+        replayedReads++;
+        return true;
+    }
+    return false;
+}
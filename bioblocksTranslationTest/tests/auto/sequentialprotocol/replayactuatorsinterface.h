@@ -0,0 +1,52 @@
+#ifndef REPLAYACTUATORSINTERFACE_H
+#define REPLAYACTUATORSINTERFACE_H
+
+#include <string>
+
+#include "forwardingactuatorsinterface.h"
+#include "sensorlog.h"
+#include "ticktimebase.h"
+
+/**
+ * Answers the measurements with the readings of a SensorLog instead of the wrapped interface.
+ *
+ * The simulated time is kept from setTimeStep and timeStep(); a measurement of a container gets the last
+ * reading of that container and sensor logged at or before logStart + the simulated time. Every call is
+ * still forwarded, so the wrapped interface records the execution as usual, and its value is used when the
+ * log has no reading in effect for the container yet. The log is not owned.
+ */
+class ReplayActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    ReplayActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface, const SensorLog* log, TickTimebase::Ticks logStart = 0);
+    virtual ~ReplayActuatorsInterface();
+
+    virtual double getMeasureOD(const std::string & sourceId);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    inline TickTimebase::Ticks getElapsedTicks() const {
+        return now;
+    }
+
+    inline unsigned long long getReplayedReads() const {
+        return replayedReads;
+    }
+
+protected:
+    const SensorLog* log;
+    TickTimebase::Ticks logStart;
+
+    TickTimebase::Ticks timeSlice;
+    TickTimebase::Ticks now;
+    unsigned long long replayedReads;
+
+    bool replay(const std::string & sourceId, SensorLog::SensorType sensor, double & value);
+};
+
+#endif // REPLAYACTUATORSINTERFACE_H
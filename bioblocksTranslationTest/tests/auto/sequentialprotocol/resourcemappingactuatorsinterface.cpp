@@ -0,0 +1,192 @@
+#include "resourcemappingactuatorsinterface.h"
+
+#include "protocolcoscheduler.h"
+
+ResourceMappingActuatorsInterface::ResourceMappingActuatorsInterface(
+        ActuatorsExecutionInterface* actuatorInterface,
+        ProtocolCoScheduler* scheduler,
+        const std::string & protocolName,
+        const std::map<std::string, std::string> & containerMapping) :
+    ForwardingActuatorsInterface(actuatorInterface), scheduler(scheduler), protocolName(protocolName), containerMapping(containerMapping)
+{
+    waitingSlice = false;
+}
+
+ResourceMappingActuatorsInterface::~ResourceMappingActuatorsInterface()
+{
+
+}
+
+void ResourceMappingActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {
+    actuatorInterface->applyLigth(physical(sourceId), wavelength, intensity);
+}
+
+void ResourceMappingActuatorsInterface::stopApplyLigth(const std::string & sourceId) {
+    actuatorInterface->stopApplyLigth(physical(sourceId));
+}
+
+void ResourceMappingActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {
+    actuatorInterface->applyTemperature(physical(sourceId), temperature);
+}
+
+void ResourceMappingActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {
+    actuatorInterface->stopApplyTemperature(physical(sourceId));
+}
+
+void ResourceMappingActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {
+    actuatorInterface->stir(physical(idSource), intensity);
+}
+
+void ResourceMappingActuatorsInterface::stopStir(const std::string & idSource) {
+    actuatorInterface->stopStir(physical(idSource));
+}
+
+void ResourceMappingActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {
+    actuatorInterface->centrifugate(physical(idSource), intensity);
+}
+
+void ResourceMappingActuatorsInterface::stopCentrifugate(const std::string & idSource) {
+    actuatorInterface->stopCentrifugate(physical(idSource));
+}
+
+void ResourceMappingActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {
+    actuatorInterface->shake(physical(idSource), intensity);
+}
+
+void ResourceMappingActuatorsInterface::stopShake(const std::string & idSource) {
+    actuatorInterface->stopShake(physical(idSource));
+}
+
+void ResourceMappingActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {
+    actuatorInterface->startElectrophoresis(physical(idSource), fieldStrenght);
+}
+
+std::shared_ptr<ElectrophoresisResult> ResourceMappingActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    return actuatorInterface->stopElectrophoresis(physical(idSource));
+}
+
+units::Volume ResourceMappingActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    return actuatorInterface->getVirtualVolume(physical(sourceId));
+}
+
+void ResourceMappingActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    actuatorInterface->loadContainer(physical(sourceId), initialVolume);
+}
+
+void ResourceMappingActuatorsInterface::startMeasureOD(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length wavelength)
+{
+    actuatorInterface->startMeasureOD(physical(sourceId), measurementFrequency, wavelength);
+}
+
+double ResourceMappingActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    return actuatorInterface->getMeasureOD(physical(sourceId));
+}
+
+void ResourceMappingActuatorsInterface::startMeasureTemperature(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    actuatorInterface->startMeasureTemperature(physical(sourceId), measurementFrequency);
+}
+
+units::Temperature ResourceMappingActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    return actuatorInterface->getMeasureTemperature(physical(sourceId));
+}
+
+void ResourceMappingActuatorsInterface::startMeasureLuminiscense(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    actuatorInterface->startMeasureLuminiscense(physical(sourceId), measurementFrequency);
+}
+
+units::LuminousIntensity ResourceMappingActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    return actuatorInterface->getMeasureLuminiscense(physical(sourceId));
+}
+
+void ResourceMappingActuatorsInterface::startMeasureVolume(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    actuatorInterface->startMeasureVolume(physical(sourceId), measurementFrequency);
+}
+
+units::Volume ResourceMappingActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    return actuatorInterface->getMeasureVolume(physical(sourceId));
+}
+
+void ResourceMappingActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+    actuatorInterface->startMeasureFluorescence(physical(sourceId), measurementFrequency, excitation, emission);
+}
+
+units::LuminousIntensity ResourceMappingActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    return actuatorInterface->getMeasureFluorescence(physical(sourceId));
+}
+
+units::Time ResourceMappingActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    return actuatorInterface->mix(physical(idSource1), physical(idSource2), physical(idTarget), volume1, volume2);
+}
+
+void ResourceMappingActuatorsInterface::stopMix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget)
+{
+    actuatorInterface->stopMix(physical(idSource1), physical(idSource2), physical(idTarget));
+}
+
+void ResourceMappingActuatorsInterface::setContinuosFlow(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volumetric_Flow rate)
+{
+    actuatorInterface->setContinuosFlow(physical(idSource), physical(idTarget), rate);
+}
+
+void ResourceMappingActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {
+    actuatorInterface->stopContinuosFlow(physical(idSource), physical(idTarget));
+}
+
+units::Time ResourceMappingActuatorsInterface::transfer(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volume volume)
+{
+    return actuatorInterface->transfer(physical(idSource), physical(idTarget), volume);
+}
+
+void ResourceMappingActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {
+    actuatorInterface->stopTransfer(physical(idSource), physical(idTarget));
+}
+
+void ResourceMappingActuatorsInterface::setTimeStep(units::Time time) {
+    timeSlice = time;
+    scheduler->requestTimeStep(protocolName, time);
+}
+
+units::Time ResourceMappingActuatorsInterface::timeStep() {
+    waitingSlice = true;
+    return timeSlice;
+}
+
+const std::string & ResourceMappingActuatorsInterface::physical(const std::string & containerId) throw(std::runtime_error) {
+    auto it = containerMapping.find(containerId);
+    if (it == containerMapping.end()) {
+        throw(std::runtime_error("container " + containerId + " of " + protocolName + " has no physical container"));
+    }
+    return it->second;
+}
@@ -0,0 +1,107 @@
+#ifndef RESOURCEMAPPINGACTUATORSINTERFACE_H
+#define RESOURCEMAPPINGACTUATORSINTERFACE_H
+
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "forwardingactuatorsinterface.h"
+
+class ProtocolCoScheduler;
+
+/**
+ * Per-protocol view of an instrument shared by several protocols.
+ *
+ * Container names of the protocol are translated to the physical container names the ProtocolCoScheduler
+ * claimed for it; a container out of the mapping is an error. setTimeStep and timeStep are not forwarded: the
+ * ProtocolCoScheduler owns the shared timeline, timeStep() only flags the protocol as waiting for the
+ * next shared slice.
+ */
+class ResourceMappingActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    ResourceMappingActuatorsInterface(
+            ActuatorsExecutionInterface* actuatorInterface,
+            ProtocolCoScheduler* scheduler,
+            const std::string & protocolName,
+            const std::map<std::string, std::string> & containerMapping);
+    virtual ~ResourceMappingActuatorsInterface();
+
+    virtual void applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity);
+    virtual void stopApplyLigth(const std::string & sourceId);
+
+    virtual void applyTemperature(const std::string & sourceId, units::Temperature temperature);
+    virtual void stopApplyTemperature(const std::string & sourceId);
+
+    virtual void stir(const std::string & idSource, units::Frequency intensity);
+    virtual void stopStir(const std::string & idSource);
+
+    virtual void centrifugate(const std::string & idSource, units::Frequency intensity);
+    virtual void stopCentrifugate(const std::string & idSource);
+
+    virtual void shake(const std::string & idSource, units::Frequency intensity);
+    virtual void stopShake(const std::string & idSource);
+
+    virtual void startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght);
+    virtual std::shared_ptr<ElectrophoresisResult> stopElectrophoresis(const std::string & idSource);
+
+    virtual units::Volume getVirtualVolume(const std::string & sourceId);
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual void startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength);
+    virtual double getMeasureOD(const std::string & sourceId);
+
+    virtual void startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+
+    virtual void startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+
+    virtual void startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+
+    virtual void startMeasureFluorescence(const std::string & sourceId,
+                                          units::Frequency measurementFrequency,
+                                          units::Length excitation,
+                                          units::Length emission);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual void setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate);
+    virtual void stopContinuosFlow(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume);
+    virtual void stopTransfer(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time mix(const std::string & idSource1,
+                            const std::string & idSource2,
+                            const std::string & idTarget,
+                            units::Volume volume1,
+                            units::Volume volume2);
+
+    virtual void stopMix(const std::string & idSource1,
+                         const std::string & idSource2,
+                         const std::string & idTarget);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    inline bool isWaitingSlice() const {
+        return waitingSlice;
+    }
+
+    inline void sliceDone() {
+        waitingSlice = false;
+    }
+
+protected:
+    ProtocolCoScheduler* scheduler;
+    std::string protocolName;
+    std::map<std::string, std::string> containerMapping;
+
+    units::Time timeSlice;
+    bool waitingSlice;
+
+    const std::string & physical(const std::string & containerId) throw(std::runtime_error);
+};
+
+#endif // RESOURCEMAPPINGACTUATORSINTERFACE_H
@@ -0,0 +1,179 @@
+#include "sensorlog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const char MAGIC[8] = {'B', 'B', 'S', 'L', 'O', 'G', '0', '1'};
+const size_t CONTAINER_LENGTH = 48;
+
+typedef struct Header_ {
+    char magic[8];
+    std::uint64_t channels;
+} Header;
+
+typedef struct ChannelEntry_ {
+    char container[CONTAINER_LENGTH];
+    std::uint32_t sensor;
+    std::uint32_t reserved;
+    std::uint64_t first;
+    std::uint64_t count;
+} ChannelEntry;
+
+const char* SENSOR_NAMES[] = {"OD", "Temperature", "Luminiscense", "Volume", "Fluorescence"};
+const int SENSOR_COUNT = 5;
+
+}
+
+SensorLog::SensorLog(const std::string & path) throw(std::invalid_argument) {
+    readings = 0;
+    try {
+        boost::interprocess::file_mapping file(path.c_str(), boost::interprocess::read_only);
+        region.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("imposible to map sensor log " + path + ": " + e.what()));
+    }
+
+    const char* data = static_cast<const char*>(region->get_address());
+    size_t size = region->get_size();
+
+    Header header;
+    if (size < sizeof(Header)) {
+        throw(std::invalid_argument(path + " is not a sensor log"));
+    }
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            header.channels > (size - sizeof(Header)) / sizeof(ChannelEntry))
+    {
+        throw(std::invalid_argument(path + " is not a sensor log"));
+    }
+
+    size_t readingsOffset = sizeof(Header) + header.channels * sizeof(ChannelEntry);
+    readings = (size - readingsOffset) / sizeof(StoredReading);
+    const StoredReading* stored = reinterpret_cast<const StoredReading*>(data + readingsOffset);
+
+    for(std::uint64_t i = 0; i < header.channels; i++) {
+        ChannelEntry entry;
+        std::memcpy(&entry, data + sizeof(Header) + i * sizeof(ChannelEntry), sizeof(ChannelEntry));
+        if (entry.sensor >= SENSOR_COUNT || entry.first > readings || entry.count > readings - entry.first) {
+            throw(std::invalid_argument("corrupted channel " + std::to_string(i) + " in sensor log " + path));
+        }
+
+        std::string container(entry.container, strnlen(entry.container, CONTAINER_LENGTH));
+        channels[std::make_pair(container, (int) entry.sensor)] = Channel{stored + entry.first, entry.count};
+    }
+}
+
+SensorLog::~SensorLog()
+{
+
+}
+
+void SensorLog::write(const std::vector<Reading> & readings, const std::string & path) throw(std::invalid_argument, std::runtime_error) {
+    std::map<std::pair<std::string, int>, std::vector<StoredReading>> grouped;
+    for(const Reading & reading: readings) {
+        if (reading.container.size() >= CONTAINER_LENGTH) {
+            throw(std::invalid_argument("imposible to log container " + reading.container + ", names are up to " +
+                                        std::to_string(CONTAINER_LENGTH - 1) + " characters"));
+        }
+        grouped[std::make_pair(reading.container, (int) reading.sensor)].push_back(StoredReading{reading.time, reading.value});
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw(std::runtime_error("imposible to open " + path));
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.channels = grouped.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    std::uint64_t first = 0;
+    for(const auto & channel: grouped) {
+        ChannelEntry entry;
+        std::memset(&entry, 0, sizeof(ChannelEntry));
+        std::memcpy(entry.container, channel.first.first.data(), channel.first.first.size());
+        entry.sensor = channel.first.second;
+        entry.first = first;
+        entry.count = channel.second.size();
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(ChannelEntry));
+        first += entry.count;
+    }
+
+    for(auto & channel: grouped) {
+        std::stable_sort(channel.second.begin(), channel.second.end(), [](const StoredReading & a, const StoredReading & b) {
+            return a.time < b.time;
+        });
+        out.write(reinterpret_cast<const char*>(channel.second.data()), channel.second.size() * sizeof(StoredReading));
+    }
+
+    if (!out.good()) {
+        throw(std::runtime_error("imposible to write " + path));
+    }
+}
+
+void SensorLog::convert(const std::string & textPath, const std::string & path) throw(std::invalid_argument, std::runtime_error) {
+    std::ifstream in(textPath);
+    if (!in.is_open()) {
+        throw(std::invalid_argument("imposible to open " + textPath));
+    }
+
+    std::vector<Reading> readings;
+    std::string line;
+    unsigned long long lineNumber = 0;
+    while(std::getline(in, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::istringstream lineStream(line);
+        std::string field;
+        while(std::getline(lineStream, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() != 4) {
+            throw(std::invalid_argument("imposible to read line " + std::to_string(lineNumber) + " of " + textPath +
+                                        ", expected timeMs,container,sensor,value"));
+        }
+
+        try {
+            readings.push_back(Reading{fields[1], sensorType(fields[2]), TickTimebase::parse(fields[0], "ms"), std::stod(fields[3])});
+        } catch (std::exception & e) {
+            throw(std::invalid_argument("imposible to read line " + std::to_string(lineNumber) + " of " + textPath + ": " + e.what()));
+        }
+    }
+    write(readings, path);
+}
+
+SensorLog::SensorType SensorLog::sensorType(const std::string & name) throw(std::invalid_argument) {
+    for(int i = 0; i < SENSOR_COUNT; i++) {
+        if (name == SENSOR_NAMES[i]) {
+            return (SensorType) i;
+        }
+    }
+    throw(std::invalid_argument("unknown sensor " + name));
+}
+
+bool SensorLog::valueAt(const std::string & container, SensorType sensor, TickTimebase::Ticks time, double & value) const {
+    auto it = channels.find(std::make_pair(container, (int) sensor));
+    if (it == channels.end()) {
+        return false;
+    }
+
+    const Channel & channel = it->second;
+    const StoredReading* end = channel.first + channel.count;
+    const StoredReading* next = std::upper_bound(channel.first, end, time, [](TickTimebase::Ticks time, const StoredReading & reading) {
+        return time < reading.time;
+    });
+    if (next == channel.first) {
+        return false;
+    }
+    value = (next - 1)->value;
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef SENSORLOG_H
+#define SENSORLOG_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "ticktimebase.h"
+
+/**
+ * Recorded sensor readings of a real run, memory mapped for replay.
+ *
+ * The log is a binary file: a header, a table with one channel per (container, sensor) and the readings of
+ * every channel together, sorted by time. Opening it only reads the channel table; the readings stay in
+ * the mapping and are paged in by the binary searches of valueAt(), so logs bigger than the memory can be
+ * replayed and every lookup is logarithmic in the readings of its channel.
+ *
+ * Loggers write text, one reading per line: "timeMs,container,sensor,value", sensor one of "OD",
+ * "Temperature", "Luminiscense", "Volume" or "Fluorescence" as in BranchSpaceExplorer. convert() turns
+ * that into a log, sorting the readings in memory.
+ */
+class SensorLog
+{
+public:
+    typedef enum SensorType_ {
+        OD = 0,
+        TEMPERATURE,
+        LUMINISCENSE,
+        VOLUME,
+        FLUORESCENCE
+    } SensorType;
+
+    typedef struct Reading_ {
+        std::string container;
+        SensorType sensor;
+        TickTimebase::Ticks time;
+        double value;
+    } Reading;
+
+    SensorLog(const std::string & path) throw(std::invalid_argument);
+    virtual ~SensorLog();
+
+    static void write(const std::vector<Reading> & readings, const std::string & path) throw(std::invalid_argument, std::runtime_error);
+    static void convert(const std::string & textPath, const std::string & path) throw(std::invalid_argument, std::runtime_error);
+
+    static SensorType sensorType(const std::string & name) throw(std::invalid_argument);
+
+    bool valueAt(const std::string & container, SensorType sensor, TickTimebase::Ticks time, double & value) const;
+
+    inline size_t getChannels() const {
+        return channels.size();
+    }
+
+    inline std::uint64_t getReadings() const {
+        return readings;
+    }
+
+protected:
+    typedef struct StoredReading_ {
+        std::int64_t time;
+        double value;
+    } StoredReading;
+
+    typedef struct Channel_ {
+        const StoredReading* first;
+        std::uint64_t count;
+    } Channel;
+
+    std::unique_ptr<boost::interprocess::mapped_region> region;
+
+    std::map<std::pair<std::string, int>, Channel> channels;
+    std::uint64_t readings;
+};
+
+#endif // SENSORLOG_H
@@ -24,7 +24,43 @@ CONFIG -= app_bundle
 TEMPLATE = app
 
 SOURCES +=  tst_sequentialprotocol.cpp \
-    stringactuatorsinterface.cpp
+    stringactuatorsinterface.cpp \
+    forwardingactuatorsinterface.cpp \
+    activestateactuatorsinterface.cpp \
+    executioncheckpoint.cpp \
+    protocolexecutor.cpp \
+    simulatedactuatorsinterface.cpp \
+    protocolanalyzer.cpp \
+    protocoljson.cpp \
+    timesliceselector.cpp \
+    resourcemappingactuatorsinterface.cpp \
+    protocolcoscheduler.cpp \
+    repeatcompactor.cpp \
+    realtimeactuatorsinterface.cpp \
+    realtimeexecutor.cpp \
+    asyncactuatorsinterface.cpp \
+    tracetimeline.cpp \
+    goldentrace.cpp \
+    tracecomparator.cpp \
+    protocolcorpusrunner.cpp \
+    lazybranchtranslator.cpp \
+    lazybranchactuatorsinterface.cpp \
+    lazyprotocolexecutor.cpp \
+    explorationactuatorsinterface.cpp \
+    branchspaceexplorer.cpp \
+    steadystateactuatorsinterface.cpp \
+    steadystateexecutor.cpp \
+    commandoptimizingactuatorsinterface.cpp \
+    ticktimebase.cpp \
+    parameterizedprotocol.cpp \
+    parametersweep.cpp \
+    trackactuatorsinterface.cpp \
+    multirateexecutor.cpp \
+    sensorlog.cpp \
+    replayactuatorsinterface.cpp \
+    partitionactuatorsinterface.cpp \
+    partitionedexecutor.cpp \
+    readlogactuatorsinterface.cpp
 
 debug {
     INCLUDEPATH += X:\utils\dll_debug\include
@@ -56,5 +92,42 @@ RESOURCES += \
     protocols.qrc
 
 HEADERS += \
-    stringactuatorsinterface.h
+    stringactuatorsinterface.h \
+    forwardingactuatorsinterface.h \
+    activestateactuatorsinterface.h \
+    executioncheckpoint.h \
+    protocolexecutor.h \
+    simulatedactuatorsinterface.h \
+    protocolanalyzer.h \
+    protocoljson.h \
+    timesliceselector.h \
+    resourcemappingactuatorsinterface.h \
+    protocolcoscheduler.h \
+    repeatcompactor.h \
+    realtimeactuatorsinterface.h \
+    realtimeexecutor.h \
+    spscringbuffer.h \
+    asyncactuatorsinterface.h \
+    tracetimeline.h \
+    goldentrace.h \
+    tracecomparator.h \
+    protocolcorpusrunner.h \
+    lazybranchtranslator.h \
+    lazybranchactuatorsinterface.h \
+    lazyprotocolexecutor.h \
+    explorationactuatorsinterface.h \
+    branchspaceexplorer.h \
+    steadystateactuatorsinterface.h \
+    steadystateexecutor.h \
+    commandoptimizingactuatorsinterface.h \
+    ticktimebase.h \
+    parameterizedprotocol.h \
+    parametersweep.h \
+    trackactuatorsinterface.h \
+    multirateexecutor.h \
+    sensorlog.h \
+    replayactuatorsinterface.h \
+    partitionactuatorsinterface.h \
+    partitionedexecutor.h \
+    readlogactuatorsinterface.h
 
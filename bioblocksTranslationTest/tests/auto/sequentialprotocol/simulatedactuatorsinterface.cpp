@@ -0,0 +1,351 @@
+#include "simulatedactuatorsinterface.h"
+
+#include <algorithm>
+#include <cmath>
+
+SimulatedActuatorsInterface::SimulatedActuatorsInterface() :
+    SimulatedActuatorsInterface(SimulationParameters())
+{
+
+}
+
+SimulatedActuatorsInterface::SimulatedActuatorsInterface(const SimulationParameters & parameters) :
+    parameters(parameters)
+{
+    now = 0;
+    timeSlice = 0;
+    lastUpdate = 0;
+}
+
+SimulatedActuatorsInterface::~SimulatedActuatorsInterface()
+{
+
+}
+
+void SimulatedActuatorsInterface::setInitialOD(const std::string & sourceId, double od) {
+    advance(sourceId).od = od;
+}
+
+void SimulatedActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {
+
+}
+
+void SimulatedActuatorsInterface::stopApplyLigth(const std::string & sourceId) {
+
+}
+
+void SimulatedActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {
+    SimulatedContainer & container = advance(sourceId);
+    container.heating = true;
+    container.setPointC = temperature.to(units::C);
+}
+
+void SimulatedActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {
+    advance(sourceId).heating = false;
+}
+
+void SimulatedActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {
+
+}
+
+void SimulatedActuatorsInterface::stopStir(const std::string & idSource) {
+
+}
+
+void SimulatedActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {
+
+}
+
+void SimulatedActuatorsInterface::stopCentrifugate(const std::string & idSource) {
+
+}
+
+void SimulatedActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {
+
+}
+
+void SimulatedActuatorsInterface::stopShake(const std::string & idSource) {
+
+}
+
+void SimulatedActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {
+
+}
+
+std::shared_ptr<ElectrophoresisResult> SimulatedActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    return std::make_shared<ElectrophoresisResult>();
+}
+
+units::Volume SimulatedActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    return advance(sourceId).volumeMl * units::ml;
+}
+
+void SimulatedActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    advance(sourceId).volumeMl = initialVolume.to(units::ml);
+}
+
+void SimulatedActuatorsInterface::startMeasureOD(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length wavelength)
+{
+
+}
+
+double SimulatedActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    return advance(sourceId).od;
+}
+
+void SimulatedActuatorsInterface::startMeasureTemperature(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+
+}
+
+units::Temperature SimulatedActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    return advance(sourceId).temperatureC * units::C;
+}
+
+void SimulatedActuatorsInterface::startMeasureLuminiscense(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+
+}
+
+units::LuminousIntensity SimulatedActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    return advance(sourceId).od * parameters.fluorescencePerOD * units::cd;
+}
+
+void SimulatedActuatorsInterface::startMeasureVolume(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+
+}
+
+units::Volume SimulatedActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    return advance(sourceId).volumeMl * units::ml;
+}
+
+void SimulatedActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+
+}
+
+units::LuminousIntensity SimulatedActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    return advance(sourceId).od * parameters.fluorescencePerOD * units::cd;
+}
+
+units::Time SimulatedActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    moveVolume(idSource1, idTarget, volume1.to(units::ml));
+    moveVolume(idSource2, idTarget, volume2.to(units::ml));
+    return ((volume1.to(units::ml) + volume2.to(units::ml)) / parameters.pipettingRateMlPerS) * units::s;
+}
+
+void SimulatedActuatorsInterface::stopMix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget)
+{
+
+}
+
+void SimulatedActuatorsInterface::setContinuosFlow(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volumetric_Flow rate)
+{
+    stopContinuosFlow(idSource, idTarget);
+    flowsMlPerMs[std::make_pair(idSource, idTarget)] = rate.to(units::ml/units::ms);
+}
+
+void SimulatedActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {
+    advance(idSource);
+    advance(idTarget);
+    flowsMlPerMs.erase(std::make_pair(idSource, idTarget));
+}
+
+units::Time SimulatedActuatorsInterface::transfer(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volume volume)
+{
+    moveVolume(idSource, idTarget, volume.to(units::ml));
+    return (volume.to(units::ml) / parameters.pipettingRateMlPerS) * units::s;
+}
+
+void SimulatedActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {
+
+}
+
+void SimulatedActuatorsInterface::setTimeStep(units::Time time) {
+    timeSlice = TickTimebase::fromTime(time);
+}
+
+units::Time SimulatedActuatorsInterface::timeStep() {
+    now += timeSlice;
+    return TickTimebase::toTime(timeSlice);
+}
+
+SimulatedActuatorsInterface::SimulatedContainer & SimulatedActuatorsInterface::getContainer(const std::string & sourceId) {
+    auto it = containers.find(sourceId);
+    if (it == containers.end()) {
+        SimulatedContainer container;
+        container.temperatureC = parameters.ambientTemperatureC;
+        it = containers.insert(std::make_pair(sourceId, container)).first;
+    }
+    return it->second;
+}
+
+SimulatedActuatorsInterface::SimulatedContainer & SimulatedActuatorsInterface::advance(const std::string & sourceId) {
+    if (now > lastUpdate) {
+        double dt = TickTimebase::toMs(now - lastUpdate);
+        int steps = needsSubsteps() ? (int) std::ceil(dt / parameters.maxSubstepMs) : 1;
+        for(int i = 0; i < steps; i++) {
+            step(dt / steps);
+        }
+        lastUpdate = now;
+    }
+    return getContainer(sourceId);
+}
+
+void SimulatedActuatorsInterface::step(double ms) {
+    std::map<std::pair<std::string, std::string>, double> delivered = deliveredVolumes(ms);
+
+    std::unordered_map<std::string, double> inflowMl;
+    std::unordered_map<std::string, double> outflowMl;
+    std::unordered_map<std::string, double> cellsIn;
+    for(const auto & flow: delivered) {
+        outflowMl[flow.first.first] += flow.second;
+        inflowMl[flow.first.second] += flow.second;
+        cellsIn[flow.first.second] += flow.second * containers[flow.first.first].od;
+    }
+
+    for(auto & entry: containers) {
+        SimulatedContainer & container = entry.second;
+        double inflow = inflowMl[entry.first];
+        double odIn = inflow > 0 ? cellsIn[entry.first] / inflow : 0;
+
+        double targetC = targetTemperature(container);
+        double middleC = targetC + (container.temperatureC - targetC) * std::exp(-0.5 * ms / parameters.heatingTimeConstantMs);
+        double mu = growthRatePerMs(middleC);
+        double crowding = mu / parameters.carryingCapacityOD;
+
+        if (container.volumeMl <= 0) {
+            if (inflow > 0) {
+                container.od = odIn;
+            }
+        } else if (odIn > 0) {
+            double dilution = inflow / (ms * container.volumeMl);
+            double x = container.od;
+            double half = x + 0.5 * ms * ((mu - dilution) * x - crowding * x * x + dilution * odIn);
+            x += ms * ((mu - dilution) * half - crowding * half * half + dilution * odIn);
+            container.od = std::max(0.0, x);
+        } else if (container.od > 0) {
+            double dilution = inflow / (ms * container.volumeMl);
+            double r = mu - dilution;
+            double x0 = container.od;
+            if (std::abs(r) < 1e-15) {
+                container.od = x0 / (1 + crowding * x0 * ms);
+            } else {
+                double e = std::exp(r * ms);
+                container.od = (r * x0 * e) / (r + crowding * x0 * (e - 1));
+            }
+        }
+
+        container.volumeMl = std::max(0.0, container.volumeMl + inflow - outflowMl[entry.first]);
+        container.temperatureC = targetC + (container.temperatureC - targetC) * std::exp(-ms / parameters.heatingTimeConstantMs);
+    }
+}
+
+std::map<std::pair<std::string, std::string>, double> SimulatedActuatorsInterface::deliveredVolumes(double ms) const {
+    std::unordered_map<std::string, double> available;
+    std::unordered_map<std::string, double> demanded;
+    std::unordered_map<std::string, int> pendingSources;
+    for(const auto & entry: containers) {
+        available[entry.first] = entry.second.volumeMl;
+    }
+    for(const auto & flow: flowsMlPerMs) {
+        demanded[flow.first.first] += flow.second * ms;
+        pendingSources[flow.first.second]++;
+    }
+
+    // a container gives what it had plus what its own sources delivered, so sources are resolved first;
+    // inside a cycle the first unresolved container only counts what it already got
+    std::map<std::pair<std::string, std::string>, double> delivered;
+    std::unordered_map<std::string, bool> resolved;
+    for(size_t i = 0; i < containers.size(); i++) {
+        auto next = containers.end();
+        for(auto it = containers.begin(); it != containers.end(); ++it) {
+            if (!resolved[it->first]) {
+                if (pendingSources[it->first] == 0) {
+                    next = it;
+                    break;
+                } else if (next == containers.end()) {
+                    next = it;
+                }
+            }
+        }
+        const std::string & id = next->first;
+        resolved[id] = true;
+
+        double scale = demanded[id] > available[id] ? available[id] / demanded[id] : 1.0;
+        for(auto flow = flowsMlPerMs.lower_bound(std::make_pair(id, std::string()));
+            flow != flowsMlPerMs.end() && flow->first.first == id;
+            ++flow)
+        {
+            double volume = flow->second * ms * scale;
+            delivered[flow->first] = volume;
+            available[flow->first.second] += volume;
+            pendingSources[flow->first.second]--;
+        }
+    }
+    return delivered;
+}
+
+bool SimulatedActuatorsInterface::needsSubsteps() const {
+    if (!flowsMlPerMs.empty()) {
+        return true;
+    }
+    for(const auto & entry: containers) {
+        if (entry.second.od > 0 && std::abs(entry.second.temperatureC - targetTemperature(entry.second)) > 1e-3) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double SimulatedActuatorsInterface::growthRatePerMs(double temperatureC) const {
+    double deviation = (temperatureC - parameters.optimalTemperatureC) / parameters.temperatureToleranceC;
+    return parameters.maxGrowthRatePerHour * std::exp(-deviation * deviation) / (3600.0 * 1000.0);
+}
+
+double SimulatedActuatorsInterface::targetTemperature(const SimulatedContainer & container) const {
+    return container.heating ? container.setPointC : parameters.ambientTemperatureC;
+}
+
+void SimulatedActuatorsInterface::moveVolume(const std::string & idSource, const std::string & idTarget, double volumeMl) {
+    SimulatedContainer & source = advance(idSource);
+    SimulatedContainer & target = advance(idTarget);
+
+    double moved = std::min(volumeMl, source.volumeMl);
+    double totalVolume = target.volumeMl + moved;
+    if (totalVolume > 0) {
+        target.od = (target.od * target.volumeMl + source.od * moved) / totalVolume;
+        target.temperatureC = (target.temperatureC * target.volumeMl + source.temperatureC * moved) / totalVolume;
+    }
+    source.volumeMl -= moved;
+    target.volumeMl = totalVolume;
+}
@@ -0,0 +1,139 @@
+#ifndef SIMULATEDACTUATORSINTERFACE_H
+#define SIMULATEDACTUATORSINTERFACE_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <protocolGraph/execution_interface/actuatorsexecutioninterface.h>
+
+#include "ticktimebase.h"
+
+/**
+ * Local stand-in for a physical lab: keeps the volume, OD and temperature of every container.
+ *
+ * timeStep() only advances a clock. The lab is brought up to date lazily, all containers together, when an
+ * event touches it (a flow change, a measurement, a transfer...), so the cost of a simulation depends on
+ * the number of events and not on the number of slices:
+ *  - a continuous flow delivers what its source really had: sources are stepped before their targets and a
+ *    source that runs dry splits what it has among its outgoing flows, so volume is conserved,
+ *  - OD follows logistic growth with the dilution of the incoming flow (dx/dt = (mu - D)x - (mu/K)x^2),
+ *  - temperature relaxes exponentially to the applied set-point, or to ambient when none is applied.
+ * While pumps run, or a culture is still warming up, the interval is split in sub-steps of at most
+ * maxSubstepMs, each one with the growth rate at its midpoint temperature; otherwise it is one closed form step.
+ */
+class SimulatedActuatorsInterface : public ActuatorsExecutionInterface
+{
+public:
+    typedef struct SimulationParameters_ {
+        double maxGrowthRatePerHour = 0.7;
+        double carryingCapacityOD = 2.0;
+        double optimalTemperatureC = 37.0;
+        double temperatureToleranceC = 8.0;
+        double ambientTemperatureC = 25.0;
+        double heatingTimeConstantMs = 5 * 60 * 1000.0;
+        double pipettingRateMlPerS = 1.0;
+        double fluorescencePerOD = 1000.0;
+        double maxSubstepMs = 60 * 1000.0;
+    } SimulationParameters;
+
+    SimulatedActuatorsInterface();
+    SimulatedActuatorsInterface(const SimulationParameters & parameters);
+    virtual ~SimulatedActuatorsInterface();
+
+    void setInitialOD(const std::string & sourceId, double od);
+
+    virtual void applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity);
+    virtual void stopApplyLigth(const std::string & sourceId);
+
+    virtual void applyTemperature(const std::string & sourceId, units::Temperature temperature);
+    virtual void stopApplyTemperature(const std::string & sourceId);
+
+    virtual void stir(const std::string & idSource, units::Frequency intensity);
+    virtual void stopStir(const std::string & idSource);
+
+    virtual void centrifugate(const std::string & idSource, units::Frequency intensity);
+    virtual void stopCentrifugate(const std::string & idSource);
+
+    virtual void shake(const std::string & idSource, units::Frequency intensity);
+    virtual void stopShake(const std::string & idSource);
+
+    virtual void startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght);
+    virtual std::shared_ptr<ElectrophoresisResult> stopElectrophoresis(const std::string & idSource);
+
+    virtual units::Volume getVirtualVolume(const std::string & sourceId);
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual void startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength);
+    virtual double getMeasureOD(const std::string & sourceId);
+
+    virtual void startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+
+    virtual void startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+
+    virtual void startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+
+    virtual void startMeasureFluorescence(const std::string & sourceId,
+                                          units::Frequency measurementFrequency,
+                                          units::Length excitation,
+                                          units::Length emission);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual void setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate);
+    virtual void stopContinuosFlow(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume);
+    virtual void stopTransfer(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time mix(const std::string & idSource1,
+                            const std::string & idSource2,
+                            const std::string & idTarget,
+                            units::Volume volume1,
+                            units::Volume volume2);
+
+    virtual void stopMix(const std::string & idSource1,
+                         const std::string & idSource2,
+                         const std::string & idTarget);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    inline units::Time getSimulatedTime() const {
+        return TickTimebase::toTime(now);
+    }
+
+protected:
+    typedef struct SimulatedContainer_ {
+        double volumeMl = 0;
+        double od = 0;
+        double temperatureC = 0;
+        bool heating = false;
+        double setPointC = 0;
+    } SimulatedContainer;
+
+    SimulationParameters parameters;
+    TickTimebase::Ticks now;
+    TickTimebase::Ticks timeSlice;
+    TickTimebase::Ticks lastUpdate;
+
+    std::unordered_map<std::string, SimulatedContainer> containers;
+    std::map<std::pair<std::string, std::string>, double> flowsMlPerMs;
+
+    SimulatedContainer & getContainer(const std::string & sourceId);
+    SimulatedContainer & advance(const std::string & sourceId);
+
+    void step(double ms);
+    std::map<std::pair<std::string, std::string>, double> deliveredVolumes(double ms) const;
+    bool needsSubsteps() const;
+
+    double growthRatePerMs(double temperatureC) const;
+    double targetTemperature(const SimulatedContainer & container) const;
+
+    void moveVolume(const std::string & idSource, const std::string & idTarget, double volumeMl);
+};
+
+#endif // SIMULATEDACTUATORSINTERFACE_H
@@ -0,0 +1,82 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed-size single producer / single consumer queue without locks.
+ *
+ * The slots are allocated once, on construction; the producer only writes tail and the consumer only
+ * writes head (each on its own cache line), so one acquire/release pair per operation is all the
+ * synchronization needed. The capacity is rounded up to a power of two.
+ */
+template<typename T>
+class SpscRingBuffer
+{
+public:
+    SpscRingBuffer(std::size_t capacity) :
+        slots(roundCapacity(capacity)), mask(slots.size() - 1)
+    {
+        head = 0;
+        tail = 0;
+    }
+
+    virtual ~SpscRingBuffer() {}
+
+    bool tryPush(T && value) {
+        std::size_t actualTail = tail.load(std::memory_order_relaxed);
+        if (actualTail - head.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+        slots[actualTail & mask] = std::move(value);
+        tail.store(actualTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T & value) {
+        std::size_t actualHead = head.load(std::memory_order_relaxed);
+        if (actualHead == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots[actualHead & mask]);
+        head.store(actualHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** consumer side only, the slot stays valid until the next tryPop */
+    T* front() {
+        std::size_t actualHead = head.load(std::memory_order_relaxed);
+        if (actualHead == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots[actualHead & mask];
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    inline std::size_t capacity() const {
+        return slots.size();
+    }
+
+protected:
+    std::vector<T> slots;
+    std::size_t mask;
+
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::atomic<std::size_t> tail;
+
+    static std::size_t roundCapacity(std::size_t capacity) {
+        std::size_t rounded = 1;
+        while(rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -0,0 +1,487 @@
+#include "steadystateactuatorsinterface.h"
+
+SteadyStateActuatorsInterface::SteadyStateActuatorsInterface(
+        ActuatorsExecutionInterface* actuatorInterface,
+        unsigned int maxPeriodSlices,
+        bool expandPeriods) :
+    ForwardingActuatorsInterface(actuatorInterface), maxPeriodSlices(maxPeriodSlices), expandPeriods(expandPeriods),
+    formatter(std::vector<double>{0}, &formatted)
+{
+    slices = 0;
+    steady = false;
+    periodSlice = 0;
+    periodCall = 0;
+    periodReported = false;
+    skippedCalls = 0;
+    currentSlice.state = 0;
+}
+
+SteadyStateActuatorsInterface::~SteadyStateActuatorsInterface()
+{
+
+}
+
+void SteadyStateActuatorsInterface::setSliceState(unsigned long long state) {
+    currentSlice.state = state;
+    slices++;
+
+    if (steady && (periodCall != period[periodSlice].calls.size() || state != period[periodSlice].state)) {
+        leaveSteadyState();
+    }
+
+    if (steady) {
+        periodCall = 0;
+        periodSlice++;
+        if (periodSlice == period.size()) {
+            periodSlice = 0;
+            if (!periodReported) {
+                RepeatedPeriod repeatedPeriod;
+                repeatedPeriod.firstSlice = slices - period.size();
+                repeatedPeriod.periodSlices = period.size();
+                repeatedPeriod.periods = 0;
+                repeatedPeriod.commands = 0;
+                for(const SliceRecord & slice: period) {
+                    for(const RecordedCall & call: slice.calls) {
+                        repeatedPeriod.period.push_back(call.text);
+                        repeatedPeriod.commands += call.read ? 0 : 1;
+                    }
+                }
+                repeatedPeriods.push_back(repeatedPeriod);
+                periodReported = true;
+            }
+            repeatedPeriods.back().periods++;
+
+            if (!expandPeriods) {
+                skippedCalls += heldCalls.size();
+                heldCalls.clear();
+            }
+        }
+    }
+
+    history.push_back(currentSlice);
+    while (history.size() > 2 * (size_t) maxPeriodSlices) {
+        history.pop_front();
+    }
+    currentSlice = SliceRecord();
+    currentSlice.state = 0;
+
+    if (!steady) {
+        detectPeriod();
+    }
+}
+
+void SteadyStateActuatorsInterface::finish() {
+    if (steady) {
+        leaveSteadyState();
+    }
+}
+
+void SteadyStateActuatorsInterface::applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity) {
+    formatter.applyLigth(sourceId, wavelength, intensity);
+
+    if (!hold([=]() { actuatorInterface->applyLigth(sourceId, wavelength, intensity); })) {
+        actuatorInterface->applyLigth(sourceId, wavelength, intensity);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::stopApplyLigth(const std::string & sourceId) {
+    formatter.stopApplyLigth(sourceId);
+
+    if (!hold([=]() { actuatorInterface->stopApplyLigth(sourceId); })) {
+        actuatorInterface->stopApplyLigth(sourceId);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::applyTemperature(const std::string & sourceId, units::Temperature temperature) {
+    formatter.applyTemperature(sourceId, temperature);
+
+    if (!hold([=]() { actuatorInterface->applyTemperature(sourceId, temperature); })) {
+        actuatorInterface->applyTemperature(sourceId, temperature);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::stopApplyTemperature(const std::string & sourceId) {
+    formatter.stopApplyTemperature(sourceId);
+
+    if (!hold([=]() { actuatorInterface->stopApplyTemperature(sourceId); })) {
+        actuatorInterface->stopApplyTemperature(sourceId);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::stir(const std::string & idSource, units::Frequency intensity) {
+    formatter.stir(idSource, intensity);
+
+    if (!hold([=]() { actuatorInterface->stir(idSource, intensity); })) {
+        actuatorInterface->stir(idSource, intensity);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::stopStir(const std::string & idSource) {
+    formatter.stopStir(idSource);
+
+    if (!hold([=]() { actuatorInterface->stopStir(idSource); })) {
+        actuatorInterface->stopStir(idSource);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::centrifugate(const std::string & idSource, units::Frequency intensity) {
+    formatter.centrifugate(idSource, intensity);
+
+    if (!hold([=]() { actuatorInterface->centrifugate(idSource, intensity); })) {
+        actuatorInterface->centrifugate(idSource, intensity);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::stopCentrifugate(const std::string & idSource) {
+    formatter.stopCentrifugate(idSource);
+
+    if (!hold([=]() { actuatorInterface->stopCentrifugate(idSource); })) {
+        actuatorInterface->stopCentrifugate(idSource);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::shake(const std::string & idSource, units::Frequency intensity) {
+    formatter.shake(idSource, intensity);
+
+    if (!hold([=]() { actuatorInterface->shake(idSource, intensity); })) {
+        actuatorInterface->shake(idSource, intensity);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::stopShake(const std::string & idSource) {
+    formatter.stopShake(idSource);
+
+    if (!hold([=]() { actuatorInterface->stopShake(idSource); })) {
+        actuatorInterface->stopShake(idSource);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght) {
+    formatter.startElectrophoresis(idSource, fieldStrenght);
+
+    if (!hold([=]() { actuatorInterface->startElectrophoresis(idSource, fieldStrenght); })) {
+        actuatorInterface->startElectrophoresis(idSource, fieldStrenght);
+        forwarded(0);
+    }
+}
+
+std::shared_ptr<ElectrophoresisResult> SteadyStateActuatorsInterface::stopElectrophoresis(const std::string & idSource) {
+    formatter.stopElectrophoresis(idSource);
+    pendingCall = takeFormatted();
+    if (steady && !expandPeriods) {
+        leaveSteadyState();
+    }
+
+    std::shared_ptr<ElectrophoresisResult> result = actuatorInterface->stopElectrophoresis(idSource);
+    forwarded(0, true);
+    return result;
+}
+
+units::Volume SteadyStateActuatorsInterface::getVirtualVolume(const std::string & sourceId) {
+    formatter.getVirtualVolume(sourceId);
+
+    beforeRead();
+    units::Volume value = actuatorInterface->getVirtualVolume(sourceId);
+    forwarded(value.to(units::ml), true);
+    return value;
+}
+
+void SteadyStateActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    formatter.loadContainer(sourceId, initialVolume);
+
+    if (!hold([=]() { actuatorInterface->loadContainer(sourceId, initialVolume); })) {
+        actuatorInterface->loadContainer(sourceId, initialVolume);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::startMeasureOD(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length wavelength)
+{
+    formatter.startMeasureOD(sourceId, measurementFrequency, wavelength);
+
+    if (!hold([=]() { actuatorInterface->startMeasureOD(sourceId, measurementFrequency, wavelength); })) {
+        actuatorInterface->startMeasureOD(sourceId, measurementFrequency, wavelength);
+        forwarded(0);
+    }
+}
+
+double SteadyStateActuatorsInterface::getMeasureOD(const std::string & sourceId) {
+    formatter.getMeasureOD(sourceId);
+
+    beforeRead();
+    double value = actuatorInterface->getMeasureOD(sourceId);
+    forwarded(value, true);
+    return value;
+}
+
+void SteadyStateActuatorsInterface::startMeasureTemperature(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    formatter.startMeasureTemperature(sourceId, measurementFrequency);
+
+    if (!hold([=]() { actuatorInterface->startMeasureTemperature(sourceId, measurementFrequency); })) {
+        actuatorInterface->startMeasureTemperature(sourceId, measurementFrequency);
+        forwarded(0);
+    }
+}
+
+units::Temperature SteadyStateActuatorsInterface::getMeasureTemperature(const std::string & sourceId) {
+    formatter.getMeasureTemperature(sourceId);
+
+    beforeRead();
+    units::Temperature value = actuatorInterface->getMeasureTemperature(sourceId);
+    forwarded(value.to(units::C), true);
+    return value;
+}
+
+void SteadyStateActuatorsInterface::startMeasureLuminiscense(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    formatter.startMeasureLuminiscense(sourceId, measurementFrequency);
+
+    if (!hold([=]() { actuatorInterface->startMeasureLuminiscense(sourceId, measurementFrequency); })) {
+        actuatorInterface->startMeasureLuminiscense(sourceId, measurementFrequency);
+        forwarded(0);
+    }
+}
+
+units::LuminousIntensity SteadyStateActuatorsInterface::getMeasureLuminiscense(const std::string & sourceId) {
+    formatter.getMeasureLuminiscense(sourceId);
+
+    beforeRead();
+    units::LuminousIntensity value = actuatorInterface->getMeasureLuminiscense(sourceId);
+    forwarded(value.to(units::cd), true);
+    return value;
+}
+
+void SteadyStateActuatorsInterface::startMeasureVolume(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency)
+{
+    formatter.startMeasureVolume(sourceId, measurementFrequency);
+
+    if (!hold([=]() { actuatorInterface->startMeasureVolume(sourceId, measurementFrequency); })) {
+        actuatorInterface->startMeasureVolume(sourceId, measurementFrequency);
+        forwarded(0);
+    }
+}
+
+units::Volume SteadyStateActuatorsInterface::getMeasureVolume(const std::string & sourceId) {
+    formatter.getMeasureVolume(sourceId);
+
+    beforeRead();
+    units::Volume value = actuatorInterface->getMeasureVolume(sourceId);
+    forwarded(value.to(units::ml), true);
+    return value;
+}
+
+void SteadyStateActuatorsInterface::startMeasureFluorescence(
+        const std::string & sourceId,
+        units::Frequency measurementFrequency,
+        units::Length excitation,
+        units::Length emission)
+{
+    formatter.startMeasureFluorescence(sourceId, measurementFrequency, excitation, emission);
+
+    if (!hold([=]() { actuatorInterface->startMeasureFluorescence(sourceId, measurementFrequency, excitation, emission); })) {
+        actuatorInterface->startMeasureFluorescence(sourceId, measurementFrequency, excitation, emission);
+        forwarded(0);
+    }
+}
+
+units::LuminousIntensity SteadyStateActuatorsInterface::getMeasureFluorescence(const std::string & sourceId) {
+    formatter.getMeasureFluorescence(sourceId);
+
+    beforeRead();
+    units::LuminousIntensity value = actuatorInterface->getMeasureFluorescence(sourceId);
+    forwarded(value.to(units::cd), true);
+    return value;
+}
+
+void SteadyStateActuatorsInterface::setContinuosFlow(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volumetric_Flow rate)
+{
+    formatter.setContinuosFlow(idSource, idTarget, rate);
+
+    if (!hold([=]() { actuatorInterface->setContinuosFlow(idSource, idTarget, rate); })) {
+        actuatorInterface->setContinuosFlow(idSource, idTarget, rate);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::stopContinuosFlow(const std::string & idSource, const std::string & idTarget) {
+    formatter.stopContinuosFlow(idSource, idTarget);
+
+    if (!hold([=]() { actuatorInterface->stopContinuosFlow(idSource, idTarget); })) {
+        actuatorInterface->stopContinuosFlow(idSource, idTarget);
+        forwarded(0);
+    }
+}
+
+units::Time SteadyStateActuatorsInterface::transfer(
+        const std::string & idSource,
+        const std::string & idTarget,
+        units::Volume volume)
+{
+    formatter.transfer(idSource, idTarget, volume);
+
+    beforeRead();
+    units::Time value = actuatorInterface->transfer(idSource, idTarget, volume);
+    forwarded(value.to(units::ms), true);
+    return value;
+}
+
+void SteadyStateActuatorsInterface::stopTransfer(const std::string & idSource, const std::string & idTarget) {
+    formatter.stopTransfer(idSource, idTarget);
+
+    if (!hold([=]() { actuatorInterface->stopTransfer(idSource, idTarget); })) {
+        actuatorInterface->stopTransfer(idSource, idTarget);
+        forwarded(0);
+    }
+}
+
+units::Time SteadyStateActuatorsInterface::mix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget,
+        units::Volume volume1,
+        units::Volume volume2)
+{
+    formatter.mix(idSource1, idSource2, idTarget, volume1, volume2);
+
+    beforeRead();
+    units::Time value = actuatorInterface->mix(idSource1, idSource2, idTarget, volume1, volume2);
+    forwarded(value.to(units::ms), true);
+    return value;
+}
+
+void SteadyStateActuatorsInterface::stopMix(
+        const std::string & idSource1,
+        const std::string & idSource2,
+        const std::string & idTarget)
+{
+    formatter.stopMix(idSource1, idSource2, idTarget);
+
+    if (!hold([=]() { actuatorInterface->stopMix(idSource1, idSource2, idTarget); })) {
+        actuatorInterface->stopMix(idSource1, idSource2, idTarget);
+        forwarded(0);
+    }
+}
+
+void SteadyStateActuatorsInterface::setTimeStep(units::Time time) {
+    formatter.setTimeStep(time);
+
+    if (!hold([=]() { actuatorInterface->setTimeStep(time); })) {
+        actuatorInterface->setTimeStep(time);
+        forwarded(0);
+    }
+}
+
+units::Time SteadyStateActuatorsInterface::timeStep() {
+    formatter.timeStep();
+
+    beforeRead();
+    units::Time value = actuatorInterface->timeStep();
+    forwarded(value.to(units::ms), true);
+    return value;
+}
+
+bool SteadyStateActuatorsInterface::hold(std::function<void()> call) {
+    pendingCall = takeFormatted();
+    if (!steady) {
+        return false;
+    }
+
+    const SliceRecord & expected = period[periodSlice];
+    if (periodCall >= expected.calls.size() || expected.calls[periodCall].text != pendingCall) {
+        leaveSteadyState();
+        return false;
+    }
+    if (expandPeriods) {
+        return false;
+    }
+
+    currentSlice.calls.push_back(expected.calls[periodCall]);
+    heldCalls.push_back(call);
+    periodCall++;
+    return true;
+}
+
+void SteadyStateActuatorsInterface::beforeRead() {
+    pendingCall = takeFormatted();
+    if (steady) {
+        const std::vector<RecordedCall> & expected = period[periodSlice].calls;
+        if (periodCall >= expected.size() || expected[periodCall].text != pendingCall) {
+            // the held commands go before the read, as they were issued
+            leaveSteadyState();
+        }
+    }
+}
+
+double SteadyStateActuatorsInterface::forwarded(double value, bool read) {
+    RecordedCall call;
+    call.text = pendingCall;
+    call.value = value;
+    call.read = read;
+    currentSlice.calls.push_back(call);
+
+    if (steady) {
+        const std::vector<RecordedCall> & expected = period[periodSlice].calls;
+        if (periodCall < expected.size() && expected[periodCall] == call) {
+            periodCall++;
+        } else {
+            leaveSteadyState();
+        }
+    }
+    return value;
+}
+
+void SteadyStateActuatorsInterface::leaveSteadyState() {
+    steady = false;
+    for(const std::function<void()> & call: heldCalls) {
+        call();
+    }
+    heldCalls.clear();
+}
+
+void SteadyStateActuatorsInterface::detectPeriod() {
+    size_t size = history.size();
+    for(size_t periodSize = 1; periodSize <= maxPeriodSlices && 2 * periodSize <= size; periodSize++) {
+        bool repeated = true;
+        for(size_t i = size - periodSize; repeated && i < size; i++) {
+            repeated = history[i] == history[i - periodSize];
+        }
+
+        if (repeated) {
+            steady = true;
+            period.assign(history.end() - periodSize, history.end());
+            periodSlice = 0;
+            periodCall = 0;
+            periodReported = false;
+            return;
+        }
+    }
+}
+
+std::string SteadyStateActuatorsInterface::takeFormatted() {
+    std::string text = formatted.str();
+    formatted.str("");
+    return text;
+}
@@ -0,0 +1,172 @@
+#ifndef STEADYSTATEACTUATORSINTERFACE_H
+#define STEADYSTATEACTUATORSINTERFACE_H
+
+#include <deque>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "forwardingactuatorsinterface.h"
+#include "stringactuatorsinterface.h"
+
+/**
+ * Detects when an execution repeats itself slice by slice and compresses the commands of the repeated periods.
+ *
+ * Every slice is recorded as the calls issued in it (as StringActuatorsInterface writes them), the values
+ * they returned and the execution state given by setSliceState(). When the last two groups of P slices are
+ * equal, P <= maxPeriodSlices, the execution is in steady state and the following slices are checked
+ * against that period until a call, a value or the state is different.
+ *
+ * Reads are never answered from the period: every call that returns a value (measurements, volumes, the
+ * durations of transfer and mix, time steps) reaches the backend, and a value different from the period
+ * leaves the steady state; the commands held in that period are sent then, right after the read. With
+ * expandPeriods the backend still receives every command and the repeated
+ * periods are only reported. Without it the commands of a repeated period are not sent again: they are held
+ * until the period completes and then dropped, so only the commands that break the steady state, and the
+ * incomplete period before them, reach the backend. getRepeatedPeriods() tells where the periods were
+ * repeated, how many times and how many commands each dropped. The execution itself is not shortened.
+ */
+class SteadyStateActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    typedef struct RepeatedPeriod_ {
+        unsigned long long firstSlice;
+        unsigned long long periodSlices;
+        unsigned long long periods;
+        unsigned long long commands;
+        std::vector<std::string> period;
+    } RepeatedPeriod;
+
+    SteadyStateActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface,
+                                  unsigned int maxPeriodSlices = 64,
+                                  bool expandPeriods = true);
+    virtual ~SteadyStateActuatorsInterface();
+
+    void setSliceState(unsigned long long state);
+    void finish();
+
+    virtual void applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity);
+    virtual void stopApplyLigth(const std::string & sourceId);
+
+    virtual void applyTemperature(const std::string & sourceId, units::Temperature temperature);
+    virtual void stopApplyTemperature(const std::string & sourceId);
+
+    virtual void stir(const std::string & idSource, units::Frequency intensity);
+    virtual void stopStir(const std::string & idSource);
+
+    virtual void centrifugate(const std::string & idSource, units::Frequency intensity);
+    virtual void stopCentrifugate(const std::string & idSource);
+
+    virtual void shake(const std::string & idSource, units::Frequency intensity);
+    virtual void stopShake(const std::string & idSource);
+
+    virtual void startElectrophoresis(const std::string & idSource, units::ElectricField fieldStrenght);
+    virtual std::shared_ptr<ElectrophoresisResult> stopElectrophoresis(const std::string & idSource);
+
+    virtual units::Volume getVirtualVolume(const std::string & sourceId);
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual void startMeasureOD(const std::string & sourceId, units::Frequency measurementFrequency, units::Length wavelength);
+    virtual double getMeasureOD(const std::string & sourceId);
+
+    virtual void startMeasureTemperature(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Temperature getMeasureTemperature(const std::string & sourceId);
+
+    virtual void startMeasureLuminiscense(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::LuminousIntensity getMeasureLuminiscense(const std::string & sourceId);
+
+    virtual void startMeasureVolume(const std::string & sourceId, units::Frequency measurementFrequency);
+    virtual units::Volume getMeasureVolume(const std::string & sourceId);
+
+    virtual void startMeasureFluorescence(const std::string & sourceId,
+                                          units::Frequency measurementFrequency,
+                                          units::Length excitation,
+                                          units::Length emission);
+    virtual units::LuminousIntensity getMeasureFluorescence(const std::string & sourceId);
+
+    virtual void setContinuosFlow(const std::string & idSource, const std::string & idTarget, units::Volumetric_Flow rate);
+    virtual void stopContinuosFlow(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time transfer(const std::string & idSource, const std::string & idTarget, units::Volume volume);
+    virtual void stopTransfer(const std::string & idSource, const std::string & idTarget);
+
+    virtual units::Time mix(const std::string & idSource1,
+                            const std::string & idSource2,
+                            const std::string & idTarget,
+                            units::Volume volume1,
+                            units::Volume volume2);
+
+    virtual void stopMix(const std::string & idSource1,
+                         const std::string & idSource2,
+                         const std::string & idTarget);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    inline bool isSteady() const {
+        return steady;
+    }
+
+    inline const std::vector<RepeatedPeriod> & getRepeatedPeriods() const {
+        return repeatedPeriods;
+    }
+
+    inline unsigned long long getSkippedCalls() const {
+        return skippedCalls;
+    }
+
+    inline unsigned long long getSlices() const {
+        return slices;
+    }
+
+protected:
+    typedef struct RecordedCall_ {
+        std::string text;
+        double value;
+        bool read;
+
+        bool operator==(const RecordedCall_ & other) const {
+            return text == other.text && value == other.value;
+        }
+    } RecordedCall;
+
+    typedef struct SliceRecord_ {
+        std::vector<RecordedCall> calls;
+        unsigned long long state;
+
+        bool operator==(const SliceRecord_ & other) const {
+            return state == other.state && calls == other.calls;
+        }
+    } SliceRecord;
+
+    unsigned int maxPeriodSlices;
+    bool expandPeriods;
+
+    std::ostringstream formatted;
+    StringActuatorsInterface formatter;
+
+    std::deque<SliceRecord> history;
+    SliceRecord currentSlice;
+    unsigned long long slices;
+
+    bool steady;
+    std::vector<SliceRecord> period;
+    size_t periodSlice;
+    size_t periodCall;
+    bool periodReported;
+    std::string pendingCall;
+    std::vector<std::function<void()>> heldCalls;
+
+    std::vector<RepeatedPeriod> repeatedPeriods;
+    unsigned long long skippedCalls;
+
+    bool hold(std::function<void()> call);
+    void beforeRead();
+    double forwarded(double value, bool read = false);
+    void leaveSteadyState();
+    void detectPeriod();
+    std::string takeFormatted();
+};
+
+#endif // STEADYSTATEACTUATORSINTERFACE_H
@@ -0,0 +1,65 @@
+#include "steadystateexecutor.h"
+
+namespace {
+
+void hashBytes(unsigned long long & hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for(size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+void hashString(unsigned long long & hash, const std::string & text) {
+    hashBytes(hash, text.data(), text.size() + 1);
+}
+
+}
+
+SteadyStateExecutor::SteadyStateExecutor(
+        std::shared_ptr<ProtocolGraph> protocol,
+        ActuatorsExecutionInterface* actuatorInterface,
+        unsigned int maxPeriodSlices,
+        bool expandPeriods) :
+    steadyInterface(actuatorInterface, maxPeriodSlices, expandPeriods), executor(protocol, &steadyInterface)
+{
+
+}
+
+SteadyStateExecutor::~SteadyStateExecutor()
+{
+
+}
+
+void SteadyStateExecutor::execute() {
+    unsigned long long slices = executor.getElapsedSlices();
+    while(executor.executeNextNode()) {
+        if (executor.getElapsedSlices() != slices) {
+            slices = executor.getElapsedSlices();
+            steadyInterface.setSliceState(stateHash());
+        }
+    }
+    steadyInterface.finish();
+}
+
+unsigned long long SteadyStateExecutor::stateHash() const {
+    ExecutionCheckpoint checkpoint = executor.makeCheckpoint();
+
+    unsigned long long hash = 14695981039346656037ULL;
+    for(int node: checkpoint.frontier) {
+        hashBytes(hash, &node, sizeof(node));
+    }
+    for(const ActiveCommand & command: checkpoint.activeCommands) {
+        hashBytes(hash, &command.type, sizeof(command.type));
+        hashString(hash, command.source);
+        hashString(hash, command.target);
+        for(double value: command.values) {
+            hashBytes(hash, &value, sizeof(value));
+        }
+    }
+    for(const std::pair<const std::string, double> & variable: checkpoint.variables) {
+        hashString(hash, variable.first);
+        hashBytes(hash, &variable.second, sizeof(variable.second));
+    }
+    return hash;
+}
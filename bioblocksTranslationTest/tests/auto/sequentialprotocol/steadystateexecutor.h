@@ -0,0 +1,50 @@
+#ifndef STEADYSTATEEXECUTOR_H
+#define STEADYSTATEEXECUTOR_H
+
+#include <memory>
+
+#include <protocolGraph/ProtocolGraph.h>
+
+#include "protocolexecutor.h"
+#include "steadystateactuatorsinterface.h"
+
+/**
+ * Executes a ProtocolGraph through a SteadyStateActuatorsInterface, giving it the execution state of every
+ * slice: frontier, active operations and, when the variable hooks of the executor are set, the variables.
+ *
+ * The graph keeps its variables (the clock included) inside ProtocolGraph and does not let them be moved,
+ * so its nodes are executed one by one and every slice takes as long as without the interface; what the
+ * interface compresses are the commands of the repeated periods, the reads and time steps always reach
+ * the backend.
+ */
+class SteadyStateExecutor
+{
+public:
+    SteadyStateExecutor(std::shared_ptr<ProtocolGraph> protocol,
+                        ActuatorsExecutionInterface* actuatorInterface,
+                        unsigned int maxPeriodSlices = 64,
+                        bool expandPeriods = true);
+    virtual ~SteadyStateExecutor();
+
+    void execute();
+
+    inline const std::vector<SteadyStateActuatorsInterface::RepeatedPeriod> & getRepeatedPeriods() const {
+        return steadyInterface.getRepeatedPeriods();
+    }
+
+    inline unsigned long long getSkippedCalls() const {
+        return steadyInterface.getSkippedCalls();
+    }
+
+    inline ProtocolExecutor & getExecutor() {
+        return executor;
+    }
+
+protected:
+    SteadyStateActuatorsInterface steadyInterface;
+    ProtocolExecutor executor;
+
+    unsigned long long stateHash() const;
+};
+
+#endif // STEADYSTATEEXECUTOR_H
@@ -1,6 +1,7 @@
 #ifndef STRINGACTUATORSINTERFACE_H
 #define STRINGACTUATORSINTERFACE_H
 
+#include <ostream>
 #include <sstream>
 #include <vector>
 
@@ -11,6 +12,8 @@ class StringActuatorsInterface : public ActuatorsExecutionInterface
 {
 public:
     StringActuatorsInterface(const std::vector<double> & measureValues);
+    /** writes the commands to output instead of the internal stream, output is not owned */
+    StringActuatorsInterface(const std::vector<double> & measureValues, std::ostream* output);
     virtual ~StringActuatorsInterface();
 
     virtual void applyLigth(const std::string & sourceId, units::Length wavelength, units::LuminousIntensity intensity);
@@ -78,6 +81,7 @@ public:
 protected:
     units::Time timeSlice;
     std::stringstream stream;
+    std::ostream* output;
 
     AutoEnumerate actualValueSerie;
     std::vector<double> measureValues;
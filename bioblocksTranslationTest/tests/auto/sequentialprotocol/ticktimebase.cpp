@@ -0,0 +1,121 @@
+#include "ticktimebase.h"
+
+#include <cctype>
+#include <cmath>
+
+namespace {
+
+// digits of the fraction taken into account, more would overflow fraction * unitTicks("day")
+const int maxFractionDigits = 8;
+
+}
+
+const TickTimebase::Ticks TickTimebase::TICKS_PER_MS;
+const TickTimebase::Ticks TickTimebase::UNBOUNDED;
+
+TickTimebase::Ticks TickTimebase::parse(const std::string & value, const std::string & units) throw(std::invalid_argument) {
+    Ticks unit = unitTicks(units);
+
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < value.size() && (value[pos] == '-' || value[pos] == '+')) {
+        negative = value[pos] == '-';
+        pos++;
+    }
+
+    Ticks integer = 0;
+    size_t firstDigit = pos;
+    for(; pos < value.size() && std::isdigit((unsigned char) value[pos]); pos++) {
+        integer = integer * 10 + (value[pos] - '0');
+        if (integer > UNBOUNDED / unit) {
+            throw(std::invalid_argument("time " + value + " " + units + " out of range"));
+        }
+    }
+
+    Ticks fraction = 0;
+    Ticks denominator = 1;
+    if (pos < value.size() && value[pos] == '.') {
+        pos++;
+        for(int digits = 0; pos < value.size() && std::isdigit((unsigned char) value[pos]); pos++, digits++) {
+            if (digits < maxFractionDigits) {
+                fraction = fraction * 10 + (value[pos] - '0');
+                denominator *= 10;
+            }
+        }
+    }
+
+    if (pos == firstDigit || pos != value.size()) {
+        // exponents and the like, rare enough to go through a double
+        try {
+            return (Ticks) std::llround(std::stod(value) * unit);
+        } catch (std::exception & e) {
+            throw(std::invalid_argument("imposible to parse time " + value));
+        }
+    }
+
+    Ticks ticks = integer * unit + (fraction * unit + denominator / 2) / denominator;
+    return negative ? -ticks : ticks;
+}
+
+TickTimebase::Ticks TickTimebase::unitTicks(const std::string & units) throw(std::invalid_argument) {
+    if (units == "ms") {
+        return TICKS_PER_MS;
+    } else if (units == "s") {
+        return 1000 * TICKS_PER_MS;
+    } else if (units == "minute" || units == "min") {
+        return 60 * 1000 * TICKS_PER_MS;
+    } else if (units == "hr" || units == "h" || units == "hour") {
+        return 60 * 60 * 1000 * TICKS_PER_MS;
+    } else if (units == "day") {
+        return 24LL * 60 * 60 * 1000 * TICKS_PER_MS;
+    }
+    throw(std::invalid_argument("unknown time units " + units));
+}
+
+TickTimebase::Ticks TickTimebase::fromTime(units::Time time) {
+    return (Ticks) std::llround(time.to(units::ms) * TICKS_PER_MS);
+}
+
+units::Time TickTimebase::toTime(Ticks ticks) {
+    return ((double) ticks / TICKS_PER_MS) * units::ms;
+}
+
+double TickTimebase::toMs(Ticks ticks) {
+    if (ticks == UNBOUNDED) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return (double) ticks / TICKS_PER_MS;
+}
+
+TickTimebase::Ticks TickTimebase::add(Ticks a, Ticks b) {
+    if (a == UNBOUNDED || b == UNBOUNDED) {
+        return UNBOUNDED;
+    }
+    if (b > 0 && a >= UNBOUNDED - b) {
+        return UNBOUNDED;
+    } else if (b < 0 && a < std::numeric_limits<Ticks>::min() - b) {
+        return std::numeric_limits<Ticks>::min();
+    }
+    return a + b;
+}
+
+TickTimebase::Ticks TickTimebase::multiply(Ticks ticks, std::uint64_t times) {
+    if (times == 0 || ticks == 0) {
+        return 0;
+    } else if (ticks == UNBOUNDED) {
+        return UNBOUNDED;
+    }
+    if (ticks > 0 && times > (std::uint64_t) (UNBOUNDED / ticks)) {
+        return UNBOUNDED;
+    } else if (ticks < 0 && times > (std::uint64_t) (std::numeric_limits<Ticks>::min() / ticks)) {
+        return std::numeric_limits<Ticks>::min();
+    }
+    return ticks * (Ticks) times;
+}
+
+std::uint64_t TickTimebase::slicesFor(Ticks duration, Ticks slice) {
+    if (duration <= 0 || slice <= 0) {
+        return 0;
+    }
+    return (std::uint64_t) ((duration + slice - 1) / slice);
+}
@@ -0,0 +1,44 @@
+#ifndef TICKTIMEBASE_H
+#define TICKTIMEBASE_H
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <utils/units.h>
+
+/**
+ * Integer timebase for scheduling: every time is a signed 64-bit count of microsecond ticks.
+ *
+ * Protocol times are parsed from their decimal text straight into ticks, without going through a double,
+ * so "0.1" s is exactly 100000 ticks and adding it 36000 times is exactly one hour. units::Time is only
+ * built at the actuator boundary, from the tick count, and read back once when the backend sets the slice.
+ * UNBOUNDED stands for an unknown upper bound and absorbs any addition or multiplication. add() and
+ * multiply() are checked: a result past the range of Ticks (some 292000 years) is UNBOUNDED too, never a
+ * wrapped value, so a caller that needs a finite time tells an overflow by comparing with UNBOUNDED.
+ */
+class TickTimebase
+{
+public:
+    typedef std::int64_t Ticks;
+
+    static const Ticks TICKS_PER_MS = 1000;
+    static const Ticks UNBOUNDED = std::numeric_limits<Ticks>::max();
+
+    static Ticks parse(const std::string & value, const std::string & units) throw(std::invalid_argument);
+    static Ticks unitTicks(const std::string & units) throw(std::invalid_argument);
+
+    static Ticks fromTime(units::Time time);
+    static units::Time toTime(Ticks ticks);
+    static double toMs(Ticks ticks);
+
+    static Ticks add(Ticks a, Ticks b);
+    static Ticks multiply(Ticks ticks, std::uint64_t times);
+    static std::uint64_t slicesFor(Ticks duration, Ticks slice);
+
+private:
+    TickTimebase() {}
+};
+
+#endif // TICKTIMEBASE_H
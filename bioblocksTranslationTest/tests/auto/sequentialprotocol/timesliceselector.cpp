@@ -0,0 +1,114 @@
+#include "timesliceselector.h"
+
+#include <cmath>
+
+#include "protocolanalyzer.h"
+#include "protocoljson.h"
+
+namespace {
+
+std::uint64_t gcd(std::uint64_t a, std::uint64_t b) {
+    while (b != 0) {
+        std::uint64_t rest = a % b;
+        a = b;
+        b = rest;
+    }
+    return a;
+}
+
+}
+
+TimeSliceSelector::TimeSliceSelector(units::Time fallbackSlice, bool alignMeasurements) :
+    fallbackSlice(fallbackSlice), alignMeasurements(alignMeasurements)
+{
+
+}
+
+TimeSliceSelector::~TimeSliceSelector()
+{
+
+}
+
+units::Time TimeSliceSelector::selectTimeSlice(const std::string & path) throw(std::invalid_argument) {
+    return selectTimeSlice(ProtocolJson::read(path));
+}
+
+units::Time TimeSliceSelector::selectTimeSlice(const nlohmann::json & protocol) throw(std::invalid_argument) {
+    std::uint64_t divisor = 0;
+    try {
+        collectTimes(protocol, divisor);
+    } catch (std::invalid_argument & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument(std::string("malformed protocol: ") + e.what()));
+    }
+
+    if (divisor == 0) {
+        return fallbackSlice;
+    }
+    return TickTimebase::toTime(divisor);
+}
+
+TimeSliceSelector::TimeSliceReport TimeSliceSelector::report(const std::string & path, units::Time referenceSlice) throw(std::invalid_argument) {
+    nlohmann::json protocol = ProtocolJson::read(path);
+
+    ProtocolAnalyzer analyzer;
+    ProtocolAnalyzer::ProtocolAnalysis analysis = analyzer.analyze(protocol);
+
+    TickTimebase::Ticks slice = TickTimebase::fromTime(selectTimeSlice(protocol));
+    TickTimebase::Ticks reference = TickTimebase::fromTime(referenceSlice);
+
+    TimeSliceReport report;
+    report.sliceMs = TickTimebase::toMs(slice);
+    report.referenceSliceMs = TickTimebase::toMs(reference);
+    report.durationBounded = analysis.maxDuration != TickTimebase::UNBOUNDED;
+    // loops and unknown durations have no upper bound, the lower bound still compares both slices
+    TickTimebase::Ticks duration = report.durationBounded ? analysis.maxDuration : analysis.minDuration;
+    report.protocolDurationMs = TickTimebase::toMs(duration);
+    report.ticks = TickTimebase::slicesFor(duration, slice);
+    report.referenceTicks = TickTimebase::slicesFor(duration, reference);
+    report.tickReduction = report.ticks > 0 ? (double) report.referenceTicks / report.ticks : 1.0;
+    return report;
+}
+
+std::shared_ptr<ProtocolGraph> TimeSliceSelector::translateFile(const std::string & path) throw(std::invalid_argument) {
+    BioBlocksTranslator translator(selectTimeSlice(path), path);
+    return translator.translateFile();
+}
+
+void TimeSliceSelector::collectTimes(const nlohmann::json & value, std::uint64_t & divisor) const throw(std::invalid_argument) {
+    if (value.is_array()) {
+        for(const nlohmann::json & element: value) {
+            collectTimes(element, divisor);
+        }
+        return;
+    } else if (!value.is_object()) {
+        return;
+    }
+
+    for(auto it = value.begin(); it != value.end(); ++it) {
+        const std::string & key = it.key();
+        if (key == "timeOfOperation" || key == "duration") {
+            addTime(ProtocolJson::timeToTicks(value, key, key + "_units"), divisor);
+        } else if (key.compare(0, 8, "duration") == 0 && value.count("duration_units" + key.substr(8)) > 0) {
+            // thermocycling steps: durationN, duration_unitsN
+            addTime(ProtocolJson::timeToTicks(value, key, "duration_units" + key.substr(8)), divisor);
+        } else if (key == "measurement_frequency" && alignMeasurements &&
+                   ProtocolJson::isBlock(it.value(), "math_number"))
+        {
+            double hz = std::stod(it.value()["value"].get<std::string>()) * ProtocolJson::unitToHz(value["unit_frequency"].get<std::string>());
+            if (hz > 0) {
+                addTime((TickTimebase::Ticks) std::llround(1000.0 * TickTimebase::TICKS_PER_MS / hz), divisor);
+            }
+        } else {
+            collectTimes(it.value(), divisor);
+        }
+    }
+}
+
+void TimeSliceSelector::addTime(TickTimebase::Ticks time, std::uint64_t & divisor) {
+    // negative times mean "linked to the previous operation", zero is a multiple of anything
+    if (time > 0) {
+        divisor = gcd(divisor, (std::uint64_t) time);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef TIMESLICESELECTOR_H
+#define TIMESLICESELECTOR_H
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <json.hpp>
+
+#include <bioblocksTranslation/bioblockstranslator.h>
+
+#include "ticktimebase.h"
+
+/**
+ * Automatic time slice for BioBlocksTranslator: the coarsest slice that still lands on every operation
+ * boundary, that is the greatest common divisor of all timeOfOperation, duration and thermocycling step
+ * durations of the protocol (computed in whole ticks).
+ *
+ * Measurement frequencies are passed as-is to the backend and sampled there, so their periods only
+ * take part in the divisor when alignMeasurements is set. Protocols whose durations are all reported by
+ * the backend at run time (pipette) get the fallback slice.
+ */
+class TimeSliceSelector
+{
+public:
+    typedef struct TimeSliceReport_ {
+        double sliceMs;
+        double referenceSliceMs;
+        double protocolDurationMs;
+        bool durationBounded;
+        unsigned long long ticks;
+        unsigned long long referenceTicks;
+        double tickReduction;
+    } TimeSliceReport;
+
+    TimeSliceSelector(units::Time fallbackSlice = 1*units::s, bool alignMeasurements = false);
+    virtual ~TimeSliceSelector();
+
+    units::Time selectTimeSlice(const std::string & path) throw(std::invalid_argument);
+    units::Time selectTimeSlice(const nlohmann::json & protocol) throw(std::invalid_argument);
+
+    TimeSliceReport report(const std::string & path, units::Time referenceSlice) throw(std::invalid_argument);
+
+    std::shared_ptr<ProtocolGraph> translateFile(const std::string & path) throw(std::invalid_argument);
+
+protected:
+    units::Time fallbackSlice;
+    bool alignMeasurements;
+
+    void collectTimes(const nlohmann::json & value, std::uint64_t & divisor) const throw(std::invalid_argument);
+    static void addTime(TickTimebase::Ticks time, std::uint64_t & divisor);
+};
+
+#endif // TIMESLICESELECTOR_H
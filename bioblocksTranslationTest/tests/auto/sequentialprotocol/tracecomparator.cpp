@@ -0,0 +1,109 @@
+#include "tracecomparator.h"
+
+#include <sstream>
+
+#include "tracetimeline.h"
+
+TraceComparator::TraceComparator(std::istream & golden) :
+    golden(golden)
+{
+    comparedCommands = 0;
+    slices = 0;
+    diverged = false;
+}
+
+TraceComparator::~TraceComparator()
+{
+
+}
+
+bool TraceComparator::finish() throw(std::invalid_argument) {
+    if (diverged) {
+        return false;
+    }
+
+    if (actual.find_first_not_of(" \t\r\n") != std::string::npos) {
+        diverge("", actual);
+        return false;
+    }
+
+    std::string expected;
+    if (golden.next(expected)) {
+        diverge(expected, "");
+        return false;
+    }
+    return true;
+}
+
+std::string TraceComparator::report() const {
+    if (!diverged) {
+        return "execution equal to the golden trace, " + std::to_string(comparedCommands) + " commands compared";
+    }
+
+    std::ostringstream report;
+    report << "execution diverges at command " << divergence.command << ", slice " << divergence.slice;
+    if (!divergence.containers.empty()) {
+        report << ", container";
+        for(const std::string & container: divergence.containers) {
+            report << " " << container;
+        }
+    }
+    report << ": expected " << (divergence.expected.empty() ? "end of trace" : divergence.expected)
+           << ", executed " << (divergence.actual.empty() ? "end of trace" : divergence.actual);
+    return report.str();
+}
+
+TraceComparator::int_type TraceComparator::overflow(int_type c) {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        put(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize TraceComparator::xsputn(const char* s, std::streamsize n) {
+    for(std::streamsize i = 0; i < n; i++) {
+        put(s[i]);
+    }
+    return n;
+}
+
+void TraceComparator::put(char c) {
+    if (diverged) {
+        return;
+    }
+
+    if (c == ';') {
+        compareCommand();
+        actual.clear();
+    } else if (!actual.empty() || (c != '\n' && c != '\r' && c != ' ')) {
+        actual.push_back(c);
+    }
+}
+
+void TraceComparator::compareCommand() {
+    std::string expected;
+    if (!golden.next(expected)) {
+        diverge("", actual);
+    } else if (expected != actual) {
+        diverge(expected, actual);
+    } else {
+        comparedCommands++;
+        if (actual == "timeStep()") {
+            slices++;
+        }
+    }
+}
+
+void TraceComparator::diverge(const std::string & expected, const std::string & actual) {
+    diverged = true;
+    divergence.command = comparedCommands;
+    divergence.slice = slices;
+    divergence.expected = expected;
+    divergence.actual = actual;
+
+    std::string name;
+    std::vector<std::string> args;
+    if (TraceTimeline::parseCommand(actual.empty() ? expected : actual, name, args)) {
+        divergence.containers.assign(args.begin(), args.begin() + std::min(args.size(), TraceTimeline::containerArgs(name)));
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef TRACECOMPARATOR_H
+#define TRACECOMPARATOR_H
+
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "goldentrace.h"
+
+/**
+ * Output buffer that compares an execution against a golden trace while it is being written.
+ *
+ * Give it to StringActuatorsInterface through an std::ostream: every command is checked as soon as its
+ * ';' arrives and nothing is kept in memory, so the length of the execution does not matter. The first
+ * difference is recorded (command number, slice, containers involved) and the rest of the output is
+ * ignored; hasDiverged() lets the caller stop the execution right there.
+ */
+class TraceComparator : public std::streambuf
+{
+public:
+    typedef struct TraceDivergence_ {
+        unsigned long long command;
+        unsigned long long slice;
+        std::string expected;
+        std::string actual;
+        std::vector<std::string> containers;
+    } TraceDivergence;
+
+    TraceComparator(std::istream & golden);
+    virtual ~TraceComparator();
+
+    bool finish() throw(std::invalid_argument);
+    std::string report() const;
+
+    inline bool hasDiverged() const {
+        return diverged;
+    }
+
+    inline const TraceDivergence & getDivergence() const {
+        return divergence;
+    }
+
+    inline unsigned long long getComparedCommands() const {
+        return comparedCommands;
+    }
+
+protected:
+    GoldenTraceReader golden;
+    std::string actual;
+
+    unsigned long long comparedCommands;
+    unsigned long long slices;
+
+    bool diverged;
+    TraceDivergence divergence;
+
+    virtual int_type overflow(int_type c);
+    virtual std::streamsize xsputn(const char* s, std::streamsize n);
+
+    void put(char c);
+    void compareCommand();
+    void diverge(const std::string & expected, const std::string & actual);
+};
+
+#endif // TRACECOMPARATOR_H
@@ -0,0 +1,378 @@
+#include "tracetimeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include <cereal/archives/portable_binary.hpp>
+
+#include "protocoljson.h"
+
+TraceTimeline::TraceTimeline()
+{
+    sliceMs = 0;
+    totalSlices = 0;
+    root = -1;
+}
+
+TraceTimeline::~TraceTimeline()
+{
+
+}
+
+void TraceTimeline::build(std::istream & trace, double defaultSliceMs) throw(std::invalid_argument) {
+    sliceMs = defaultSliceMs;
+    totalSlices = 0;
+    commands.clear();
+    intervals.clear();
+    containerCommands.clear();
+    occupancies.clear();
+    intervalTree.clear();
+    root = -1;
+
+    std::map<std::string, int> openIntervals;
+    std::string text;
+    char c;
+    while(trace.get(c)) {
+        if (c != ';' && c != '\n' && c != '\r') {
+            text.push_back(c);
+            continue;
+        }
+
+        size_t first = text.find_first_not_of(" \t");
+        if (first != std::string::npos) {
+            addCommand(text.substr(first, text.find_last_not_of(" \t") - first + 1), openIntervals);
+        }
+        text.clear();
+    }
+    if (text.find_first_not_of(" \t") != std::string::npos) {
+        throw(std::invalid_argument("truncated trace, last command: " + text));
+    }
+
+    if (sliceMs <= 0) {
+        throw(std::invalid_argument("trace without setTimeStep and no default time slice"));
+    }
+
+    // activities never stopped last until the end of the trace
+    for(const auto & open: openIntervals) {
+        intervals[open.second].endSlice = totalSlices;
+    }
+
+    computeOccupancies();
+
+    std::vector<int> treeIntervals;
+    for(size_t i = 0; i < intervals.size(); i++) {
+        if (intervals[i].endSlice > intervals[i].startSlice) {
+            treeIntervals.push_back(i);
+        }
+    }
+    root = buildTree(treeIntervals);
+}
+
+void TraceTimeline::buildFile(const std::string & path, double defaultSliceMs) throw(std::invalid_argument) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw(std::invalid_argument("imposible to open " + path));
+    }
+    build(in, defaultSliceMs);
+}
+
+void TraceTimeline::saveIndex(const std::string & path) const throw(std::runtime_error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw(std::runtime_error("imposible to open " + path));
+    }
+    cereal::PortableBinaryOutputArchive archive(out);
+    archive(*this);
+}
+
+TraceTimeline TraceTimeline::loadIndex(const std::string & path) throw(std::invalid_argument) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw(std::invalid_argument("imposible to open " + path));
+    }
+
+    TraceTimeline timeline;
+    try {
+        cereal::PortableBinaryInputArchive archive(in);
+        archive(timeline);
+    } catch (cereal::Exception & e) {
+        throw(std::invalid_argument("corrupted trace index " + path + ": " + e.what()));
+    }
+    return timeline;
+}
+
+std::vector<int> TraceTimeline::activeAt(double timeMs) const {
+    std::vector<int> active;
+    unsigned long long slice = toSlice(timeMs);
+
+    int node = root;
+    while(node != -1) {
+        const IntervalNode & actual = intervalTree[node];
+        if (slice < actual.center) {
+            for(int interval: actual.byStart) {
+                if (intervals[interval].startSlice > slice) {
+                    break;
+                }
+                active.push_back(interval);
+            }
+            node = actual.left;
+        } else {
+            for(int interval: actual.byEnd) {
+                if (intervals[interval].endSlice <= slice) {
+                    break;
+                }
+                active.push_back(interval);
+            }
+            node = actual.right;
+        }
+    }
+
+    std::sort(active.begin(), active.end());
+    return active;
+}
+
+std::vector<int> TraceTimeline::commandsFor(const std::string & container, double fromMs, double toMs) const {
+    std::vector<int> found;
+
+    auto it = containerCommands.find(container);
+    if (it == containerCommands.end() || toMs < fromMs) {
+        return found;
+    }
+
+    unsigned long long fromSlice = (unsigned long long) std::ceil(std::max(0.0, fromMs) / sliceMs - 1e-9);
+    unsigned long long toSlice = this->toSlice(toMs);
+
+    const std::vector<int> & indexes = it->second;
+    auto first = std::lower_bound(indexes.begin(), indexes.end(), fromSlice, [this](int command, unsigned long long slice) {
+        return commands[command].slice < slice;
+    });
+    auto last = std::upper_bound(first, indexes.end(), toSlice, [this](unsigned long long slice, int command) {
+        return slice < commands[command].slice;
+    });
+    found.assign(first, last);
+    return found;
+}
+
+TraceTimeline::ContainerOccupancy TraceTimeline::occupancy(const std::string & container) const throw(std::invalid_argument) {
+    auto it = occupancies.find(container);
+    if (it == occupancies.end()) {
+        throw(std::invalid_argument("container " + container + " does not appear in the trace"));
+    }
+    return it->second;
+}
+
+std::vector<std::string> TraceTimeline::getContainers() const {
+    std::vector<std::string> containers;
+    for(const auto & container: containerCommands) {
+        containers.push_back(container.first);
+    }
+    return containers;
+}
+
+void TraceTimeline::writeLog(std::ostream & out, const std::string & units) const throw(std::invalid_argument) {
+    double unitMs = ProtocolJson::unitToMs(units);
+    for(const TraceCommand & command: commands) {
+        out << command.slice * sliceMs / unitMs << units << ":" << command.text << std::endl;
+    }
+    out << totalSlices * sliceMs / unitMs << units << ":END" << std::endl;
+}
+
+void TraceTimeline::addCommand(const std::string & text, std::map<std::string, int> & openIntervals) throw(std::invalid_argument) {
+    if (text == "timeStep()") {
+        totalSlices++;
+        return;
+    }
+
+    std::string name;
+    std::vector<std::string> args;
+    if (!parseCommand(text, name, args)) {
+        throw(std::invalid_argument("imposible to parse trace command " + text));
+    }
+
+    if (name == "setTimeStep" && args.size() == 1) {
+        sliceMs = std::stod(args[0]) * ProtocolJson::unitToMs(args[0].substr(args[0].find_first_not_of("0123456789.e+-")));
+    }
+
+    int index = commands.size();
+    TraceCommand command;
+    command.slice = totalSlices;
+    command.text = text;
+    command.containers.assign(args.begin(), args.begin() + std::min(args.size(), containerArgs(name)));
+    commands.push_back(command);
+
+    std::string key;
+    for(const std::string & container: command.containers) {
+        containerCommands[container].push_back(index);
+        key += "," + container;
+    }
+
+    bool start = false;
+    std::string kind = activity(name, start);
+    if (kind.empty()) {
+        return;
+    }
+    key = kind + key;
+
+    auto open = openIntervals.find(key);
+    if (open != openIntervals.end()) {
+        intervals[open->second].endSlice = totalSlices;
+        intervals[open->second].stopped = !start;
+        openIntervals.erase(open);
+    }
+
+    if (start) {
+        ActiveInterval interval;
+        interval.command = index;
+        interval.startSlice = totalSlices;
+        interval.endSlice = totalSlices;
+        interval.stopped = false;
+
+        openIntervals.insert(std::make_pair(key, (int) intervals.size()));
+        intervals.push_back(interval);
+    }
+}
+
+void TraceTimeline::computeOccupancies() {
+    std::map<std::string, std::vector<std::pair<unsigned long long, unsigned long long>>> busy;
+    for(const ActiveInterval & interval: intervals) {
+        for(const std::string & container: commands[interval.command].containers) {
+            busy[container].push_back(std::make_pair(interval.startSlice, interval.endSlice));
+        }
+    }
+
+    for(const auto & container: containerCommands) {
+        ContainerOccupancy occupancy;
+        occupancy.commands = container.second.size();
+        occupancy.firstSlice = commands[container.second.front()].slice;
+        occupancy.lastSlice = commands[container.second.back()].slice;
+        occupancy.busySlices = 0;
+
+        std::vector<std::pair<unsigned long long, unsigned long long>> & spans = busy[container.first];
+        std::sort(spans.begin(), spans.end());
+
+        unsigned long long coveredUntil = 0;
+        for(const auto & span: spans) {
+            unsigned long long start = std::max(span.first, coveredUntil);
+            if (span.second > start) {
+                occupancy.busySlices += span.second - start;
+                coveredUntil = span.second;
+            }
+        }
+        occupancies.insert(std::make_pair(container.first, occupancy));
+    }
+}
+
+int TraceTimeline::buildTree(std::vector<int> & nodeIntervals) {
+    if (nodeIntervals.empty()) {
+        return -1;
+    }
+
+    // the midpoint of the median interval lies inside it, so every node keeps at least one interval
+    std::sort(nodeIntervals.begin(), nodeIntervals.end(), [this](int a, int b) {
+        return intervals[a].startSlice + intervals[a].endSlice < intervals[b].startSlice + intervals[b].endSlice;
+    });
+    const ActiveInterval & median = intervals[nodeIntervals[nodeIntervals.size() / 2]];
+
+    IntervalNode node;
+    node.center = (median.startSlice + median.endSlice) / 2;
+
+    std::vector<int> leftIntervals;
+    std::vector<int> rightIntervals;
+    for(int interval: nodeIntervals) {
+        if (intervals[interval].endSlice <= node.center) {
+            leftIntervals.push_back(interval);
+        } else if (intervals[interval].startSlice > node.center) {
+            rightIntervals.push_back(interval);
+        } else {
+            node.byStart.push_back(interval);
+        }
+    }
+
+    node.byEnd = node.byStart;
+    std::sort(node.byStart.begin(), node.byStart.end(), [this](int a, int b) {
+        return intervals[a].startSlice < intervals[b].startSlice;
+    });
+    std::sort(node.byEnd.begin(), node.byEnd.end(), [this](int a, int b) {
+        return intervals[a].endSlice > intervals[b].endSlice;
+    });
+
+    int index = intervalTree.size();
+    intervalTree.push_back(node);
+
+    int left = buildTree(leftIntervals);
+    int right = buildTree(rightIntervals);
+    intervalTree[index].left = left;
+    intervalTree[index].right = right;
+    return index;
+}
+
+unsigned long long TraceTimeline::toSlice(double timeMs) const {
+    if (timeMs <= 0) {
+        return 0;
+    }
+    return (unsigned long long) std::floor(timeMs / sliceMs + 1e-9);
+}
+
+bool TraceTimeline::parseCommand(const std::string & text, std::string & name, std::vector<std::string> & args) {
+    size_t open = text.find('(');
+    if (open == std::string::npos || text.back() != ')') {
+        return false;
+    }
+
+    name = text.substr(0, open);
+    std::string inner = text.substr(open + 1, text.size() - open - 2);
+
+    size_t begin = 0;
+    while(!inner.empty() && begin <= inner.size()) {
+        size_t end = inner.find(',', begin);
+        if (end == std::string::npos) {
+            end = inner.size();
+        }
+
+        std::string arg = inner.substr(begin, end - begin);
+        size_t first = arg.find_first_not_of(' ');
+        args.push_back(first == std::string::npos ? "" : arg.substr(first, arg.find_last_not_of(' ') - first + 1));
+        begin = end + 1;
+    }
+    return true;
+}
+
+size_t TraceTimeline::containerArgs(const std::string & name) {
+    if (name == "setTimeStep") {
+        return 0;
+    } else if (name == "mix" || name == "stopMix") {
+        return 3;
+    } else if (name == "setContinuosFlow" || name == "stopContinuosFlow" ||
+               name == "transfer" || name == "stopTransfer")
+    {
+        return 2;
+    }
+    return 1;
+}
+
+std::string TraceTimeline::activity(const std::string & name, bool & start) {
+    static const std::map<std::string, std::pair<std::string, bool>> activities = {
+        {"applyLight", {"light", true}}, {"stopApplyLight", {"light", false}},
+        {"applyTemperature", {"temperature", true}}, {"stopApplyTemperature", {"temperature", false}},
+        {"stir", {"stir", true}}, {"stopStir", {"stir", false}},
+        {"centrifugate", {"centrifugate", true}}, {"stopCentrifugate", {"centrifugate", false}},
+        {"shake", {"shake", true}}, {"stopShake", {"shake", false}},
+        {"startElectrophoresis", {"electrophoresis", true}}, {"stopElectrophoresis", {"electrophoresis", false}},
+        {"setContinuosFlow", {"flow", true}}, {"stopContinuosFlow", {"flow", false}},
+        {"transfer", {"transfer", true}}, {"stopTransfer", {"transfer", false}},
+        {"mix", {"mix", true}}, {"stopMix", {"mix", false}},
+        {"measureOD", {"od", true}}, {"getMeasureOD", {"od", false}},
+        {"measureTemperature", {"temperatureSensor", true}}, {"getMeasureTemperature", {"temperatureSensor", false}},
+        {"measureLuminiscense", {"luminiscense", true}}, {"getMeasureLuminiscense", {"luminiscense", false}},
+        {"measureVolume", {"volume", true}}, {"getMeasureVolume", {"volume", false}},
+        {"measureFluorescence", {"fluorescence", true}}, {"getMeasureFluorescence", {"fluorescence", false}}
+    };
+
+    auto it = activities.find(name);
+    if (it == activities.end()) {
+        return "";
+    }
+    start = it->second.second;
+    return it->second.first;
+}
@@ -0,0 +1,144 @@
+#ifndef TRACETIMELINE_H
+#define TRACETIMELINE_H
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+/**
+ * Time index over an execution trace, as written by StringActuatorsInterface (commands separated by ';'
+ * or by new lines).
+ *
+ * The trace is read once: every command gets the slice it was issued in, start/stop pairs (stir/stopStir,
+ * setContinuosFlow/stopContinuosFlow, measureOD/getMeasureOD...) become activity intervals kept in an
+ * interval tree, and the commands of every container are kept in slice order. After that:
+ *  - activeAt(T) is O(log n + k),
+ *  - commandsFor(X, t0, t1) is O(log n + k),
+ *  - occupancy(X) is O(log containers).
+ * The index can be saved to a binary file and loaded again without reading the trace.
+ */
+class TraceTimeline
+{
+public:
+    typedef struct TraceCommand_ {
+        unsigned long long slice;
+        std::string text;
+        std::vector<std::string> containers;
+
+        template<class Archive>
+        void serialize(Archive & ar) {
+            ar(slice, text, containers);
+        }
+    } TraceCommand;
+
+    typedef struct ActiveInterval_ {
+        int command;
+        unsigned long long startSlice;
+        unsigned long long endSlice;
+        bool stopped;
+
+        template<class Archive>
+        void serialize(Archive & ar) {
+            ar(command, startSlice, endSlice, stopped);
+        }
+    } ActiveInterval;
+
+    typedef struct ContainerOccupancy_ {
+        unsigned long long commands;
+        unsigned long long busySlices;
+        unsigned long long firstSlice;
+        unsigned long long lastSlice;
+
+        template<class Archive>
+        void serialize(Archive & ar) {
+            ar(commands, busySlices, firstSlice, lastSlice);
+        }
+    } ContainerOccupancy;
+
+    TraceTimeline();
+    virtual ~TraceTimeline();
+
+    void build(std::istream & trace, double defaultSliceMs = 0) throw(std::invalid_argument);
+    void buildFile(const std::string & path, double defaultSliceMs = 0) throw(std::invalid_argument);
+
+    void saveIndex(const std::string & path) const throw(std::runtime_error);
+    static TraceTimeline loadIndex(const std::string & path) throw(std::invalid_argument);
+
+    std::vector<int> activeAt(double timeMs) const;
+    std::vector<int> commandsFor(const std::string & container, double fromMs, double toMs) const;
+    ContainerOccupancy occupancy(const std::string & container) const throw(std::invalid_argument);
+    std::vector<std::string> getContainers() const;
+
+    void writeLog(std::ostream & out, const std::string & units = "ms") const throw(std::invalid_argument);
+
+    inline const TraceCommand & getCommand(int command) const {
+        return commands[command];
+    }
+
+    inline const ActiveInterval & getInterval(int interval) const {
+        return intervals[interval];
+    }
+
+    inline double getSliceMs() const {
+        return sliceMs;
+    }
+
+    inline unsigned long long getTotalSlices() const {
+        return totalSlices;
+    }
+
+    inline size_t getCommandsCount() const {
+        return commands.size();
+    }
+
+    static bool parseCommand(const std::string & text, std::string & name, std::vector<std::string> & args);
+    static size_t containerArgs(const std::string & name);
+
+    template<class Archive>
+    void serialize(Archive & ar) {
+        ar(sliceMs, totalSlices, commands, intervals, containerCommands, occupancies, intervalTree, root);
+    }
+
+protected:
+    typedef struct IntervalNode_ {
+        unsigned long long center;
+        std::vector<int> byStart;
+        std::vector<int> byEnd;
+        int left;
+        int right;
+
+        template<class Archive>
+        void serialize(Archive & ar) {
+            ar(center, byStart, byEnd, left, right);
+        }
+    } IntervalNode;
+
+    double sliceMs;
+    unsigned long long totalSlices;
+
+    std::vector<TraceCommand> commands;
+    std::vector<ActiveInterval> intervals;
+    std::map<std::string, std::vector<int>> containerCommands;
+    std::map<std::string, ContainerOccupancy> occupancies;
+
+    std::vector<IntervalNode> intervalTree;
+    int root;
+
+    void addCommand(const std::string & text, std::map<std::string, int> & openIntervals) throw(std::invalid_argument);
+    void computeOccupancies();
+    int buildTree(std::vector<int> & nodeIntervals);
+
+    unsigned long long toSlice(double timeMs) const;
+
+    static std::string activity(const std::string & name, bool & start);
+};
+
+#endif // TRACETIMELINE_H
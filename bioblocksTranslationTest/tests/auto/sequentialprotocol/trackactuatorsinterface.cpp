@@ -0,0 +1,28 @@
+#include "trackactuatorsinterface.h"
+
+TrackActuatorsInterface::TrackActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface, std::set<std::string>* loadedContainers) :
+    ForwardingActuatorsInterface(actuatorInterface), loadedContainers(loadedContainers)
+{
+    timeSlice = 0;
+    waitingSlice = false;
+}
+
+TrackActuatorsInterface::~TrackActuatorsInterface()
+{
+
+}
+
+void TrackActuatorsInterface::loadContainer(const std::string & sourceId, units::Volume initialVolume) {
+    if (loadedContainers->insert(sourceId).second) {
+        actuatorInterface->loadContainer(sourceId, initialVolume);
+    }
+}
+
+void TrackActuatorsInterface::setTimeStep(units::Time time) {
+    timeSlice = TickTimebase::fromTime(time);
+}
+
+units::Time TrackActuatorsInterface::timeStep() {
+    waitingSlice = true;
+    return TickTimebase::toTime(timeSlice);
+}
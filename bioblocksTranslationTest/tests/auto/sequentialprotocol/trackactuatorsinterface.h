@@ -0,0 +1,43 @@
+#ifndef TRACKACTUATORSINTERFACE_H
+#define TRACKACTUATORSINTERFACE_H
+
+#include <set>
+#include <string>
+
+#include "forwardingactuatorsinterface.h"
+#include "ticktimebase.h"
+
+/**
+ * View of the instrument given to every group of tracks run by a MultiRateExecutor.
+ *
+ * Commands are forwarded as they come, except loadContainer, which is sent once per container for all the
+ * groups, and the time steps: setTimeStep only records the slice of the group and timeStep() flags the
+ * group as waiting for its next boundary, the MultiRateExecutor owns the backend timeline.
+ */
+class TrackActuatorsInterface : public ForwardingActuatorsInterface
+{
+public:
+    TrackActuatorsInterface(ActuatorsExecutionInterface* actuatorInterface, std::set<std::string>* loadedContainers);
+    virtual ~TrackActuatorsInterface();
+
+    virtual void loadContainer(const std::string & sourceId, units::Volume initialVolume);
+
+    virtual void setTimeStep(units::Time time);
+    virtual units::Time timeStep();
+
+    inline bool isWaitingSlice() const {
+        return waitingSlice;
+    }
+
+    inline void sliceDone() {
+        waitingSlice = false;
+    }
+
+protected:
+    std::set<std::string>* loadedContainers;
+
+    TickTimebase::Ticks timeSlice;
+    bool waitingSlice;
+};
+
+#endif // TRACKACTUATORSINTERFACE_H
@@ -1,15 +1,45 @@
 #include <QtTest>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QFile>
 
 #include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
 #include <vector>
 
 #include <bioblocksTranslation/bioblockstranslator.h>
 
 // add necessary includes here
 
+#include "asyncactuatorsinterface.h"
+#include "branchspaceexplorer.h"
+#include "commandoptimizingactuatorsinterface.h"
+#include "goldentrace.h"
+#include "lazyprotocolexecutor.h"
+#include "multirateexecutor.h"
+#include "parameterizedprotocol.h"
+#include "parametersweep.h"
+#include "partitionedexecutor.h"
+#include "protocolanalyzer.h"
+#include "protocolcorpusrunner.h"
+#include "protocolcoscheduler.h"
+#include "protocolexecutor.h"
+#include "protocoljson.h"
+#include "realtimeexecutor.h"
+#include "repeatcompactor.h"
+#include "replayactuatorsinterface.h"
+#include "sensorlog.h"
+#include "simulatedactuatorsinterface.h"
+#include "steadystateexecutor.h"
 #include "stringactuatorsinterface.h"
+#include "ticktimebase.h"
+#include "timesliceselector.h"
+#include "tracecomparator.h"
+#include "tracetimeline.h"
 
 class SequentialProtocol : public QObject
 {
@@ -22,30 +52,40 @@ public:
 private:
     void executeProtocol(std::shared_ptr<ProtocolGraph> protocol,ActuatorsExecutionInterface* actuatorInterfaz);
     void copyResourceFile(const QString & resourcePath, QTemporaryFile* file) throw(std::invalid_argument);
+    bool executeAgainstGolden(std::shared_ptr<ProtocolGraph> protocol,
+                              const std::vector<double> & measureValues,
+                              const QString & goldenResource,
+                              std::string & report) throw(std::invalid_argument);
 
 private slots:
-    void oneOperationTest();
-    void twoOperationsLinkedTest();
-    void twoOperationsParalelTest();
-    void twoOperationsUnknowDurationLinkedTest();
-    void twoOperationsUnknowDurationParalelTest();
-    void simpleIfYesTest();
-    void simpleIfNoTest();
-    void complexIfYesTest();
-    void complexIfNoTest();
-    void elifB2Test();
-    void elifB1Test();
-    void elifNoBTest();
-    void ifElseElseTest();
-    void ifElseIfTest();
-    void nestedIfsTestNoBTest();
-    void nestedIfsTestB1Test();
-    void nestedIfsTestB1N1Test();
-    void loopTest();
-    void thermocycling();
-    void turbidostat2();
-    void mixHeat();
-    void evoproSwitching();
+    void checkpointResumeTest();
+    void simulatedVolumesTest();
+    void simulatedTurbidostatTest();
+    void protocolAnalysisTest();
+    void automaticTimeSliceTest();
+    void coScheduledProtocolsTest();
+    void compactThermocyclingTest();
+    void conditionCacheTest();
+    void realTimeExecutionTest();
+    void asyncCommandQueueTest();
+    void traceTimelineTest();
+    void goldenTraceDivergenceTest();
+    void protocolCorpusTest();
+    void lazyBranchTranslationTest();
+    void lazyBranchCostTest();
+    void branchSpaceExplorationTest();
+    void steadyStateCompressionTest();
+    void steadyStateReadsTest();
+    void redundantCommandEliminationTest();
+    void tickTimebaseTest();
+    void parameterSweepTest();
+    void parameterBinderTest();
+    void multiRateExecutionTest();
+    void sensorLogReplayTest();
+    void speculativePipeliningTest();
+    void speculativeParallelTest();
+    void partitionedExecutionTest();
+    void priorityLanesTest();
 
 };
 
@@ -60,29 +100,41 @@ SequentialProtocol::~SequentialProtocol()
 }
 
 /*
- * setContinuosFlow[0s:30s](A,B,10ml/hr);
+ * continuousFlow[0s:10s](A,B,10ml/h);
+ * continuosFlow[-:10s](B,C,20ml/ms);
+ *
+ * checkpointed every slice and stopped after 5 slices, resumed from the checkpoint base and its journal as a
+ * new process would: a graph translated again, brought to the checkpoint replaying its read log, and a fresh
+ * interface, where A and B are loaded with what 5s of flow left in them
  */
-void SequentialProtocol::oneOperationTest()
-{
+void SequentialProtocol::checkpointResumeTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
-    if (tempFile->open()) {
+    QTemporaryDir checkpointDir;
+    if (tempFile->open() && checkpointDir.isValid()) {
         try {
-            copyResourceFile(":/protocol/protocolos/sequential.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/twoOperationsLinked.json", tempFile);
 
-            BioBlocksTranslator translator(10*units::s, tempFile->fileName().toStdString());
+            BioBlocksTranslator translator(1*units::s, tempFile->fileName().toStdString());
             std::shared_ptr<ProtocolGraph> protocol =
                     translator.translateFile();
 
-            qDebug() << protocol->toString().c_str();
+            std::string checkpointPath = checkpointDir.filePath("execution.chk").toStdString();
+
+            StringActuatorsInterface* crashedInterface = new StringActuatorsInterface(std::vector<double>{});
+            ProtocolExecutor crashedExecutor(protocol, crashedInterface);
+            crashedExecutor.enableCheckpoints(checkpointPath, 1);
+            while(crashedExecutor.getElapsedSlices() < 5 && crashedExecutor.executeNextNode());
 
             StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
-            executeProtocol(protocol, interface);
+            ProtocolExecutor executor(translator.translateFile(), interface);
+            executor.resume(checkpointPath);
+            executor.execute();
 
             std::string execution = interface->getStream().str();
             qDebug() << "protocol execution";
             qDebug() << execution.c_str();
 
-            std::string expected = "setTimeStep(10000ms);loadContainer(A,1ml);loadContainer(B,0ml);setContinuosFlow(A,B,10ml/h);timeStep();timeStep();timeStep();stopContinuosFlow(A,B);timeStep();timeStep();";
+            std::string expected = "setTimeStep(1000ms);loadContainer(A,0.986111ml);loadContainer(B,0.0138889ml);loadContainer(C,0ml);setContinuosFlow(A,B,10ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(A,B);setContinuosFlow(B,C,7.2e+07ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(B,C);timeStep();timeStep();";
             qDebug() << "protocol expected execution";
             qDebug() << expected.c_str();
 
@@ -99,33 +151,29 @@ void SequentialProtocol::oneOperationTest()
 }
 
 /*
- * continuousFlow[0s:10s](A,B,10ml/h);
- * continuosFlow[-:10s](B,C,20ml/ms);
+ * setContinuosFlow[0s:30s](A,B,10ml/hr);
+ *
+ * executed against the simulated backend, 30s at 10ml/h moves 1/12 ml from A to B
  */
-void SequentialProtocol::twoOperationsLinkedTest() {
+void SequentialProtocol::simulatedVolumesTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/twoOperationsLinked.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/sequential.json", tempFile);
 
-            BioBlocksTranslator translator(1*units::s, tempFile->fileName().toStdString());
+            BioBlocksTranslator translator(10*units::s, tempFile->fileName().toStdString());
             std::shared_ptr<ProtocolGraph> protocol =
                     translator.translateFile();
 
-            qDebug() << protocol->toString().c_str();
-
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
+            SimulatedActuatorsInterface* interface = new SimulatedActuatorsInterface();
             executeProtocol(protocol, interface);
 
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+            double volumeA = interface->getVirtualVolume("A").to(units::ml);
+            double volumeB = interface->getVirtualVolume("B").to(units::ml);
+            qDebug() << "simulated volumes A:" << volumeA << "ml, B:" << volumeB << "ml";
 
-            std::string expected = "setTimeStep(1000ms);loadContainer(A,1ml);loadContainer(B,0ml);loadContainer(C,0ml);setContinuosFlow(A,B,10ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(A,B);setContinuosFlow(B,C,7.2e+07ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(B,C);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
-
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            QVERIFY2(qAbs(volumeA - (1.0 - 1.0/12.0)) < 1e-9, "wrong simulated volume for A");
+            QVERIFY2(qAbs(volumeB - 1.0/12.0) < 1e-9, "wrong simulated volume for B");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -138,33 +186,42 @@ void SequentialProtocol::twoOperationsLinkedTest() {
 }
 
 /*
- * continuosFlow[0s:10s](A,B,10ml/hr);
- * continuousFlow[5s:5s](C,D,20ml/hr);
+ * turbidostat2.json executed against the simulated backend with the culture at OD 1.5: every measurement raises
+ * the pump rate until the dilution brings the OD into [1, 1.1] and the loop ends, without losing any volume
+ * between media, cell and Waste; a pump chain out of a nearly empty container only delivers what it had
  */
-void SequentialProtocol::twoOperationsParalelTest() {
+void SequentialProtocol::simulatedTurbidostatTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/twoOperationsParalel.json", tempFile);
-
-            BioBlocksTranslator translator(1*units::s, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
-
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
-            executeProtocol(protocol, interface);
-
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
-
-            std::string expected = "setTimeStep(1000ms);loadContainer(A,0ml);loadContainer(B,0ml);loadContainer(C,0ml);loadContainer(D,0ml);setContinuosFlow(A,B,10ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();setContinuosFlow(C,D,20ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(A,B);stopContinuosFlow(C,D);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            copyResourceFile(":/protocol/protocolos/turbidostat2.json", tempFile);
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            BioBlocksTranslator translator(1000*units::ms, tempFile->fileName().toStdString());
+            SimulatedActuatorsInterface* interface = new SimulatedActuatorsInterface();
+            interface->setInitialOD("cell", 1.5);
+            executeProtocol(translator.translateFile(), interface);
+
+            double od = interface->getMeasureOD("cell");
+            double total = interface->getVirtualVolume("media").to(units::ml) +
+                    interface->getVirtualVolume("cell").to(units::ml) +
+                    interface->getVirtualVolume("Waste").to(units::ml);
+            qDebug() << "simulated turbidostat OD:" << od << ", total volume:" << total << "ml";
+
+            QVERIFY2(od > 0.8 && od < 1.1, "the OD was not brought down by the pumps");
+            QVERIFY2(qAbs(total - 150.0) < 1e-9, "volume not conserved");
+            QVERIFY2(qAbs(interface->getVirtualVolume("cell").to(units::ml) - 50.0) < 1e-9, "wrong cell volume");
+
+            SimulatedActuatorsInterface chain;
+            chain.setTimeStep(1000*units::ms);
+            chain.loadContainer("A", 0.01*units::ml);
+            chain.setContinuosFlow("A", "B", 10*units::ml/units::hr);
+            chain.setContinuosFlow("B", "C", 10*units::ml/units::hr);
+            for(int i = 0; i < 30; i++) {
+                chain.timeStep();
+            }
+            QVERIFY2(chain.getVirtualVolume("A").to(units::ml) == 0, "source not emptied");
+            QVERIFY2(qAbs(chain.getVirtualVolume("B").to(units::ml) + chain.getVirtualVolume("C").to(units::ml) - 0.01) < 1e-12,
+                     "more volume delivered than the source had");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -177,33 +234,50 @@ void SequentialProtocol::twoOperationsParalelTest() {
 }
 
 /*
- * transfer[0s:](A,B,5ml);
- * transfer[-:](B,C,7ml);
+ * evoprog switching: 700 minutes of stir and heat, continuous flows switched every 10 minutes
+ * from minute 600, every switch stops and restarts the same pumps; the critical path has no slack.
+ *
+ * ifElseElse.json: the 2s flow of the if can start 1s later than the 3s mix of the else.
  */
-void SequentialProtocol::twoOperationsUnknowDurationLinkedTest() {
+void SequentialProtocol::protocolAnalysisTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/unknowDurationLinked.json", tempFile);
-
-            BioBlocksTranslator translator(1*units::s, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
-
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
-            executeProtocol(protocol, interface);
-
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+            copyResourceFile(":/protocol/protocolos/evoprog_switching_protocol.json", tempFile);
 
-            std::string expected = "setTimeStep(1000ms);loadContainer(A,0ml);loadContainer(B,0ml);loadContainer(C,0ml);transfer(A,B,5ml);timeStep();timeStep();timeStep();timeStep();timeStep();stopTransfer(A,B);transfer(B,C,7ml);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopTransfer(B,C);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            ProtocolAnalyzer analyzer;
+            ProtocolAnalyzer::ProtocolAnalysis analysis = analyzer.analyzeFile(tempFile->fileName().toStdString());
+
+            qDebug() << "duration:" << TickTimebase::toMs(analysis.minDuration) << "ms -" << TickTimebase::toMs(analysis.maxDuration) << "ms";
+            qDebug() << "flow conflicts:" << analysis.flowConflicts.size() << ", flow restarts:" << analysis.flowRestarts.size();
+
+            TickTimebase::Ticks expected = TickTimebase::parse("700", "minute");
+            QVERIFY2(analysis.minDuration == expected && analysis.maxDuration == expected, "wrong protocol duration");
+            QVERIFY2(!analysis.criticalPath.empty() &&
+                     analysis.operations[analysis.criticalPath.back()].maxEnd == expected,
+                     "critical path does not end with the protocol");
+            QVERIFY2(analysis.occupancy["cellstat"].size() > 1, "cellstat occupancy not found");
+            QVERIFY2(analysis.flowConflicts.empty(), "unexpected flow conflicts");
+            QVERIFY2(!analysis.flowRestarts.empty(), "pump restarts not detected");
+            for(int id: analysis.criticalPath) {
+                QVERIFY2(analysis.operations[id].slack == 0 &&
+                         analysis.operations[id].latestStart == analysis.operations[id].maxStart,
+                         "slack on the critical path");
+            }
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            QTemporaryFile ifFile;
+            QVERIFY2(ifFile.open(), "imposible to create temporary file");
+            copyResourceFile(":/protocol/protocolos/ifElseElse.json", &ifFile);
+            ProtocolAnalyzer::ProtocolAnalysis ifAnalysis = analyzer.analyzeFile(ifFile.fileName().toStdString());
+
+            TickTimebase::Ticks second = TickTimebase::parse("1", "s");
+            for(const ProtocolAnalyzer::AnalyzedOperation & operation: ifAnalysis.operations) {
+                if (operation.blockType == "continuous_flow") {
+                    QVERIFY2(operation.slack == second && operation.latestStart == second, "wrong slack of the shorter branch");
+                } else if (operation.blockType == "mix" || operation.blockType == "controls_if") {
+                    QVERIFY2(operation.slack == 0, "slack on the longer branch");
+                }
+            }
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -216,33 +290,25 @@ void SequentialProtocol::twoOperationsUnknowDurationLinkedTest() {
 }
 
 /*
- * transfer[0s:](A,B,5ml);
- * transfer[0s:](C,D,7ml);
+ * evoprog switching: every operation starts and lasts a multiple of 10 minutes,
+ * the hand-picked 4 minutes slice needs 2.5 times more ticks.
  */
-void SequentialProtocol::twoOperationsUnknowDurationParalelTest() {
+void SequentialProtocol::automaticTimeSliceTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/unknowDurationParalel.json", tempFile);
-
-            BioBlocksTranslator translator(1*units::s, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
-
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
-            executeProtocol(protocol, interface);
+            copyResourceFile(":/protocol/protocolos/evoprog_switching_protocol.json", tempFile);
 
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+            TimeSliceSelector selector;
+            units::Time slice = selector.selectTimeSlice(tempFile->fileName().toStdString());
+            TimeSliceSelector::TimeSliceReport report = selector.report(tempFile->fileName().toStdString(), 4*units::minute);
 
-            std::string expected = "setTimeStep(1000ms);loadContainer(A,0ml);loadContainer(B,0ml);loadContainer(C,0ml);loadContainer(D,0ml);transfer(A,B,5ml);transfer(C,D,7ml);timeStep();timeStep();timeStep();timeStep();timeStep();stopTransfer(A,B);timeStep();timeStep();stopTransfer(C,D);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            qDebug() << "automatic slice:" << slice.to(units::ms) << "ms";
+            qDebug() << "ticks:" << report.ticks << ", with 4 minutes:" << report.referenceTicks << ", reduction:" << report.tickReduction;
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            QVERIFY2(slice.to(units::minute) == 10, "wrong automatic time slice");
+            QVERIFY2(report.ticks == 70 && report.referenceTicks == 175, "wrong tick count");
+            QVERIFY2(report.tickReduction == 2.5, "wrong tick reduction");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -255,120 +321,170 @@ void SequentialProtocol::twoOperationsUnknowDurationParalelTest() {
 }
 
 /*
- * if[0s:](true) {
- *  continuosFlow[-:3s](A,B,10ml/hr);
- * }
- * continuosFlow[-:5s](B,C,7ml/hr);
+ * mix_test_v2 (A -> R1) and sequential (A -> R2, B -> R3) on the same instrument,
+ * both protocols advance with one shared timeStep per slice. A clash on a later mapping does not keep the
+ * earlier ones claimed, and the containers without a mapping are claimed, prefixed, when the protocol is added.
  */
-void SequentialProtocol::simpleIfYesTest() {
+void SequentialProtocol::coScheduledProtocolsTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
-    if (tempFile->open()) {
+    QTemporaryFile* tempFile2 = new QTemporaryFile();
+    if (tempFile->open() && tempFile2->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/simpleIfYes.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/mix_test_v2.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/sequential.json", tempFile2);
 
-            BioBlocksTranslator translator(1*units::s, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
+            BioBlocksTranslator translator(10*units::s, tempFile->fileName().toStdString());
+            std::shared_ptr<ProtocolGraph> mixProtocol = translator.translateFile();
 
-            qDebug() << protocol->toString().c_str();
+            BioBlocksTranslator translator2(10*units::s, tempFile2->fileName().toStdString());
+            std::shared_ptr<ProtocolGraph> flowProtocol = translator2.translateFile();
 
             StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
-            executeProtocol(protocol, interface);
+            ProtocolCoScheduler scheduler(interface);
+            scheduler.addProtocol("mix", mixProtocol, {{"A", "R1"}});
+            scheduler.addProtocol("flow", flowProtocol, {{"A", "R2"}, {"B", "R3"}});
+            scheduler.execute();
 
             std::string execution = interface->getStream().str();
             qDebug() << "protocol execution";
             qDebug() << execution.c_str();
 
-            std::string expected = "setTimeStep(1000ms);loadContainer(A,0ml);loadContainer(B,0ml);loadContainer(C,0ml);setContinuosFlow(A,B,10ml/h);timeStep();timeStep();timeStep();stopContinuosFlow(A,B);setContinuosFlow(B,C,7ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(B,C);timeStep();timeStep();";
+            std::string expected = "setTimeStep(10000ms);loadContainer(R1,0ml);stir(R1,20Hz);applyTemperature(R1,20Cº);loadContainer(R2,1ml);loadContainer(R3,0ml);setContinuosFlow(R2,R3,10ml/h);timeStep();timeStep();timeStep();stopStir(R1);stopApplyTemperature(R1);stopContinuosFlow(R2,R3);timeStep();timeStep();";
             qDebug() << "protocol expected execution";
             qDebug() << expected.c_str();
 
             QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            QVERIFY2(scheduler.getSharedSlices() == 5 && scheduler.getMergedTimeSteps() == 5, "wrong number of shared slices");
+
+            ProtocolCoScheduler clashing(interface);
+            clashing.addProtocol("mix", mixProtocol, {{"A", "R1"}});
+            QVERIFY_EXCEPTION_THROWN(clashing.addProtocol("flow", flowProtocol, {{"A", "R1"}}), std::invalid_argument);
+            QVERIFY_EXCEPTION_THROWN(clashing.addProtocol("flow", flowProtocol, {{"A", "R2"}, {"B", "R1"}}), std::invalid_argument);
+            clashing.addProtocol("other", flowProtocol, {{"A", "R2"}}, ProtocolJson::containerNames(ProtocolJson::read(tempFile2->fileName().toStdString())));
+            QVERIFY_EXCEPTION_THROWN(clashing.addProtocol("late", mixProtocol, {{"A", "other.B"}}), std::invalid_argument);
         } catch (std::exception & e) {
             delete tempFile;
+            delete tempFile2;
             QFAIL(e.what());
         }
     } else {
         delete tempFile;
+        delete tempFile2;
         QFAIL("imposible to create temporary file");
     }
     delete tempFile;
+    delete tempFile2;
 }
 
 /*
- * if[0s:](false) {
- *  continuosFlow[-:3s](A,B,10ml/hr);
- * }
- * continuosFlow[-:5s](B,C,7ml/hr);
+ * thermocycling.json translated as counter = 0; while(counter < cycles) {thermocycling(1); counter++}:
+ * the whole execution is the one of golden/thermocycling.rle, 3 cycles of 60Cº/30Cº with the same slices,
+ * and the compacted json does not grow with the number of cycles.
  */
-void SequentialProtocol::simpleIfNoTest() {
+void SequentialProtocol::compactThermocyclingTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
-    if (tempFile->open()) {
+    QTemporaryFile* compactedFile = new QTemporaryFile();
+    if (tempFile->open() && compactedFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/simpleIfNo.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/thermocycling.json", tempFile);
+            compactedFile->close();
 
-            BioBlocksTranslator translator(1*units::s, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
+            RepeatCompactor compactor;
+            std::shared_ptr<ProtocolGraph> protocol = compactor.translateFile(tempFile->fileName().toStdString(),
+                                                                              compactedFile->fileName().toStdString(),
+                                                                              200*units::ms);
+            QVERIFY2(compactor.getCompactedBlocks() == 1, "thermocycling block not compacted");
 
             qDebug() << protocol->toString().c_str();
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
-            executeProtocol(protocol, interface);
-
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
-
-            std::string expected = "setTimeStep(1000ms);loadContainer(A,0ml);loadContainer(B,0ml);loadContainer(C,0ml);setContinuosFlow(B,C,7ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(B,C);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
-
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            std::string report;
+            bool equal = executeAgainstGolden(protocol, std::vector<double>{}, ":/protocol/protocolos/golden/thermocycling.rle", report);
+            qDebug() << report.c_str();
+            QVERIFY2(equal, "compacted execution different from the thermocycling golden trace, check debug data for seeing where");
+
+            nlohmann::json json = ProtocolJson::read(tempFile->fileName().toStdString());
+            nlohmann::json compacted = compactor.compact(json);
+            json["linkedBlocks"][1][0]["cycles"] = {{"block_type", "math_number"}, {"value", "40"}};
+            nlohmann::json compacted40 = compactor.compact(json);
+            compacted40["linkedBlocks"][1][1]["condition"]["rigth"] = compacted["linkedBlocks"][1][1]["condition"]["rigth"];
+            QVERIFY2(compacted40 == compacted, "compacted protocol depends on the number of cycles");
         } catch (std::exception & e) {
             delete tempFile;
+            delete compactedFile;
             QFAIL(e.what());
         }
     } else {
         delete tempFile;
+        delete compactedFile;
         QFAIL("imposible to create temporary file");
     }
     delete tempFile;
+    delete compactedFile;
 }
 
 /*
- * OD = measureOd[0s:2s](A,0Hz,650nm);
- * if[-:](OD < 600) {
- *  transfer[-:](B,A,2ml);
- *  incubate[-:3s](A,26ºC,5Hz);
- * }
- * centrifugation[-:5s](A,50kHz,26ºC);
+ * nestedIf.json with od = 590 and flur = 500, with and without the condition cache:
+ * same execution and every condition is either evaluated or answered by the cache.
  *
+ * evoprog_switching_protocol.json polls its conditions slice after slice for 700 minutes: the time steps
+ * do not invalidate the cache, so some of them are answered by it.
  */
-void SequentialProtocol::complexIfYesTest() {
+void SequentialProtocol::conditionCacheTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/complexIf.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/nestedIf.json", tempFile);
 
             BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
+            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
 
-            qDebug() << protocol->toString().c_str();
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{590,500});
+            ProtocolExecutor executor(protocol, interface);
+            executor.execute();
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{550});
-            executeProtocol(protocol, interface);
+            BioBlocksTranslator cachedTranslator(200*units::ms, tempFile->fileName().toStdString());
+            std::shared_ptr<ProtocolGraph> cachedProtocol = cachedTranslator.translateFile();
+
+            StringActuatorsInterface* cachedInterface = new StringActuatorsInterface(std::vector<double>{590,500});
+            ProtocolExecutor cachedExecutor(cachedProtocol, cachedInterface);
+            cachedExecutor.enableConditionCache(true);
+            cachedExecutor.execute();
 
             std::string execution = interface->getStream().str();
+            std::string cachedExecution = cachedInterface->getStream().str();
             qDebug() << "protocol execution";
             qDebug() << execution.c_str();
-
-            std::string expected = "setTimeStep(200ms);loadContainer(A,1ml);loadContainer(B,5ml);measureOD(A,0Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();transfer(B,A,2ml);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopTransfer(B,A);applyTemperature(A,26Cº);shake(A,5Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);applyTemperature(A,26Cº);centrifugate(A,50000Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopCentrifugate(A);timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
-
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            qDebug() << "protocol execution with condition cache";
+            qDebug() << cachedExecution.c_str();
+            qDebug() << "evaluations:" << executor.getConditionEvaluations()
+                     << ", with cache:" << cachedExecutor.getConditionEvaluations()
+                     << ", skipped:" << cachedExecutor.getConditionsSkipped();
+
+            QVERIFY2(execution.compare(cachedExecution) == 0, "Execution with condition cache is not the same, check debug data for seeing where");
+            QVERIFY2(cachedExecutor.getConditionEvaluations() + cachedExecutor.getConditionsSkipped() == executor.getConditionEvaluations(),
+                     "wrong number of condition checks");
+
+            QTemporaryFile pollingFile;
+            QVERIFY2(pollingFile.open(), "imposible to create temporary file");
+            copyResourceFile(":/protocol/protocolos/evoprog_switching_protocol.json", &pollingFile);
+
+            BioBlocksTranslator pollingTranslator(240000*units::ms, pollingFile.fileName().toStdString());
+            StringActuatorsInterface pollingInterface(std::vector<double>{});
+            ProtocolExecutor pollingExecutor(pollingTranslator.translateFile(), &pollingInterface);
+            pollingExecutor.execute();
+
+            BioBlocksTranslator cachedPollingTranslator(240000*units::ms, pollingFile.fileName().toStdString());
+            StringActuatorsInterface cachedPollingInterface(std::vector<double>{});
+            ProtocolExecutor cachedPollingExecutor(cachedPollingTranslator.translateFile(), &cachedPollingInterface);
+            cachedPollingExecutor.enableConditionCache(true);
+            cachedPollingExecutor.execute();
+
+            qDebug() << "polling evaluations:" << pollingExecutor.getConditionEvaluations()
+                     << ", with cache:" << cachedPollingExecutor.getConditionEvaluations()
+                     << ", skipped:" << cachedPollingExecutor.getConditionsSkipped();
+            QVERIFY2(pollingInterface.getStream().str() == cachedPollingInterface.getStream().str(),
+                     "polling execution with condition cache is not the same");
+            QVERIFY2(cachedPollingExecutor.getConditionsSkipped() > 0, "no polled condition answered by the cache");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -381,38 +497,68 @@ void SequentialProtocol::complexIfYesTest() {
 }
 
 /*
- * OD = measureOd[0s:2s](A,0Hz,650nm);
- * if[-:](OD < 600) {
- *  transfer[-:](B,A,2ml);
- *  incubate[-:3s](A,26ºC,5Hz);
- * }
- * centrifugation[-:5s](A,50kHz,26ºC);
+ * twoOperationsLinked.json in real time with every 1s slice lasting 10ms of wall clock:
+ * same execution, 22 slices paced against the clock, each one with its own timing.
  *
+ * A time step without a slice is refused; after an overrun of three slices the commands issued while catching
+ * up are merged: the flow stopped and restarted is not sent and only the last temperature reaches the backend.
  */
-void SequentialProtocol::complexIfNoTest() {
+void SequentialProtocol::realTimeExecutionTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/complexIf.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/twoOperationsLinked.json", tempFile);
 
-            BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
+            BioBlocksTranslator translator(1*units::s, tempFile->fileName().toStdString());
+            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
 
-            qDebug() << protocol->toString().c_str();
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
+            RealTimeExecutor executor(protocol, interface, false, 0.01);
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{650});
-            executeProtocol(protocol, interface);
+            QElapsedTimer timer;
+            timer.start();
+            executor.start();
+            executor.wait();
+            qint64 elapsedMs = timer.elapsed();
+
+            RealTimeActuatorsInterface::RealTimeStatistics statistics = executor.getStatistics();
+            qDebug() << "wall clock:" << elapsedMs << "ms, slices:" << statistics.slices << ", overruns:" << statistics.overruns
+                     << ", mean jitter:" << statistics.meanJitterUs << "us, max jitter:" << statistics.maxJitterUs << "us";
 
             std::string execution = interface->getStream().str();
             qDebug() << "protocol execution";
             qDebug() << execution.c_str();
 
-            std::string expected = "setTimeStep(200ms);loadContainer(A,1ml);loadContainer(B,5ml);measureOD(A,0Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();applyTemperature(A,26Cº);centrifugate(A,50000Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopCentrifugate(A);timeStep();timeStep();";
+            std::string expected = "setTimeStep(1000ms);loadContainer(A,1ml);loadContainer(B,0ml);loadContainer(C,0ml);setContinuosFlow(A,B,10ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(A,B);setContinuosFlow(B,C,7.2e+07ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(B,C);timeStep();timeStep();";
             qDebug() << "protocol expected execution";
             qDebug() << expected.c_str();
 
             QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            QVERIFY2(statistics.slices == 22 && statistics.timeSteps == 22, "wrong number of slices");
+            QVERIFY2(elapsedMs >= 220, "slices shorter than their wall clock length");
+            QVERIFY2(executor.getSliceTimings().size() == 22, "wrong number of slice timings");
+
+            StringActuatorsInterface catchUpBackend(std::vector<double>{});
+            RealTimeActuatorsInterface catchUp(&catchUpBackend, true, 0.01);
+            QVERIFY_EXCEPTION_THROWN(catchUp.timeStep(), std::runtime_error);
+
+            catchUp.setTimeStep(1*units::s);
+            catchUp.setContinuosFlow("A", "B", 10*units::ml/units::hr);
+            catchUp.timeStep();
+            QThread::msleep(35);
+            catchUp.timeStep();
+            catchUp.stopContinuosFlow("A", "B");
+            catchUp.setContinuosFlow("A", "B", 10*units::ml/units::hr);
+            catchUp.applyTemperature("A", 20*units::C);
+            catchUp.applyTemperature("A", 30*units::C);
+            catchUp.timeStep();
+
+            std::vector<RealTimeActuatorsInterface::SliceTiming> timings = catchUp.getSliceTimings();
+            QVERIFY2(timings.size() == 3 && timings[1].slices >= 3 && timings[1].overrunUs > 0, "overrun not recorded in its slice");
+            QVERIFY2(catchUpBackend.getStream().str() ==
+                     "setTimeStep(1000ms);setContinuosFlow(A,B,10ml/h);timeStep();timeStep();applyTemperature(A,30Cº);timeStep();",
+                     "commands issued while catching up not merged");
+            QVERIFY2(catchUp.getStatistics().mergedCommands == 3, "wrong number of merged commands");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -425,35 +571,30 @@ void SequentialProtocol::complexIfNoTest() {
 }
 
 /*
- * flag = 0;
- * if[-:](flag != 0) {
- *  continuosFlow[-:2s](B,A,5ml/hr);
- * } else if (flag == 0) {
- *  mix[-:3s](A,vortex,50Hz);
- * }
- * centrifugation[-:5s](A,50hz,26ºC)
- *
+ * nestedIf.json with od = 590 and flur = 500 through the I/O thread queue:
+ * same execution, measurements and transfers answered through futures.
  */
-void SequentialProtocol::elifB2Test() {
+void SequentialProtocol::asyncCommandQueueTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/elifB2.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/nestedIf.json", tempFile);
 
             BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
+            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
 
-            qDebug() << protocol->toString().c_str();
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{590,500});
+            AsyncActuatorsInterface asyncInterface(interface, 8);
+            executeProtocol(protocol, &asyncInterface);
+            asyncInterface.flush();
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{650});
-            executeProtocol(protocol, interface);
+            qDebug() << "queued calls:" << asyncInterface.getQueuedCalls() << ", waits on full queue:" << asyncInterface.getFullQueueWaits();
 
             std::string execution = interface->getStream().str();
             qDebug() << "protocol execution";
             qDebug() << execution.c_str();
 
-            std::string expected = "setTimeStep(200ms);loadContainer(B,0ml);loadContainer(A,0ml);stir(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopStir(A);applyTemperature(A,26Cº);centrifugate(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopCentrifugate(A);timeStep();";
+            std::string expected = "setTimeStep(200ms);loadContainer(A,1ml);loadContainer(B,1.5ml);loadContainer(C,0ml);measureOD(A,50Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();transfer(B,A,0.5ml);timeStep();timeStep();timeStep();stopTransfer(B,A);applyTemperature(A,26Cº);shake(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);measureFluorescence(A,50Hz,650nm, 650nm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureFluorescence(A);timeStep();transfer(A,C,1.5ml);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopTransfer(A,C);startElectrophoresis(A,2V/cm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopElectrophoresis(A);timeStep();";
             qDebug() << "protocol expected execution";
             qDebug() << expected.c_str();
 
@@ -470,39 +611,47 @@ void SequentialProtocol::elifB2Test() {
 }
 
 /*
- * flag = 1;
- * if[-:](flag != 0) {
- *  continuosFlow[-:2s](B,A,5ml/hr);
- * } else if (flag == 0) {
- *  mix[-:3s](A,vortex,50Hz);
- * }
- * centrifugation[-:5s](A,50hz,26ºC)
- *
+ * mix_test_v2.json trace indexed by time: stir and heat active until 30s,
+ * same answers from the index saved to disk and loaded again.
  */
-void SequentialProtocol::elifB1Test() {
+void SequentialProtocol::traceTimelineTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
-    if (tempFile->open()) {
+    QTemporaryDir indexDir;
+    if (tempFile->open() && indexDir.isValid()) {
         try {
-            copyResourceFile(":/protocol/protocolos/elifB1.json", tempFile);
-
-            BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
+            copyResourceFile(":/protocol/protocolos/mix_test_v2.json", tempFile);
 
-            qDebug() << protocol->toString().c_str();
+            BioBlocksTranslator translator(10*units::s, tempFile->fileName().toStdString());
+            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{650});
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
             executeProtocol(protocol, interface);
 
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+            std::istringstream trace(interface->getStream().str());
+            TraceTimeline builtTimeline;
+            builtTimeline.build(trace);
 
-            std::string expected = "setTimeStep(200ms);loadContainer(B,0ml);loadContainer(A,0ml);setContinuosFlow(B,A,5ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(B,A);applyTemperature(A,26Cº);centrifugate(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopCentrifugate(A);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            std::string indexPath = indexDir.filePath("trace.idx").toStdString();
+            builtTimeline.saveIndex(indexPath);
+            TraceTimeline loadedTimeline = TraceTimeline::loadIndex(indexPath);
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            for(const TraceTimeline & timeline: {builtTimeline, loadedTimeline}) {
+                std::stringstream log;
+                timeline.writeLog(log, "ms");
+                qDebug() << log.str().c_str();
+
+                QVERIFY2(log.str().find("30000ms:stopStir(A)\n") != std::string::npos &&
+                         log.str().find("50000ms:END\n") != std::string::npos, "wrong timestamped log");
+
+                QVERIFY2(timeline.activeAt(25000).size() == 2, "stir and temperature should be active at 25s");
+                QVERIFY2(timeline.activeAt(30000).empty(), "nothing should be active at 30s");
+
+                std::vector<int> commands = timeline.commandsFor("A", 10000, 30000);
+                QVERIFY2(commands.size() == 2 && timeline.getCommand(commands[0]).text == "stopStir(A)", "wrong commands for A");
+
+                TraceTimeline::ContainerOccupancy occupancy = timeline.occupancy("A");
+                QVERIFY2(occupancy.busySlices == 3 && occupancy.commands == 5, "wrong occupancy of A");
+            }
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -515,39 +664,25 @@ void SequentialProtocol::elifB1Test() {
 }
 
 /*
- * flag = -1;
- * if[-:](flag > 0) {
- *  continuosFlow[-:2s](B,A,5ml/hr);
- * } else if (flag == 0) {
- *  mix[-:3s](A,vortex,50Hz);
- * }
- * dentrifugation[-:5s](A,50hz,26ºC)
- *
+ * sequential.json checked against the golden trace of mix_test_v2.json:
+ * the comparison stops at the first different command, loadContainer of A.
  */
-void SequentialProtocol::elifNoBTest() {
+void SequentialProtocol::goldenTraceDivergenceTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/elifNoB.json", tempFile);
-
-            BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
-
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{650});
-            executeProtocol(protocol, interface);
+            copyResourceFile(":/protocol/protocolos/sequential.json", tempFile);
 
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+            BioBlocksTranslator translator(10*units::s, tempFile->fileName().toStdString());
+            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
 
-            std::string expected = "setTimeStep(200ms);loadContainer(B,0ml);loadContainer(A,0ml);applyTemperature(A,26Cº);centrifugate(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopCentrifugate(A);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            std::string report;
+            bool equal = executeAgainstGolden(protocol, std::vector<double>{}, ":/protocol/protocolos/golden/mixHeat.rle", report);
+            qDebug() << report.c_str();
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            QVERIFY2(!equal, "execution of a different protocol equal to the golden trace");
+            QVERIFY2(report.find("command 1, slice 0, container A:") != std::string::npos, "wrong divergence report");
+            QVERIFY2(report.find("expected loadContainer(A,0ml), executed loadContainer(A,1ml)") != std::string::npos, "wrong divergence report");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -560,39 +695,91 @@ void SequentialProtocol::elifNoBTest() {
 }
 
 /*
- * flag = -1;
- * if[-:](flag > 0) {
- *  continuosFlow[-:2s](B,A,5ml/hr);
- * } else {
- *  mix[-:3s](A,vortex,50Hz);
- * }
- * centrifugation[-:5s](A,50hz,26ºC)
- *
+ * every case of protocolos/manifest.json executed against its golden trace,
+ * the cases run in parallel and only the failing ones are dumped
+ */
+void SequentialProtocol::protocolCorpusTest() {
+    QTemporaryDir corpusDir;
+    QFile manifestFile(":/protocol/protocolos/manifest.json");
+    if (corpusDir.isValid() && manifestFile.open(QIODevice::ReadOnly) && QDir(corpusDir.path()).mkdir("golden")) {
+        try {
+            std::vector<ProtocolCorpusRunner::ProtocolCase> cases =
+                    ProtocolCorpusRunner::readManifest(nlohmann::json::parse(manifestFile.readAll().toStdString()));
+
+            for(const ProtocolCorpusRunner::ProtocolCase & protocolCase: cases) {
+                for(const std::string & file: {protocolCase.protocol, protocolCase.golden}) {
+                    QString resource = ":/protocol/protocolos/" + QString::fromStdString(file);
+                    QString copy = corpusDir.filePath(QString::fromStdString(file));
+                    if (!QFile::exists(copy) && !QFile::copy(resource, copy)) {
+                        throw(std::invalid_argument("imposible to copy " + resource.toStdString()));
+                    }
+                }
+            }
+
+            ProtocolCorpusRunner runner;
+            std::vector<ProtocolCorpusRunner::CaseResult> results = runner.run(cases, corpusDir.path().toStdString());
+
+            std::string failed;
+            for(size_t i = 0; i < results.size(); i++) {
+                if (!results[i].passed) {
+                    qDebug() << results[i].name.c_str() << ":" << results[i].report.c_str();
+                    qDebug() << cases[i].description.c_str();
+                    qDebug() << results[i].dump.c_str();
+                    failed += " " + results[i].name;
+                }
+            }
+            QVERIFY2(failed.empty(), ("cases different from their golden trace:" + failed).c_str());
+        } catch (std::exception & e) {
+            QFAIL(e.what());
+        }
+    } else {
+        QFAIL("imposible to prepare the protocol corpus");
+    }
+}
+
+/*
+ * nestedIf.json with the if branches translated only when they are taken:
+ * same execution as translating the whole protocol, the untaken branches never translated.
  */
-void SequentialProtocol::ifElseElseTest() {
+void SequentialProtocol::lazyBranchTranslationTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
-    if (tempFile->open()) {
+    QTemporaryDir translatedDir;
+    if (tempFile->open() && translatedDir.isValid()) {
         try {
-            copyResourceFile(":/protocol/protocolos/ifElseElse.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/nestedIf.json", tempFile);
 
             BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
+            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{650});
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{590,500});
             executeProtocol(protocol, interface);
 
+            StringActuatorsInterface* lazyInterface = new StringActuatorsInterface(std::vector<double>{590,500});
+            LazyProtocolExecutor lazyExecutor(tempFile->fileName().toStdString(),
+                                              translatedDir.filePath("lazy.json").toStdString(),
+                                              200*units::ms,
+                                              lazyInterface);
+            lazyExecutor.execute();
+
             std::string execution = interface->getStream().str();
+            std::string lazyExecution = lazyInterface->getStream().str();
             qDebug() << "protocol execution";
             qDebug() << execution.c_str();
-
-            std::string expected = "setTimeStep(200ms);loadContainer(B,0ml);loadContainer(A,0ml);stir(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopStir(A);applyTemperature(A,26Cº);centrifugate(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopCentrifugate(A);timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
-
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            qDebug() << "protocol execution with lazy branches";
+            qDebug() << lazyExecution.c_str();
+            qDebug() << "branches:" << lazyExecutor.getTranslator().getBranchesCount()
+                     << ", translated:" << lazyExecutor.getTranslator().getExpandedCount()
+                     << ", translations:" << lazyExecutor.getTranslator().getTranslations()
+                     << ", replayed calls:" << lazyExecutor.getReplayedCalls();
+
+            QVERIFY2(execution.compare(lazyExecution) == 0, "Execution with lazy branches is not the same, check debug data for seeing where");
+            QVERIFY2(lazyExecutor.getTranslator().getExpandedCount() < lazyExecutor.getTranslator().getBranchesCount(),
+                     "untaken branches translated");
+            QVERIFY2(lazyExecutor.getTranslator().getTranslations() == lazyExecutor.getTranslator().getExpandedCount() + 1,
+                     "wrong number of translations");
+            QVERIFY2(lazyExecutor.getReplayedCalls() > 0, "branch not spliced replaying the executed prefix");
+            QVERIFY2(lazyExecutor.isRecordingDropped() && lazyExecutor.getRecordedCalls() == 0,
+                     "executed prefix kept with no branch left to expand");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -605,40 +792,99 @@ void SequentialProtocol::ifElseElseTest() {
 }
 
 /*
- * flag = 1;
- * if[-:](flag > 0) {
- *  continuosFlow[-:2s](B,A,5ml/hr);
- *  incubate[-:3s](A,50Hz,26ºC);
- * } else {
- *  mix[-:3s](A,vortex,50Hz);
- * }
- * centrifugation[-:5s](A,50hz,26ºC)
- *
+ * cost of the lazy translation, in blocks translated and calls replayed, against translating the whole protocol once:
+ * nestedIf.json with od = 650 never takes the deferred branch, one smaller translation and nothing replayed, the
+ * prefix dropped once the if is behind; with od = 590 the branch costs a second translation and the replay of the prefix;
+ * in elifB2.json no branch is bigger than its marker, the same single translation as the whole protocol.
  */
-void SequentialProtocol::ifElseIfTest() {
+void SequentialProtocol::lazyBranchCostTest() {
+    QTemporaryDir translatedDir;
+    if (translatedDir.isValid()) {
+        try {
+            std::vector<std::string> protocols = {"nestedIf.json", "nestedIf.json", "elifB2.json"};
+            std::vector<std::vector<double>> reads = {{650,500}, {590,500}, {}};
+            for(size_t i = 0; i < protocols.size(); i++) {
+                QTemporaryFile tempFile;
+                if (!tempFile.open()) {
+                    QFAIL("imposible to create temporary file");
+                }
+                copyResourceFile((":/protocol/protocolos/" + protocols[i]).c_str(), &tempFile);
+
+                BioBlocksTranslator translator(200*units::ms, tempFile.fileName().toStdString());
+                StringActuatorsInterface* interface = new StringActuatorsInterface(reads[i]);
+                executeProtocol(translator.translateFile(), interface);
+
+                StringActuatorsInterface* lazyInterface = new StringActuatorsInterface(reads[i]);
+                LazyProtocolExecutor lazyExecutor(tempFile.fileName().toStdString(),
+                                                  translatedDir.filePath("lazy.json").toStdString(),
+                                                  200*units::ms,
+                                                  lazyInterface);
+                lazyExecutor.execute();
+
+                const LazyBranchTranslator & lazyTranslator = lazyExecutor.getTranslator();
+                qDebug() << protocols[i].c_str() << ": eager blocks:" << lazyTranslator.getProtocolBlocks()
+                         << ", lazy blocks:" << lazyExecutor.getTranslatedBlocks()
+                         << ", translations:" << lazyTranslator.getTranslations()
+                         << ", replayed calls:" << lazyExecutor.getReplayedCalls();
+
+                QVERIFY2(interface->getStream().str() == lazyInterface->getStream().str(),
+                         ("Execution with lazy branches of " + protocols[i] + " is not the same").c_str());
+                QVERIFY2(lazyExecutor.isRecordingDropped() && lazyExecutor.getRecordedCalls() == 0,
+                         ("executed prefix of " + protocols[i] + " kept to the end").c_str());
+                if (i == 0) {
+                    QVERIFY2(lazyExecutor.getTranslatedBlocks() < lazyTranslator.getProtocolBlocks() &&
+                             lazyTranslator.getTranslations() == 1 && lazyExecutor.getReplayedCalls() == 0,
+                             "untaken branch not cheaper than translating the whole protocol");
+                } else if (i == 1) {
+                    QVERIFY2(lazyTranslator.getTranslations() == 2 && lazyExecutor.getReplayedCalls() > 0 &&
+                             lazyExecutor.getTranslatedBlocks() < 2 * lazyTranslator.getProtocolBlocks(),
+                             "taken branch costs more than a second translation");
+                } else {
+                    QVERIFY2(lazyExecutor.getTranslatedBlocks() == lazyTranslator.getProtocolBlocks() &&
+                             lazyTranslator.getTranslations() == 1 && lazyExecutor.getReplayedCalls() == 0,
+                             "branches smaller than their marker deferred");
+                }
+            }
+        } catch (std::exception & e) {
+            QFAIL(e.what());
+        }
+    } else {
+        QFAIL("imposible to create temporary dir");
+    }
+}
+
+/*
+ * nestedIf.json explored with od in {590, 650} and fluorescence in {500, 650}:
+ * three paths, only od = 590, flur = 500 transfers all of A to C and drains it.
+ */
+void SequentialProtocol::branchSpaceExplorationTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/ifElseIf.json", tempFile);
-
-            BioBlocksTranslator translator(200.0 * units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol =
-                    translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
-
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{650});
-            executeProtocol(protocol, interface);
-
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+            copyResourceFile(":/protocol/protocolos/nestedIf.json", tempFile);
 
-            std::string expected = "setTimeStep(200ms);loadContainer(B,0ml);loadContainer(A,0ml);setContinuosFlow(B,A,5ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(B,A);applyTemperature(A,26Cº);shake(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);applyTemperature(A,26Cº);centrifugate(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopCentrifugate(A);timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            std::string path = tempFile->fileName().toStdString();
+            BranchSpaceExplorer explorer([path]() {
+                BioBlocksTranslator translator(200*units::ms, path);
+                return translator.translateFile();
+            });
+            explorer.setOutcomes("OD", std::vector<double>{590, 650});
+            explorer.setOutcomes("Fluorescence", std::vector<double>{500, 650});
+            explorer.addVolumeBounds("A", 0.1, 10);
+
+            BranchSpaceExplorer::ExplorationResult result = explorer.explore();
+            qDebug() << "paths:" << result.paths << ", pruned:" << result.prunedPaths
+                     << ", states:" << result.states << ", steals:" << result.steals
+                     << ", duration:" << result.durationMs << "ms";
+            for(const BranchSpaceExplorer::Violation & violation: result.violations) {
+                qDebug() << violation.invariant.c_str() << "at slice" << violation.slice
+                         << "with values" << QVector<double>::fromStdVector(violation.values);
+            }
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            QVERIFY2(result.paths == 3, "wrong number of explored paths");
+            QVERIFY2(result.violations.size() == 1, "wrong number of violations");
+            QVERIFY2(result.violations[0].values == std::vector<double>({590, 500}), "violation in the wrong path");
+            QVERIFY2(result.prunedPaths == 0 && result.states == 0, "states merged without knowing the graph variables");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -651,40 +897,63 @@ void SequentialProtocol::ifElseIfTest() {
 }
 
 /*
- * od = measurementOd[0s:2s](A,50Hz,650nm);
- * if[_:](od < 600) {
- *  transfer[-:](B,A,0.5ml);
- *  incubate[-:5s](A,50Hz,26ºC);
- *  flur = measurementFluorescence[-:2s](A,50Hz,650nm,650nm);
- *  if[-:](flur < 600) {
- *      transfer[-:](A,C,1.5ml);
- *  }
- * }
- * bands = electrophoresis[-:2s](A,2v/cm);
+ * evoprog_switching_protocol.json at 4 minute slices waits up to 150 slices between two switches:
+ * expanded, the execution is the same; compressed, the commands of the repeated slices are not sent,
+ * the repeated periods account for every command left out and every time step still reaches the backend.
  */
-void SequentialProtocol::nestedIfsTestNoBTest() {
+void SequentialProtocol::steadyStateCompressionTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/nestedIf.json", tempFile);
+            copyResourceFile(":/protocol/protocolos/evoprog_switching_protocol.json", tempFile);
 
-            BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
+            std::string path = tempFile->fileName().toStdString();
+            BioBlocksTranslator translator(240000*units::ms, path);
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
+            executeProtocol(translator.translateFile(), interface);
 
-            qDebug() << protocol->toString().c_str();
+            BioBlocksTranslator expandedTranslator(240000*units::ms, path);
+            StringActuatorsInterface* expandedInterface = new StringActuatorsInterface(std::vector<double>{});
+            SteadyStateExecutor expandedExecutor(expandedTranslator.translateFile(), expandedInterface, 8, true);
+            expandedExecutor.execute();
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{650});
-            executeProtocol(protocol, interface);
+            BioBlocksTranslator compressedTranslator(240000*units::ms, path);
+            StringActuatorsInterface* compressedInterface = new StringActuatorsInterface(std::vector<double>{});
+            SteadyStateExecutor compressedExecutor(compressedTranslator.translateFile(), compressedInterface, 8, false);
+            compressedExecutor.execute();
 
             std::string execution = interface->getStream().str();
+            std::string expandedExecution = expandedInterface->getStream().str();
+            std::string compressedExecution = compressedInterface->getStream().str();
             qDebug() << "protocol execution";
             qDebug() << execution.c_str();
+            qDebug() << "compressed execution";
+            qDebug() << compressedExecution.c_str();
+
+            unsigned long long droppedCommands = 0;
+            for(const SteadyStateActuatorsInterface::RepeatedPeriod & repeatedPeriod: compressedExecutor.getRepeatedPeriods()) {
+                qDebug() << "from slice" << repeatedPeriod.firstSlice << ":" << repeatedPeriod.periods
+                         << "periods of" << repeatedPeriod.periodSlices << "slices";
+                droppedCommands += repeatedPeriod.periods * repeatedPeriod.commands;
+            }
 
-            std::string expected = "setTimeStep(200ms);loadContainer(A,1ml);loadContainer(B,1.5ml);loadContainer(C,0ml);measureOD(A,50Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();startElectrophoresis(A,2V/cm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopElectrophoresis(A);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            std::string timeStep = "timeStep();";
+            unsigned long long timeSteps = 0;
+            unsigned long long compressedTimeSteps = 0;
+            for(size_t pos = execution.find(timeStep); pos != std::string::npos; pos = execution.find(timeStep, pos + 1)) {
+                timeSteps++;
+            }
+            for(size_t pos = compressedExecution.find(timeStep); pos != std::string::npos; pos = compressedExecution.find(timeStep, pos + 1)) {
+                compressedTimeSteps++;
+            }
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            QVERIFY2(execution.compare(expandedExecution) == 0, "expanded execution is not the same, check debug data for seeing where");
+            QVERIFY2(!compressedExecutor.getRepeatedPeriods().empty(), "steady state not detected");
+            QVERIFY2(droppedCommands == compressedExecutor.getSkippedCalls(), "repeated periods do not match the skipped commands");
+            QVERIFY2(compressedTimeSteps == timeSteps, "time steps answered from the period");
+            QVERIFY2((unsigned long long) std::count(compressedExecution.begin(), compressedExecution.end(), ';') + compressedExecutor.getSkippedCalls() ==
+                     (unsigned long long) std::count(execution.begin(), execution.end(), ';'),
+                     "compressed execution and skipped commands do not add up to the execution");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -697,40 +966,86 @@ void SequentialProtocol::nestedIfsTestNoBTest() {
 }
 
 /*
- * od = measurementOd[0s:2s](A,50Hz,650nm);
- * if[_:](od < 600) {
- *  transfer[-:](B,A,0.5ml);
- *  incubate[-:5s](A,50Hz,26ºC);
- *  flur = measurementFluorescence[-:2s](A,50Hz,650nm,650nm);
- *  if[-:](flur < 600) {
- *      transfer[-:](A,C,1.5ml);
- *  }
- * }
- * bands = electrophoresis[-:2s](A,2v/cm);
+ * setContinuosFlow(A,B,10ml/h); getMeasureOD(B); timeStep(); every slice, OD 5 but 7 once in 9 reads:
+ * compressed, every read reaches the backend, the 7 is answered as it was read and ends the repeated period,
+ * and the held flow of that slice is sent right after it.
  */
-void SequentialProtocol::nestedIfsTestB1Test() {
-    QTemporaryFile* tempFile = new QTemporaryFile();
-    if (tempFile->open()) {
-        try {
-            copyResourceFile(":/protocol/protocolos/nestedIf.json", tempFile);
-
-            BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
+void SequentialProtocol::steadyStateReadsTest() {
+    StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{5,5,5,5,5,5,5,5,7});
+    SteadyStateActuatorsInterface steadyInterface(interface, 8, false);
+    steadyInterface.setTimeStep(1*units::s);
+
+    std::vector<double> reads;
+    for(int slice = 0; slice < 12; slice++) {
+        steadyInterface.setContinuosFlow("A", "B", 10*units::ml/units::hr);
+        reads.push_back(steadyInterface.getMeasureOD("B"));
+        steadyInterface.timeStep();
+        steadyInterface.setSliceState(0);
+    }
+    steadyInterface.finish();
 
-            qDebug() << protocol->toString().c_str();
+    std::string execution = interface->getStream().str();
+    qDebug() << "compressed execution";
+    qDebug() << execution.c_str();
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{590,650});
-            executeProtocol(protocol, interface);
+    std::string read = "getMeasureOD(B);";
+    unsigned long long sentReads = 0;
+    for(size_t pos = execution.find(read); pos != std::string::npos; pos = execution.find(read, pos + 1)) {
+        sentReads++;
+    }
 
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+    QVERIFY2(sentReads == 12, "reads answered from the period");
+    QVERIFY2(reads[8] == 7 && reads[7] == 5 && reads[9] == 5, "reads not answered with the backend values");
+    QVERIFY2(steadyInterface.getRepeatedPeriods().size() == 2 && steadyInterface.getRepeatedPeriods()[0].periods == 5,
+             "a different read does not end the repeated period");
+    QVERIFY2(execution.find("getMeasureOD(B);setContinuosFlow(A,B,10ml/h);timeStep();") != std::string::npos,
+             "held flow not sent after the read that left the steady state");
+    QVERIFY2(steadyInterface.getSkippedCalls() == 6, "wrong number of dropped commands");
+}
 
-            std::string expected = "setTimeStep(200ms);loadContainer(A,1ml);loadContainer(B,1.5ml);loadContainer(C,0ml);measureOD(A,50Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();transfer(B,A,0.5ml);timeStep();timeStep();timeStep();stopTransfer(B,A);applyTemperature(A,26Cº);shake(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);measureFluorescence(A,50Hz,650nm, 650nm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureFluorescence(A);timeStep();startElectrophoresis(A,2V/cm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopElectrophoresis(A);timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+/*
+ * evoprog_switching_protocol.json through the command optimizer: at every switch the flows that keep
+ * running (mediaA->chemoA, cellstat->wasteC, mediaB->chemoB) are no longer stopped and restarted.
+ * With the literal stream the execution is the same as without the optimizer.
+ */
+void SequentialProtocol::redundantCommandEliminationTest() {
+    QTemporaryFile* tempFile = new QTemporaryFile();
+    if (tempFile->open()) {
+        try {
+            copyResourceFile(":/protocol/protocolos/evoprog_switching_protocol.json", tempFile);
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            std::string path = tempFile->fileName().toStdString();
+            BioBlocksTranslator translator(240*units::s, path);
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
+            executeProtocol(translator.translateFile(), interface);
+
+            BioBlocksTranslator literalTranslator(240*units::s, path);
+            StringActuatorsInterface* literalInterface = new StringActuatorsInterface(std::vector<double>{});
+            CommandOptimizingActuatorsInterface literalOptimizer(literalInterface, true);
+            executeProtocol(literalTranslator.translateFile(), &literalOptimizer);
+
+            BioBlocksTranslator optimizedTranslator(240*units::s, path);
+            StringActuatorsInterface* optimizedInterface = new StringActuatorsInterface(std::vector<double>{});
+            CommandOptimizingActuatorsInterface optimizer(optimizedInterface);
+            executeProtocol(optimizedTranslator.translateFile(), &optimizer);
+            optimizer.flush();
+
+            QFile golden(":/protocol/protocolos/golden/evoproSwitchingOptimized.rle");
+            if (!golden.open(QIODevice::ReadOnly)) {
+                throw(std::invalid_argument("imposible to open evoproSwitchingOptimized.rle"));
+            }
+            std::string expected = golden.readAll().toStdString();
+            std::string optimized = GoldenTrace::compress(optimizedInterface->getStream().str());
+            qDebug() << "optimized execution";
+            qDebug() << optimized.c_str();
+            qDebug() << "cancelled pairs:" << optimizer.getCancelledPairs()
+                     << ", dropped set-points:" << optimizer.getDroppedSetPoints()
+                     << ", merged changes:" << optimizer.getMergedChanges()
+                     << ", removed commands:" << optimizer.getRemovedCommands();
+
+            QVERIFY2(interface->getStream().str().compare(literalInterface->getStream().str()) == 0, "literal stream changed by the optimizer");
+            QVERIFY2(optimized.compare(expected) == 0, "Optimized execution and expected execution are not the same, check debug data for seeing where");
+            QVERIFY2(optimizer.getCancelledPairs() == 30 && optimizer.getRemovedCommands() == 60, "wrong number of removed commands");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -743,40 +1058,55 @@ void SequentialProtocol::nestedIfsTestB1Test() {
 }
 
 /*
- * od = measurementOd[0s:2s](A,50Hz,650nm);
- * if[_:](od < 600) {
- *  transfer[-:](B,A,0.5ml);
- *  incubate[-:5s](A,50Hz,26ºC);
- *  flur = measurementFluorescence[-:2s](A,50Hz,650nm,650nm);
- *  if[-:](flur < 600) {
- *      transfer[-:](A,C,1.5ml);
- *  }
- * }
- * bands = electrophoresis[-:2s](A,2v/cm);
+ * Times parsed into integer ticks add up exactly: 36000 slices of 0.1 s are one hour, in the parser, in the
+ * simulated clock and in the elapsed time of the executor, where the same sum in floating point drifts.
+ * Past the range of ticks sums and products are UNBOUNDED and the time step that gets there fails.
  */
-void SequentialProtocol::nestedIfsTestB1N1Test() {
+void SequentialProtocol::tickTimebaseTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/nestedIf.json", tempFile);
-
-            BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
-
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{590,500});
-            executeProtocol(protocol, interface);
-
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+            copyResourceFile(":/protocol/protocolos/twoOperationsLinked.json", tempFile);
 
-            std::string expected = "setTimeStep(200ms);loadContainer(A,1ml);loadContainer(B,1.5ml);loadContainer(C,0ml);measureOD(A,50Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();transfer(B,A,0.5ml);timeStep();timeStep();timeStep();stopTransfer(B,A);applyTemperature(A,26Cº);shake(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);measureFluorescence(A,50Hz,650nm, 650nm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureFluorescence(A);timeStep();transfer(A,C,1.5ml);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopTransfer(A,C);startElectrophoresis(A,2V/cm);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopElectrophoresis(A);timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            TickTimebase::Ticks slice = TickTimebase::parse("0.1", "s");
+            TickTimebase::Ticks hour = TickTimebase::parse("1", "hr");
+            QVERIFY2(slice == 100 * TickTimebase::TICKS_PER_MS, "0.1 s is not 100 ms");
+            QVERIFY2(TickTimebase::multiply(slice, 36000) == hour, "36000 slices of 0.1 s are not one hour");
+            QVERIFY2(TickTimebase::parse("1.5", "minute") == TickTimebase::parse("90", "s"), "1.5 minutes are not 90 s");
+            QVERIFY2(TickTimebase::parse("-1", "ms") < 0, "linked time is not negative");
+            QVERIFY2(TickTimebase::add(hour, TickTimebase::UNBOUNDED) == TickTimebase::UNBOUNDED, "unbounded absorbs additions");
+            QVERIFY2(TickTimebase::slicesFor(hour + 1, slice) == 36001, "partial slice not rounded up");
+            QVERIFY2(TickTimebase::multiply(hour, 1ULL << 40) == TickTimebase::UNBOUNDED, "overflowed product wrapped around");
+            QVERIFY2(TickTimebase::add(TickTimebase::UNBOUNDED - 1, hour) == TickTimebase::UNBOUNDED, "overflowed sum wrapped around");
+
+            double floatingMs = 0;
+            SimulatedActuatorsInterface simulated;
+            simulated.setTimeStep(TickTimebase::toTime(slice));
+            for(int i = 0; i < 36000; i++) {
+                simulated.timeStep();
+                floatingMs += (0.1*units::s).to(units::ms);
+            }
+            qDebug() << "floating point:" << QString::number(floatingMs, 'f', 9) << "ms, ticks:" << TickTimebase::fromTime(simulated.getSimulatedTime());
+            QVERIFY2(TickTimebase::fromTime(simulated.getSimulatedTime()) == hour, "simulated clock drifted");
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            BioBlocksTranslator translator(100*units::ms, tempFile->fileName().toStdString());
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
+            ProtocolExecutor executor(translator.translateFile(), interface);
+            executor.execute();
+            QVERIFY2(executor.getElapsedTicks() == TickTimebase::multiply(slice, executor.getElapsedSlices()), "elapsed ticks are not whole slices");
+
+            StringActuatorsInterface* longInterface = new StringActuatorsInterface(std::vector<double>{});
+            ActiveStateActuatorsInterface longState(longInterface);
+            longState.setTimeStep(TickTimebase::toTime(TickTimebase::UNBOUNDED / 2));
+            bool overflowed = false;
+            try {
+                for(int i = 0; i < 3; i++) {
+                    longState.timeStep();
+                }
+            } catch (std::overflow_error & e) {
+                overflowed = true;
+            }
+            QVERIFY2(overflowed && longState.getElapsedTicks() == TickTimebase::UNBOUNDED, "elapsed time wrapped around");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -789,76 +1119,270 @@ void SequentialProtocol::nestedIfsTestB1N1Test() {
 }
 
 /*
- * od = 0;
- * while[0s:](od <= 600) {
- *  incubate[x:5s](A,26ºC,50Hz,50%);
- *  od = measurement[x:1s](A,5Hz,650nm);
- * }
- * transfer[x:](A,B,1ml);
- * centrifugation[x:3s](B,50Hz,26ºC);
+ * thermocyclingSweep.json marks the cycles and the centrifugation speed of thermocycling.json as parameters:
+ * the six variants of the sweep, run on three threads, execute as the same protocol with the literals
+ * changed in the json. Lowered, the parameters are read from graph variables.
  */
-void SequentialProtocol::loopTest() {
-    QTemporaryFile* tempFile = new QTemporaryFile();
-    if (tempFile->open()) {
+void SequentialProtocol::parameterSweepTest() {
+    QTemporaryDir tempDir;
+    if (tempDir.isValid()) {
         try {
-            copyResourceFile(":/protocol/protocolos/loop.json", tempFile);
+            std::string dir = tempDir.path().toStdString();
+            QFile::copy(":/protocol/protocolos/thermocyclingSweep.json", tempDir.filePath("thermocyclingSweep.json"));
+            QFile::copy(":/protocol/protocolos/thermocycling.json", tempDir.filePath("thermocycling.json"));
+
+            ParameterizedProtocol protocol(dir + "/thermocyclingSweep.json");
+            QVERIFY2(protocol.getParameters() == std::vector<std::string>({"cycles", "speed"}), "wrong parameters");
+            QVERIFY2(protocol.getDefaults() == std::vector<double>({3, 50}), "wrong default values");
+
+            nlohmann::json lowered = nlohmann::json::parse(protocol.getLowered());
+            QVERIFY2(lowered["linkedBlocks"][0][0]["value"] == nlohmann::json({{"block_type", "variables_get"}, {"variable", "parameter_cycles"}}) &&
+                     lowered["linkedBlocks"][1][1]["speed"] == nlohmann::json({{"block_type", "variables_get"}, {"variable", "parameter_speed"}}),
+                     "parameters not lowered to graph variables");
+
+            ParameterSweep sweep(protocol, 1*units::s, 3);
+            std::vector<std::vector<double>> variants = ParameterSweep::grid({{1, 2, 3}, {50, 80}});
+            std::vector<ParameterSweep::VariantResult> results = sweep.run(variants,
+                [](std::shared_ptr<ProtocolGraph> graph, const std::vector<double> & values) {
+                    StringActuatorsInterface interface(std::vector<double>{});
+                    ProtocolExecutor executor(graph, &interface);
+                    executor.execute();
+                    return interface.getStream().str();
+                }, dir);
+            QVERIFY2(results.size() == 6, "wrong number of variants");
+            QVERIFY2(sweep.getTranslations() == 6, "without a variable binder every variant is translated");
+
+            for(const ParameterSweep::VariantResult & result: results) {
+                qDebug() << "cycles:" << result.values[0] << ", speed:" << result.values[1] << "," << result.durationMs << "ms";
+                QVERIFY2(result.error.empty(), result.error.c_str());
+
+                nlohmann::json literal = ProtocolJson::read(dir + "/thermocycling.json");
+                literal["linkedBlocks"][0][0]["value"]["value"] = std::to_string((int) result.values[0]);
+                literal["linkedBlocks"][1][1]["speed"]["value"] = std::to_string((int) result.values[1]);
+                ProtocolJson::write(literal, dir + "/literal.json");
+
+                BioBlocksTranslator translator(1*units::s, dir + "/literal.json");
+                StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
+                executeProtocol(translator.translateFile(), interface);
+
+                QVERIFY2(result.output.compare(interface->getStream().str()) == 0, "variant and literal protocol executions are not the same");
+            }
+        } catch (std::exception & e) {
+            QFAIL(e.what());
+        }
+    } else {
+        QFAIL("imposible to create temporary dir");
+    }
+}
 
-            BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
+/*
+ * thermocycling.json swept with a stub binder, on one thread so every variant runs on the same worker: each
+ * variant executes its own graph, none is executed twice, and all of them send the same commands as the
+ * literal translation, nothing of an executed variant carries over to the next one.
+ */
+void SequentialProtocol::parameterBinderTest() {
+    QTemporaryDir tempDir;
+    if (tempDir.isValid()) {
+        try {
+            std::string dir = tempDir.path().toStdString();
+            QFile::copy(":/protocol/protocolos/thermocycling.json", tempDir.filePath("thermocycling.json"));
 
-            qDebug() << protocol->toString().c_str();
+            BioBlocksTranslator translator(1*units::s, dir + "/thermocycling.json");
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
+            executeProtocol(translator.translateFile(), interface);
+            std::string literal = interface->getStream().str();
+
+            ParameterizedProtocol protocol(dir + "/thermocycling.json");
+            ParameterSweep sweep(protocol, 1*units::s, 1);
+
+            unsigned int binds = 0;
+            sweep.setVariableBinder([&binds](std::shared_ptr<ProtocolGraph> graph, const std::string & name, double value) {
+                binds++;
+            });
+
+            std::vector<std::shared_ptr<ProtocolGraph>> graphs;
+            std::vector<ParameterSweep::VariantResult> results = sweep.run(std::vector<std::vector<double>>(3),
+                [&graphs](std::shared_ptr<ProtocolGraph> graph, const std::vector<double> & values) {
+                    graphs.push_back(graph);
+                    StringActuatorsInterface interface(std::vector<double>{});
+                    ProtocolExecutor executor(graph, &interface);
+                    executor.execute();
+                    return interface.getStream().str();
+                }, dir);
+
+            QVERIFY2(results.size() == 3, "wrong number of variants");
+            QVERIFY2(binds == 0, "variables bound for a protocol without parameters");
+            QVERIFY2(sweep.getTranslations() == 3 && graphs[0] != graphs[1] && graphs[1] != graphs[2] && graphs[0] != graphs[2],
+                     "a graph executed by a variant was executed again");
+            for(const ParameterSweep::VariantResult & result: results) {
+                QVERIFY2(result.error.empty(), result.error.c_str());
+                QVERIFY2(result.output.compare(literal) == 0, "bound variant and literal protocol executions are not the same");
+            }
+        } catch (std::exception & e) {
+            QFAIL(e.what());
+        }
+    } else {
+        QFAIL("imposible to create temporary dir");
+    }
+}
+
+/*
+ * multiRate.json: a 200 ms measurement loop (tracks 0 and 1, they share the od variable) next to a 700 minutes
+ * stir and heat (track 2). Each group is advanced only at its own boundaries; the loop sends the same
+ * commands as when executed alone.
+ */
+void SequentialProtocol::multiRateExecutionTest() {
+    QTemporaryDir tempDir;
+    if (tempDir.isValid()) {
+        try {
+            std::string dir = tempDir.path().toStdString();
+            QFile::copy(":/protocol/protocolos/multiRate.json", tempDir.filePath("multiRate.json"));
 
             StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{200,400,500,580,620});
-            executeProtocol(protocol, interface);
+            MultiRateExecutor executor(dir + "/multiRate.json", dir, interface);
+            executor.execute();
 
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+            const std::vector<MultiRateExecutor::TrackGroup> & groups = executor.getGroups();
+            qDebug() << "backend steps:" << executor.getBackendSteps() << ", single rate slices:" << executor.getSingleRateSlices();
+            for(const MultiRateExecutor::TrackGroup & group: groups) {
+                qDebug() << "tracks from" << group.tracks.front() << ": slice" << TickTimebase::toMs(group.timeSlice) << "ms," << group.slices << "slices";
+            }
 
-            std::string expected = "setTimeStep(200ms);loadContainer(A,10ml);loadContainer(B,0ml);applyTemperature(A,26Cº);shake(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);measureOD(A,5Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();applyTemperature(A,26Cº);shake(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);measureOD(A,5Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();applyTemperature(A,26Cº);shake(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);measureOD(A,5Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();applyTemperature(A,26Cº);shake(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);measureOD(A,5Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();applyTemperature(A,26Cº);shake(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopShake(A);measureOD(A,5Hz,650nm);timeStep();timeStep();timeStep();timeStep();timeStep();getMeasureOD(A);timeStep();transfer(A,B,1ml);timeStep();timeStep();timeStep();timeStep();timeStep();stopTransfer(A,B);applyTemperature(B,26Cº);centrifugate(B,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(B);stopCentrifugate(B);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            QVERIFY2(groups.size() == 2 && groups[0].tracks == std::vector<int>({0, 1}) && groups[1].tracks == std::vector<int>({2}),
+                     "tracks sharing the od variable not grouped");
+            QVERIFY2(groups[0].timeSlice == TickTimebase::parse("200", "ms") && groups[1].timeSlice == TickTimebase::parse("700", "minute"),
+                     "wrong slices");
+            QVERIFY2(executor.getBackendSteps() * 1000 < executor.getSingleRateSlices(), "multi rate execution did not drop the slices");
+
+            BioBlocksTranslator translator(200*units::ms, dir + "/track_0.json");
+            StringActuatorsInterface* loopInterface = new StringActuatorsInterface(std::vector<double>{200,400,500,580,620});
+            executeProtocol(translator.translateFile(), loopInterface);
+
+            auto loopCommands = [](const std::string & trace) {
+                std::vector<std::string> commands;
+                std::istringstream stream(trace);
+                std::string command;
+                while(std::getline(stream, command, ';')) {
+                    if (command.find("chemoA") == std::string::npos && command.find("imeStep(") == std::string::npos) {
+                        commands.push_back(command);
+                    }
+                }
+                return commands;
+            };
+            QVERIFY2(loopCommands(interface->getStream().str()) == loopCommands(loopInterface->getStream().str()),
+                     "the loop does not send the same commands as when executed alone");
+
+            StringActuatorsInterface* slowInterface = new StringActuatorsInterface(std::vector<double>{200,400,500,580,620});
+            MultiRateExecutor slowExecutor(dir + "/multiRate.json", dir, slowInterface);
+            slowExecutor.setTrackSlice(2, 10*units::minute);
+            slowExecutor.execute();
+            QVERIFY2(slowExecutor.getGroups()[1].timeSlice == TickTimebase::parse("10", "minute") &&
+                     slowExecutor.getGroups()[1].slices > groups[1].slices,
+                     "track slice not used");
+        } catch (std::exception & e) {
+            QFAIL(e.what());
+        }
+    } else {
+        QFAIL("imposible to create temporary dir");
+    }
+}
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+/*
+ * turbidostat2.json replaying a sensor log of two containers: the OD of cell in effect at every read
+ * gives the same execution as the series of values {0.5, 0.8, 1.2, 1.05}
+ */
+void SequentialProtocol::sensorLogReplayTest() {
+    QTemporaryDir tempDir;
+    if (tempDir.isValid()) {
+        try {
+            std::string dir = tempDir.path().toStdString();
+            QFile::copy(":/protocol/protocolos/turbidostat2.json", tempDir.filePath("turbidostat2.json"));
+
+            std::ofstream text(dir + "/sensors.csv");
+            text << "# timeMs,container,sensor,value" << std::endl;
+            text << "0,cell,OD,0.5" << std::endl;
+            text << "0,Waste,OD,9" << std::endl;
+            text << "5000,cell,Temperature,37" << std::endl;
+            text << "20000,cell,OD,1.2" << std::endl;
+            text << "10000,cell,OD,0.8" << std::endl;
+            text << "30000,cell,OD,1.05" << std::endl;
+            text << "50000,cell,OD,3" << std::endl;
+            text.close();
+            SensorLog::convert(dir + "/sensors.csv", dir + "/sensors.log");
+
+            SensorLog log(dir + "/sensors.log");
+            double value = 0;
+            QVERIFY2(log.getChannels() == 3 && log.getReadings() == 7, "wrong channels");
+            QVERIFY2(log.valueAt("cell", SensorLog::OD, TickTimebase::parse("9999.999", "ms"), value) && value == 0.5, "wrong value before a reading");
+            QVERIFY2(log.valueAt("cell", SensorLog::OD, TickTimebase::parse("10000", "ms"), value) && value == 0.8, "wrong value at a reading");
+            QVERIFY2(!log.valueAt("cell", SensorLog::TEMPERATURE, 0, value), "value before the first reading");
+            QVERIFY2(!log.valueAt("media", SensorLog::OD, 0, value), "value of a container not logged");
+
+            BioBlocksTranslator translator(1000*units::ms, dir + "/turbidostat2.json");
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{0.5, 0.8, 1.2, 1.05});
+            executeProtocol(translator.translateFile(), interface);
+
+            BioBlocksTranslator replayTranslator(1000*units::ms, dir + "/turbidostat2.json");
+            StringActuatorsInterface* replayed = new StringActuatorsInterface(std::vector<double>{0});
+            ReplayActuatorsInterface* replayInterface = new ReplayActuatorsInterface(replayed, &log);
+            executeProtocol(replayTranslator.translateFile(), replayInterface);
+
+            qDebug() << "replayed reads:" << replayInterface->getReplayedReads();
+            QVERIFY2(replayInterface->getReplayedReads() == 4, "reads not replayed");
+            QVERIFY2(replayed->getStream().str() == interface->getStream().str(), "replayed execution different from the series of values");
         } catch (std::exception & e) {
-            delete tempFile;
             QFAIL(e.what());
         }
     } else {
-        delete tempFile;
-        QFAIL("imposible to create temporary file");
+        QFAIL("imposible to create temporary dir");
     }
-    delete tempFile;
 }
 
 /*
- * cycles = 3;
- * thermocycling[0s:](A,cycles, steps[{60ºC,2s},{30ºC,5s}]);
- * centrifugation[x:5s](A,50Hz,26ºC);
+ * unknowDurationLinked.json through the I/O thread queue with the transfers speculated: same execution
+ * without waiting for them, with the exact model of the backend or learning it from a wrong first estimate,
+ * where the slices missing are added before the first stopTransfer
  */
-void SequentialProtocol::thermocycling() {
+void SequentialProtocol::speculativePipeliningTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/thermocycling.json", tempFile);
-
-            BioBlocksTranslator translator(200*units::ms, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
-
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{200,400,500,580,620});
-            executeProtocol(protocol, interface);
-
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
-
-            std::string expected = "setTimeStep(200ms);loadContainer(A,1ml);applyTemperature(A,60Cº);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);applyTemperature(A,30Cº);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);timeStep();applyTemperature(A,60Cº);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);applyTemperature(A,30Cº);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);timeStep();applyTemperature(A,60Cº);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);applyTemperature(A,30Cº);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);timeStep();applyTemperature(A,26Cº);centrifugate(A,50Hz);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopApplyTemperature(A);stopCentrifugate(A);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            copyResourceFile(":/protocol/protocolos/unknowDurationLinked.json", tempFile);
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            BioBlocksTranslator translator(1000*units::ms, tempFile->fileName().toStdString());
+
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>());
+            AsyncActuatorsInterface asyncInterface(interface);
+            executeProtocol(translator.translateFile(), &asyncInterface);
+            asyncInterface.flush();
+
+            StringActuatorsInterface* modelInterface = new StringActuatorsInterface(std::vector<double>());
+            AsyncActuatorsInterface modelAsyncInterface(modelInterface);
+            modelAsyncInterface.enableSpeculation([](const std::string & operation, units::Volume volume) {
+                return volume.to(units::ml) * units::s;
+            });
+            executeProtocol(translator.translateFile(), &modelAsyncInterface);
+            modelAsyncInterface.flush();
+
+            StringActuatorsInterface* historyInterface = new StringActuatorsInterface(std::vector<double>());
+            AsyncActuatorsInterface historyAsyncInterface(historyInterface);
+            historyAsyncInterface.enableSpeculation(AsyncActuatorsInterface::DurationModel(), 0.5*units::s);
+            executeProtocol(translator.translateFile(), &historyAsyncInterface);
+            historyAsyncInterface.flush();
+
+            qDebug() << "blocking calls:" << asyncInterface.getBlockingCalls()
+                     << ", speculated:" << modelAsyncInterface.getBlockingCalls() << "/" << historyAsyncInterface.getBlockingCalls();
+            qDebug() << "mispredictions:" << historyAsyncInterface.getMispredictions() << ", stall slices:" << historyAsyncInterface.getStallSlices();
+
+            QVERIFY2(modelAsyncInterface.getSpeculatedCalls() == 2 &&
+                     modelAsyncInterface.getBlockingCalls() + 2 == asyncInterface.getBlockingCalls(),
+                     "transfers waited for the backend");
+            QVERIFY2(modelAsyncInterface.getMispredictions() == 0 && modelAsyncInterface.getStallSlices() == 0, "exact model mispredicted");
+            QVERIFY2(modelInterface->getStream().str() == interface->getStream().str(), "speculated execution is not the same");
+
+            QVERIFY2(historyAsyncInterface.getMispredictions() == 1 && historyAsyncInterface.getStallSlices() > 0,
+                     "first estimate not corrected");
+            QVERIFY2(historyInterface->getStream().str() == interface->getStream().str(), "corrected execution is not the same");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -871,37 +1395,54 @@ void SequentialProtocol::thermocycling() {
 }
 
 /*
- * rate =50;
- * OD = 0;
- * while(OD < 1 || OD > 1.1) {
- *  OD = measureOD[x:2s]();
- *  rate = rate - (rate * (1-OD));
- *  SetContinuousFlow([media,cell,waste], rate ml/hr)[x:10s];
- * }
+ * unknowDurationParalel.json with both transfers speculated, one track next to the other: underestimated,
+ * the executor is held until the real durations elapse and its clock counts the slices held, so both
+ * stops are sent when the blocking execution sends them; overestimated, the backend is stopped at the real
+ * durations and the stops of the graph are not sent again.
  */
-void SequentialProtocol::turbidostat2() {
+void SequentialProtocol::speculativeParallelTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
-            copyResourceFile(":/protocol/protocolos/turbidostat2.json", tempFile);
-
-            BioBlocksTranslator translator(1*units::s, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
+            copyResourceFile(":/protocol/protocolos/unknowDurationParalel.json", tempFile);
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{0.5,0.8,1.2,1.05});
-            executeProtocol(protocol, interface);
+            BioBlocksTranslator translator(1000*units::ms, tempFile->fileName().toStdString());
+
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>());
+            AsyncActuatorsInterface asyncInterface(interface);
+            ProtocolExecutor executor(translator.translateFile(), &asyncInterface);
+            executor.execute();
+            asyncInterface.flush();
+
+            StringActuatorsInterface* shortInterface = new StringActuatorsInterface(std::vector<double>());
+            AsyncActuatorsInterface shortAsyncInterface(shortInterface);
+            shortAsyncInterface.enableSpeculation(AsyncActuatorsInterface::DurationModel(), 0.5*units::s);
+            ProtocolExecutor shortExecutor(translator.translateFile(), &shortAsyncInterface);
+            shortExecutor.execute();
+            shortAsyncInterface.flush();
+
+            StringActuatorsInterface* longInterface = new StringActuatorsInterface(std::vector<double>());
+            AsyncActuatorsInterface longAsyncInterface(longInterface);
+            longAsyncInterface.enableSpeculation(AsyncActuatorsInterface::DurationModel(), 2*units::s);
+            ProtocolExecutor longExecutor(translator.translateFile(), &longAsyncInterface);
+            longExecutor.execute();
+            longAsyncInterface.flush();
+
+            qDebug() << "underestimated, stall slices:" << shortAsyncInterface.getStallSlices()
+                     << ", elapsed:" << TickTimebase::toMs(shortExecutor.getElapsedTicks()) << "ms of"
+                     << TickTimebase::toMs(executor.getElapsedTicks()) << "ms";
+            qDebug() << longInterface->getStream().str().c_str();
+
+            QVERIFY2(shortAsyncInterface.getMispredictions() == 2 && shortAsyncInterface.getStallSlices() > 0, "estimates not corrected");
+            QVERIFY2(shortInterface->getStream().str() == interface->getStream().str(), "held execution is not the same");
+            QVERIFY2(shortExecutor.getElapsedTicks() == executor.getElapsedTicks(), "executor clock does not count the slices held");
 
             std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
-
-            std::string expected = "setTimeStep(1000ms);loadContainer(Waste,0ml);loadContainer(cell,50ml);loadContainer(media,100ml);measureOD(cell,20Hz,600nm);timeStep();timeStep();getMeasureOD(cell);setContinuosFlow(media,cell,150ml/h);setContinuosFlow(cell,Waste,150ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(media,cell);stopContinuosFlow(cell,Waste);timeStep();measureOD(cell,20Hz,600nm);timeStep();timeStep();getMeasureOD(cell);setContinuosFlow(media,cell,120ml/h);setContinuosFlow(cell,Waste,120ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(media,cell);stopContinuosFlow(cell,Waste);timeStep();measureOD(cell,20Hz,600nm);timeStep();timeStep();getMeasureOD(cell);setContinuosFlow(media,cell,144ml/h);setContinuosFlow(cell,Waste,144ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(media,cell);stopContinuosFlow(cell,Waste);timeStep();measureOD(cell,20Hz,600nm);timeStep();timeStep();getMeasureOD(cell);setContinuosFlow(media,cell,151.2ml/h);setContinuosFlow(cell,Waste,151.2ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(media,cell);stopContinuosFlow(cell,Waste);timeStep();timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
-
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            std::string stops = execution.substr(0, execution.find("stopTransfer(C,D);") + std::string("stopTransfer(C,D);").size());
+            std::string overestimated = longInterface->getStream().str();
+            QVERIFY2(longAsyncInterface.getMispredictions() == 2 && longAsyncInterface.getStallSlices() == 0, "overestimates held the executor");
+            QVERIFY2(overestimated.compare(0, stops.size(), stops) == 0, "overestimated transfers not stopped at their real durations");
+            QVERIFY2(overestimated.find("stopTransfer", stops.size()) == std::string::npos, "stops of the graph sent again");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -914,66 +1455,130 @@ void SequentialProtocol::turbidostat2() {
 }
 
 /*
- * mix(A,20Hz)[-:30s]
- * applyTemperature(A,20ºC)[-:30s]
+ * nestedIf.json with od = 590 and flur = 500 split among three controller processes, one per container:
+ * only the reads of A and the duration of the transfer from B are relayed, and the traces of the
+ * partitions merged in the order of their journals are the single process execution.
  */
-void SequentialProtocol::mixHeat() {
-    QTemporaryFile* tempFile = new QTemporaryFile();
-    if (tempFile->open()) {
+void SequentialProtocol::partitionedExecutionTest() {
+#ifdef Q_OS_WIN
+    QSKIP("partitioned execution needs a POSIX system");
+#else
+    QTemporaryDir tempDir;
+    if (tempDir.isValid()) {
         try {
-            copyResourceFile(":/protocol/protocolos/mix_test_v2.json", tempFile);
+            std::string dir = tempDir.path().toStdString();
+            QFile::copy(":/protocol/protocolos/nestedIf.json", tempDir.filePath("nestedIf.json"));
+            std::string path = dir + "/nestedIf.json";
 
-            BioBlocksTranslator translator(10*units::s, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
-
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
-            executeProtocol(protocol, interface);
+            BioBlocksTranslator translator(200*units::ms, path);
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{590,500});
+            executeProtocol(translator.translateFile(), interface);
+
+            PartitionedExecutor executor(
+                [path]() {
+                    BioBlocksTranslator partitionTranslator(200*units::ms, path);
+                    return partitionTranslator.translateFile();
+                },
+                [](int partition) {
+                    return std::make_shared<StringActuatorsInterface>(std::vector<double>{590,500});
+                },
+                std::map<std::string, int>{{"A", 0}, {"B", 1}, {"C", 2}},
+                3,
+                [dir](int partition, ActuatorsExecutionInterface* actuatorInterface) {
+                    std::ofstream trace(dir + "/partition_" + std::to_string(partition) + ".trace");
+                    trace << static_cast<StringActuatorsInterface*>(actuatorInterface)->getStream().str();
+                });
+            executor.execute();
+
+            std::map<std::uint64_t, std::string> merged;
+            for(int partition = 0; partition < 3; partition++) {
+                std::ifstream trace(dir + "/partition_" + std::to_string(partition) + ".trace");
+                const std::vector<std::uint64_t> & journal = executor.getJournal(partition);
+
+                size_t next = 0;
+                std::string command;
+                while(std::getline(trace, command, ';')) {
+                    QVERIFY2(next < journal.size(), "more commands than calls in the journal");
+                    merged[journal[next++]] = command + ";";
+                }
+                QVERIFY2(next == journal.size(), "less commands than calls in the journal");
+            }
 
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
+            std::string execution;
+            for(const auto & command: merged) {
+                execution += command.second;
+            }
+            qDebug() << "relayed values:" << executor.getRelayedValues();
             qDebug() << execution.c_str();
 
-            std::string expected = "setTimeStep(10000ms);loadContainer(A,0ml);stir(A,20Hz);applyTemperature(A,20Cº);timeStep();timeStep();timeStep();stopStir(A);stopApplyTemperature(A);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
-
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            QVERIFY2(executor.getRelayedValues() == 4, "wrong values relayed");
+            QVERIFY2(execution == interface->getStream().str(), "partitioned execution is not the single process one");
         } catch (std::exception & e) {
-            delete tempFile;
             QFAIL(e.what());
         }
     } else {
-        delete tempFile;
-        QFAIL("imposible to create temporary file");
+        QFAIL("imposible to create temporary dir");
     }
-    delete tempFile;
+#endif
 }
 
-void SequentialProtocol::evoproSwitching() {
+/*
+ * evoprog_switching_protocol.json through the priority lanes: same execution, the stops of every switch sent
+ * through the safety lane; and a busy slice queued by hand, where the stops go out before the set-points,
+ * measurements and loads queued before them, except the one of a container already used in the slice.
+ */
+void SequentialProtocol::priorityLanesTest() {
     QTemporaryFile* tempFile = new QTemporaryFile();
     if (tempFile->open()) {
         try {
             copyResourceFile(":/protocol/protocolos/evoprog_switching_protocol.json", tempFile);
 
-            BioBlocksTranslator translator(4*units::minute, tempFile->fileName().toStdString());
-            std::shared_ptr<ProtocolGraph> protocol = translator.translateFile();
-
-            qDebug() << protocol->toString().c_str();
+            BioBlocksTranslator translator(240000*units::ms, tempFile->fileName().toStdString());
 
-            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>{});
-            executeProtocol(protocol, interface);
+            StringActuatorsInterface* interface = new StringActuatorsInterface(std::vector<double>());
+            executeProtocol(translator.translateFile(), interface);
 
-            std::string execution = interface->getStream().str();
-            qDebug() << "protocol execution";
-            qDebug() << execution.c_str();
+            StringActuatorsInterface* lanesInterface = new StringActuatorsInterface(std::vector<double>());
+            AsyncActuatorsInterface asyncInterface(lanesInterface);
+            asyncInterface.enablePriorityLanes();
+            executeProtocol(translator.translateFile(), &asyncInterface);
+            asyncInterface.flush();
 
-            std::string expected = "setTimeStep(240000ms);loadContainer(chemoA,0ml);loadContainer(chemoB,0ml);loadContainer(cellstat,0ml);loadContainer(mediaA,149ml);loadContainer(wasteC,0ml);loadContainer(mediaB,149ml);loadContainer(wasteB,0ml);loadContainer(wasteA,0ml);stir(chemoA,20Hz);applyTemperature(chemoA,37Cº);stir(chemoB,20Hz);applyTemperature(chemoB,37Cº);stir(cellstat,20Hz);applyTemperature(cellstat,37Cº);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,wasteB,21ml/h);timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();timeStep();stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,cellstat);stopContinuosFlow(cellstat,wasteC);stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,wasteB);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,wasteA,21ml/h);timeStep();timeStep();timeStep();stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,cellstat);stopContinuosFlow(cellstat,wasteC);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,wasteA);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,wasteB,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);timeStep();timeStep();stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,wasteB);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,cellstat);stopContinuosFlow(cellstat,wasteC);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,wasteA,21ml/h);timeStep();timeStep();timeStep();stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,cellstat);stopContinuosFlow(cellstat,wasteC);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,wasteA);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,wasteB,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);timeStep();timeStep();stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,wasteB);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,cellstat);stopContinuosFlow(cellstat,wasteC);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,wasteA,21ml/h);timeStep();timeStep();timeStep();stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,cellstat);stopContinuosFlow(cellstat,wasteC);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,wasteA);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,wasteB,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);timeStep();timeStep();stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,wasteB);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,cellstat);stopContinuosFlow(cellstat,wasteC);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,wasteA,21ml/h);timeStep();timeStep();timeStep();stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,cellstat);stopContinuosFlow(cellstat,wasteC);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,wasteA);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,wasteB,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);timeStep();timeStep();stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,wasteB);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,cellstat);stopContinuosFlow(cellstat,wasteC);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,wasteA,21ml/h);timeStep();timeStep();timeStep();stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,cellstat);stopContinuosFlow(cellstat,wasteC);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,wasteA);setContinuosFlow(mediaB,chemoB,21ml/h);setContinuosFlow(chemoB,wasteB,21ml/h);setContinuosFlow(mediaA,chemoA,21ml/h);setContinuosFlow(chemoA,cellstat,21ml/h);setContinuosFlow(cellstat,wasteC,21ml/h);timeStep();timeStep();stopStir(chemoA);stopApplyTemperature(chemoA);stopStir(chemoB);stopApplyTemperature(chemoB);stopStir(cellstat);stopApplyTemperature(cellstat);stopContinuosFlow(mediaB,chemoB);stopContinuosFlow(chemoB,wasteB);stopContinuosFlow(mediaA,chemoA);stopContinuosFlow(chemoA,cellstat);stopContinuosFlow(cellstat,wasteC);timeStep();timeStep();";
-            qDebug() << "protocol expected execution";
-            qDebug() << expected.c_str();
+            std::string execution = lanesInterface->getStream().str();
+            unsigned long long stops = 0;
+            for(size_t pos = execution.find("stop"); pos != std::string::npos; pos = execution.find("stop", pos + 1)) {
+                stops++;
+            }
 
-            QVERIFY2(execution.compare(expected) == 0, "Execution and expected execution are not the same, check debug data for seeing where");
+            AsyncActuatorsInterface::LaneStatistics safety = asyncInterface.getLaneStatistics(AsyncActuatorsInterface::SAFETY);
+            qDebug() << "stops:" << safety.commands << ", worst latency:" << safety.maxLatencyMs << "ms"
+                     << ", mean:" << safety.totalLatencyMs / std::max(1ull, safety.commands) << "ms";
+            qDebug() << "demoted calls:" << asyncInterface.getDemotedCalls();
+
+            QVERIFY2(execution == interface->getStream().str(), "execution through the lanes is not the same");
+            QVERIFY2(safety.commands == stops && stops > 0, "stops not sent through the safety lane");
+
+            StringActuatorsInterface* busyInterface = new StringActuatorsInterface(std::vector<double>{5});
+            AsyncActuatorsInterface busyAsyncInterface(busyInterface);
+            busyAsyncInterface.enablePriorityLanes();
+            busyAsyncInterface.setTimeStep(1*units::s);
+            busyAsyncInterface.setContinuosFlow("C", "E", 10*units::ml/units::hr);
+            busyAsyncInterface.timeStep();
+            busyAsyncInterface.loadContainer("F", 1*units::ml);
+            busyAsyncInterface.setContinuosFlow("A", "B", 10*units::ml/units::hr);
+            busyAsyncInterface.startMeasureOD("B", 50*units::Hz, 650*units::nm);
+            busyAsyncInterface.stopContinuosFlow("C", "E");
+            busyAsyncInterface.stopStir("A");
+            busyAsyncInterface.timeStep();
+            busyAsyncInterface.getMeasureOD("B");
+            busyAsyncInterface.flush();
+
+            std::string busyExecution = busyInterface->getStream().str();
+            std::string busyExpected = "setTimeStep(1000ms);setContinuosFlow(C,E,10ml/h);timeStep();stopContinuosFlow(C,E);setContinuosFlow(A,B,10ml/h);stopStir(A);measureOD(B,50Hz,650nm);loadContainer(F,1ml);timeStep();getMeasureOD(B);";
+            qDebug() << busyExecution.c_str();
+
+            QVERIFY2(busyExecution == busyExpected, "busy slice not sent by priority");
+            QVERIFY2(busyAsyncInterface.getDemotedCalls() == 1, "stop of a container used in the slice not kept in order");
         } catch (std::exception & e) {
             delete tempFile;
             QFAIL(e.what());
@@ -986,27 +1591,32 @@ void SequentialProtocol::evoproSwitching() {
 }
 
 void SequentialProtocol::executeProtocol(std::shared_ptr<ProtocolGraph> protocol,ActuatorsExecutionInterface* actuatorInterfaz) {
-    std::vector<int> nodes2process = {protocol->getStart()->getContainerId()};
-    while(!nodes2process.empty()) {
-        int nextId = nodes2process.back();
-        nodes2process.pop_back();
-
-        if (protocol->isCpuOperation(nextId)) {
-            protocol->getCpuOperation(nextId)->execute();
-        } else if (protocol->isActuatorOperation(nextId)) {
-            protocol->getActuatorOperation(nextId)->execute(actuatorInterfaz);
-        }
+    ProtocolExecutor executor(protocol, actuatorInterfaz);
+    executor.execute();
+}
 
-        ProtocolGraph::ProtocolEdgeVectorPtr leaving = protocol->getProjectingEdges(nextId);
-        for(const ProtocolGraph::ProtocolEdgePtr & edge: *leaving.get()) {
-            if (edge->conditionMet()) {
-                int nextop = edge->getIdTarget();
-                if (find(nodes2process.begin(),nodes2process.end(), nextop) == nodes2process.end()) {
-                    nodes2process.push_back(nextop);
-                }
-            }
-        }
+bool SequentialProtocol::executeAgainstGolden(
+        std::shared_ptr<ProtocolGraph> protocol,
+        const std::vector<double> & measureValues,
+        const QString & goldenResource,
+        std::string & report) throw(std::invalid_argument)
+{
+    QFile golden(goldenResource);
+    if (!golden.open(QIODevice::ReadOnly)) {
+        throw(std::invalid_argument("imposible to open " + goldenResource.toStdString()));
     }
+    std::istringstream goldenStream(golden.readAll().toStdString());
+
+    TraceComparator comparator(goldenStream);
+    std::ostream output(&comparator);
+    StringActuatorsInterface interface(measureValues, &output);
+
+    ProtocolExecutor executor(protocol, &interface);
+    while(!comparator.hasDiverged() && executor.executeNextNode());
+
+    bool equal = comparator.finish();
+    report = comparator.report();
+    return equal;
 }
 
 void SequentialProtocol::copyResourceFile(const QString & resourcePath, QTemporaryFile* tempFile) throw(std::invalid_argument) {
@@ -0,0 +1,95 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+
+#include <iostream>
+
+#include "tracetimeline.h"
+
+/*
+ * Time index over an execution trace.
+ *
+ * tracetimeline trace.txt --log ms                  every command with its timestamp (as runSimulation.py)
+ * tracetimeline trace.txt --active 25000            activities in course at 25000ms
+ * tracetimeline trace.txt --container A --from 0 --to 30000
+ * tracetimeline trace.txt --occupancy
+ *
+ * With --index the index is loaded from that file when it exists, otherwise it is built from the trace
+ * and saved there, so the trace is only read once.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("tracetimeline");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("time index over an execution trace");
+    parser.addHelpOption();
+    parser.addPositionalArgument("trace", "execution trace, commands separated by ';' or new lines");
+
+    QCommandLineOption sliceOption("slice", "time slice in ms if the trace has no setTimeStep", "ms", "0");
+    QCommandLineOption indexOption("index", "index file, loaded if it exists, built and saved otherwise", "file");
+    QCommandLineOption logOption("log", "print every command with its timestamp", "units");
+    QCommandLineOption activeOption("active", "print the activities in course at that time", "ms");
+    QCommandLineOption containerOption("container", "print the commands of a container", "name");
+    QCommandLineOption fromOption("from", "start of the --container interval", "ms", "0");
+    QCommandLineOption toOption("to", "end of the --container interval", "ms", "inf");
+    QCommandLineOption occupancyOption("occupancy", "print the occupancy of every container");
+    parser.addOptions({sliceOption, indexOption, logOption, activeOption, containerOption, fromOption, toOption, occupancyOption});
+
+    parser.process(a);
+
+    try {
+        TraceTimeline timeline;
+        QString indexPath = parser.value(indexOption);
+        if (!indexPath.isEmpty() && QFile::exists(indexPath)) {
+            timeline = TraceTimeline::loadIndex(indexPath.toStdString());
+        } else {
+            if (parser.positionalArguments().isEmpty()) {
+                parser.showHelp(1);
+            }
+            timeline.buildFile(parser.positionalArguments().first().toStdString(), parser.value(sliceOption).toDouble());
+            if (!indexPath.isEmpty()) {
+                timeline.saveIndex(indexPath.toStdString());
+            }
+        }
+
+        if (parser.isSet(logOption)) {
+            timeline.writeLog(std::cout, parser.value(logOption).toStdString());
+        }
+
+        if (parser.isSet(activeOption)) {
+            for(int interval: timeline.activeAt(parser.value(activeOption).toDouble())) {
+                const TraceTimeline::ActiveInterval & active = timeline.getInterval(interval);
+                std::cout << active.startSlice * timeline.getSliceMs() << "ms-";
+                if (active.stopped) {
+                    std::cout << active.endSlice * timeline.getSliceMs() << "ms";
+                }
+                std::cout << ":" << timeline.getCommand(active.command).text << std::endl;
+            }
+        }
+
+        if (parser.isSet(containerOption)) {
+            double to = parser.value(toOption) == "inf" ? timeline.getTotalSlices() * timeline.getSliceMs() : parser.value(toOption).toDouble();
+            for(int command: timeline.commandsFor(parser.value(containerOption).toStdString(), parser.value(fromOption).toDouble(), to)) {
+                const TraceTimeline::TraceCommand & found = timeline.getCommand(command);
+                std::cout << found.slice * timeline.getSliceMs() << "ms:" << found.text << std::endl;
+            }
+        }
+
+        if (parser.isSet(occupancyOption)) {
+            for(const std::string & container: timeline.getContainers()) {
+                TraceTimeline::ContainerOccupancy occupancy = timeline.occupancy(container);
+                std::cout << container << ": " << occupancy.commands << " commands, busy "
+                          << occupancy.busySlices * timeline.getSliceMs() << "ms of "
+                          << timeline.getTotalSlices() * timeline.getSliceMs() << "ms, from "
+                          << occupancy.firstSlice * timeline.getSliceMs() << "ms to "
+                          << occupancy.lastSlice * timeline.getSliceMs() << "ms" << std::endl;
+            }
+        }
+    } catch (std::exception & e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,22 @@
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+TARGET = tracetimeline
+
+SEQUENTIALPROTOCOL = $$PWD/../../tests/auto/sequentialprotocol
+
+INCLUDEPATH += $$SEQUENTIALPROTOCOL
+
+SOURCES += main.cpp \
+    $$SEQUENTIALPROTOCOL/tracetimeline.cpp \
+    $$SEQUENTIALPROTOCOL/protocoljson.cpp
+
+HEADERS += \
+    $$SEQUENTIALPROTOCOL/tracetimeline.h \
+    $$SEQUENTIALPROTOCOL/protocoljson.h
+
+INCLUDEPATH += X:\libraries\json-2.1.1\src
+INCLUDEPATH += X:\libraries\cereal-1.2.2\include